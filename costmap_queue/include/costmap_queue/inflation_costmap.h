@@ -0,0 +1,144 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef COSTMAP_QUEUE_INFLATION_COSTMAP_H
+#define COSTMAP_QUEUE_INFLATION_COSTMAP_H
+
+#include <costmap_queue/limited_costmap_queue.h>
+#include <nav_core2/basic_costmap.h>
+#include <nav_core2/bounds.h>
+#include <nav_grid/vector_nav_grid.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace costmap_queue
+{
+/**
+ * @class InflationCostmap
+ * @brief A nav_core2::Costmap that inflates its obstacles, only recomputing the area around what changed
+ *
+ * The uninflated costs (i.e. LETHAL_OBSTACLE, FREE_SPACE or NO_INFORMATION) are set with setSourceCost.
+ * update() then recomputes the inflated costs of the cells within inflation_radius of any changed source cell,
+ * by propagating a LimitedCostmapQueue from the lethal cells that can reach them. The recomputed area is
+ * reported through getChangeBounds.
+ *
+ * The costs use the same function as the costmap_2d InflationLayer: LETHAL_OBSTACLE at distance zero,
+ * INSCRIBED_INFLATED_OBSTACLE up to the inscribed_radius, then decaying exponentially with the
+ * cost_scaling_factor, down to zero beyond the inflation_radius. Unknown cells are only overwritten
+ * with the inscribed cost.
+ */
+class InflationCostmap : public nav_core2::BasicCostmap
+{
+public:
+  InflationCostmap(double inflation_radius = 0.55, double inscribed_radius = 0.0, double cost_scaling_factor = 10.0);
+
+  /**
+   * @brief Load inflation_radius, inscribed_radius and cost_scaling_factor from the parent/name namespace
+   */
+  void initialize(const ros::NodeHandle& parent, const std::string& name, TFListenerPtr tf) override;
+
+  /**
+   * @brief Change the parameters of the cost function, which will recompute the whole costmap on the next update
+   */
+  void setInflationParameters(double inflation_radius, double inscribed_radius, double cost_scaling_factor);
+
+  /**
+   * @brief Set the uninflated cost of a cell. The inflated costs are not changed until the next update.
+   */
+  void setSourceCost(unsigned int x, unsigned int y, unsigned char cost);
+  unsigned char getSourceCost(unsigned int x, unsigned int y) const { return sources_(x, y); }
+
+  /**
+   * @brief Recompute the inflated costs around the source cells that changed since the last update
+   */
+  void update() override;
+
+  /**
+   * @brief Recompute the inflated costs of the whole costmap, regardless of what changed
+   */
+  void reinflate();
+
+  // NavGrid Interface
+  void reset() override;
+  void setInfo(const nav_grid::NavGridInfo& new_info) override;
+
+protected:
+  /**
+   * @class InflationQueue
+   * @brief LimitedCostmapQueue that only expands within a region of the costmap
+   */
+  class InflationQueue : public LimitedCostmapQueue
+  {
+  public:
+    InflationQueue(nav_core2::Costmap& costmap, int cell_inflation_radius)
+      : LimitedCostmapQueue(costmap, cell_inflation_radius) {}
+
+    /**
+     * @brief Empty the queue and only allow cells within the given region, clearing just their seen flags
+     */
+    void resetRegion(const nav_core2::UIntBounds& region);
+
+    bool validCellToQueue(const CellData& cell) override;
+  protected:
+    nav_core2::UIntBounds region_;
+  };
+
+  /**
+   * @brief Recompute the costs of the cells in the given bounds, which should include everything within
+   *        inflation_radius of the changed sources
+   */
+  void inflate(const nav_core2::UIntBounds& bounds);
+
+  /**
+   * @brief Grow the bounds by the cell_inflation_radius_, clipped to the costmap
+   */
+  nav_core2::UIntBounds expand(const nav_core2::UIntBounds& bounds) const;
+
+  /**
+   * @brief Recompute cell_inflation_radius_, the queue and the cost for each cell offset
+   */
+  void computeCaches();
+
+  nav_grid::VectorNavGrid<unsigned char> sources_;
+  nav_core2::UIntBounds dirty_;  ///< Source cells that changed since the last update
+
+  double inflation_radius_, inscribed_radius_, cost_scaling_factor_;
+  unsigned int cell_inflation_radius_;
+  std::shared_ptr<InflationQueue> queue_;
+  std::vector<std::vector<unsigned char> > cached_costs_;  ///< Cost for each (dx, dy) offset from an obstacle
+};
+}  // namespace costmap_queue
+
+#endif  // COSTMAP_QUEUE_INFLATION_COSTMAP_H
@@ -0,0 +1,240 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <costmap_queue/inflation_costmap.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace costmap_queue
+{
+inline bool inBounds(const nav_core2::UIntBounds& bounds, unsigned int x, unsigned int y)
+{
+  return x >= bounds.getMinX() && x <= bounds.getMaxX() && y >= bounds.getMinY() && y <= bounds.getMaxY();
+}
+
+void InflationCostmap::InflationQueue::resetRegion(const nav_core2::UIntBounds& region)
+{
+  region_ = region;
+  if (!region.isEmpty())
+  {
+    for (unsigned int y = region.getMinY(); y <= region.getMaxY(); y++)
+    {
+      for (unsigned int x = region.getMinX(); x <= region.getMaxX(); x++)
+      {
+        seen_.setValue(x, y, 0);
+      }
+    }
+  }
+  MapBasedQueue::reset();
+}
+
+bool InflationCostmap::InflationQueue::validCellToQueue(const CellData& cell)
+{
+  return inBounds(region_, cell.x_, cell.y_) && LimitedCostmapQueue::validCellToQueue(cell);
+}
+
+InflationCostmap::InflationCostmap(double inflation_radius, double inscribed_radius, double cost_scaling_factor)
+  : sources_(FREE_SPACE), inflation_radius_(inflation_radius), inscribed_radius_(inscribed_radius),
+    cost_scaling_factor_(cost_scaling_factor), cell_inflation_radius_(0)
+{
+  computeCaches();
+}
+
+void InflationCostmap::initialize(const ros::NodeHandle& parent, const std::string& name, TFListenerPtr tf)
+{
+  ros::NodeHandle nh(parent, name);
+  double inflation_radius, inscribed_radius, cost_scaling_factor;
+  nh.param("inflation_radius", inflation_radius, inflation_radius_);
+  nh.param("inscribed_radius", inscribed_radius, inscribed_radius_);
+  nh.param("cost_scaling_factor", cost_scaling_factor, cost_scaling_factor_);
+  setInflationParameters(inflation_radius, inscribed_radius, cost_scaling_factor);
+}
+
+void InflationCostmap::setInflationParameters(double inflation_radius, double inscribed_radius,
+                                              double cost_scaling_factor)
+{
+  inflation_radius_ = inflation_radius;
+  inscribed_radius_ = inscribed_radius;
+  cost_scaling_factor_ = cost_scaling_factor;
+  computeCaches();
+  if (info_.width > 0 && info_.height > 0)
+  {
+    dirty_.update(0, 0, info_.width - 1, info_.height - 1);
+  }
+}
+
+void InflationCostmap::setSourceCost(unsigned int x, unsigned int y, unsigned char cost)
+{
+  if (sources_(x, y) == cost) return;
+  sources_.setValue(x, y, cost);
+  dirty_.touch(x, y);
+}
+
+void InflationCostmap::update()
+{
+  if (dirty_.isEmpty()) return;
+  // Only the cells within the inflation radius of a changed source can change
+  nav_core2::UIntBounds changed = expand(dirty_);
+  dirty_.reset();
+  inflate(changed);
+  changes_.update(changed.getMinX(), changed.getMinY(), changed.getMaxX(), changed.getMaxY());
+}
+
+void InflationCostmap::reinflate()
+{
+  if (info_.width == 0 || info_.height == 0) return;
+  dirty_.update(0, 0, info_.width - 1, info_.height - 1);
+  update();
+}
+
+void InflationCostmap::reset()
+{
+  BasicCostmap::reset();
+  sources_.setInfo(info_);
+  sources_.reset();
+  dirty_.reset();
+  queue_->reset();
+}
+
+void InflationCostmap::setInfo(const nav_grid::NavGridInfo& new_info)
+{
+  bool new_resolution = new_info.resolution != info_.resolution;
+  info_ = new_info;
+  if (new_resolution)
+  {
+    computeCaches();
+  }
+  reset();
+}
+
+void InflationCostmap::inflate(const nav_core2::UIntBounds& bounds)
+{
+  // The lethal cells that can reach the bounds are at most cell_inflation_radius_ outside of them,
+  // and the queue may need to pass through the cells between them and the bounds.
+  nav_core2::UIntBounds region = expand(bounds);
+  queue_->resetRegion(region);
+
+  for (unsigned int y = bounds.getMinY(); y <= bounds.getMaxY(); y++)
+  {
+    unsigned int index = getIndex(bounds.getMinX(), y);
+    for (unsigned int x = bounds.getMinX(); x <= bounds.getMaxX(); x++, index++)
+    {
+      data_[index] = sources_(x, y);
+    }
+  }
+
+  for (unsigned int y = region.getMinY(); y <= region.getMaxY(); y++)
+  {
+    for (unsigned int x = region.getMinX(); x <= region.getMaxX(); x++)
+    {
+      if (sources_(x, y) == LETHAL_OBSTACLE)
+      {
+        queue_->enqueueCell(x, y);
+      }
+    }
+  }
+
+  while (!queue_->isEmpty())
+  {
+    CellData cell = queue_->getNextCell();
+    if (!inBounds(bounds, cell.x_, cell.y_)) continue;
+
+    unsigned int dx = std::abs(static_cast<int>(cell.x_) - static_cast<int>(cell.src_x_));
+    unsigned int dy = std::abs(static_cast<int>(cell.y_) - static_cast<int>(cell.src_y_));
+    unsigned char cost = cached_costs_[dx][dy];
+    unsigned char& old_cost = data_[getIndex(cell.x_, cell.y_)];
+    if (old_cost == NO_INFORMATION)
+    {
+      if (cost >= INSCRIBED_INFLATED_OBSTACLE)
+      {
+        old_cost = cost;
+      }
+    }
+    else
+    {
+      old_cost = std::max(old_cost, cost);
+    }
+  }
+}
+
+nav_core2::UIntBounds InflationCostmap::expand(const nav_core2::UIntBounds& bounds) const
+{
+  unsigned int min_x = bounds.getMinX() > cell_inflation_radius_ ? bounds.getMinX() - cell_inflation_radius_ : 0;
+  unsigned int min_y = bounds.getMinY() > cell_inflation_radius_ ? bounds.getMinY() - cell_inflation_radius_ : 0;
+  unsigned int max_x = std::min(bounds.getMaxX() + cell_inflation_radius_, info_.width - 1);
+  unsigned int max_y = std::min(bounds.getMaxY() + cell_inflation_radius_, info_.height - 1);
+  return nav_core2::UIntBounds(min_x, min_y, max_x, max_y);
+}
+
+void InflationCostmap::computeCaches()
+{
+  if (info_.resolution <= 0.0)
+  {
+    cell_inflation_radius_ = 0;
+  }
+  else
+  {
+    cell_inflation_radius_ = static_cast<unsigned int>(std::ceil(inflation_radius_ / info_.resolution));
+  }
+  queue_ = std::make_shared<InflationQueue>(*this, cell_inflation_radius_);
+
+  cached_costs_.resize(cell_inflation_radius_ + 2);
+  for (unsigned int dx = 0; dx < cached_costs_.size(); dx++)
+  {
+    cached_costs_[dx].resize(cell_inflation_radius_ + 2);
+    for (unsigned int dy = 0; dy < cached_costs_[dx].size(); dy++)
+    {
+      double distance = hypot(dx, dy);
+      unsigned char cost;
+      if (distance == 0.0)
+      {
+        cost = LETHAL_OBSTACLE;
+      }
+      else if (distance * info_.resolution <= inscribed_radius_)
+      {
+        cost = INSCRIBED_INFLATED_OBSTACLE;
+      }
+      else
+      {
+        double factor = exp(-1.0 * cost_scaling_factor_ * (distance * info_.resolution - inscribed_radius_));
+        cost = static_cast<unsigned char>((INSCRIBED_INFLATED_OBSTACLE - 1) * factor);
+      }
+      cached_costs_[dx][dy] = cost;
+    }
+  }
+}
+
+}  // namespace costmap_queue
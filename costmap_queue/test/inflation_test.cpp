@@ -0,0 +1,226 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <costmap_queue/inflation_costmap.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using costmap_queue::InflationCostmap;
+using nav_core2::Costmap;
+
+// Copies of the Costmap constants, so gtest can take references to them
+const unsigned char LETHAL = Costmap::LETHAL_OBSTACLE;
+const unsigned char INSCRIBED = Costmap::INSCRIBED_INFLATED_OBSTACLE;
+const unsigned char UNKNOWN = Costmap::NO_INFORMATION;
+const unsigned char FREE = Costmap::FREE_SPACE;
+
+void setSize(InflationCostmap& costmap, unsigned int width, unsigned int height)
+{
+  nav_grid::NavGridInfo info;
+  info.width = width;
+  info.height = height;
+  info.resolution = 0.1;
+  costmap.setInfo(info);
+}
+
+void expectSameCosts(InflationCostmap& a, InflationCostmap& b)
+{
+  ASSERT_EQ(a.getWidth(), b.getWidth());
+  ASSERT_EQ(a.getHeight(), b.getHeight());
+  for (unsigned int y = 0; y < a.getHeight(); y++)
+  {
+    for (unsigned int x = 0; x < a.getWidth(); x++)
+    {
+      ASSERT_EQ(a(x, y), b(x, y)) << "at " << x << ", " << y;
+    }
+  }
+}
+
+TEST(InflationCostmap, single_obstacle)
+{
+  InflationCostmap costmap(0.5, 0.2, 10.0);
+  setSize(costmap, 21, 21);
+  costmap.setSourceCost(10, 10, LETHAL);
+  costmap.update();
+
+  EXPECT_EQ(LETHAL, costmap(10, 10));
+  EXPECT_EQ(INSCRIBED, costmap(12, 10));
+  EXPECT_EQ(INSCRIBED, costmap(11, 11));
+  // 0.3m away, 0.1m outside the inscribed radius
+  EXPECT_EQ(static_cast<unsigned char>(252 * exp(-1.0)), costmap(13, 10));
+  EXPECT_GT(costmap(15, 10), 0);
+  EXPECT_EQ(0, costmap(16, 10));
+  EXPECT_EQ(0, costmap(0, 0));
+
+  costmap.setSourceCost(10, 10, FREE);
+  costmap.update();
+  EXPECT_EQ(0, costmap(10, 10));
+  EXPECT_EQ(0, costmap(12, 10));
+}
+
+TEST(InflationCostmap, unknown_cells)
+{
+  InflationCostmap costmap(0.5, 0.2, 10.0);
+  setSize(costmap, 21, 21);
+  costmap.setSourceCost(12, 10, UNKNOWN);
+  costmap.setSourceCost(14, 10, UNKNOWN);
+  costmap.setSourceCost(10, 10, LETHAL);
+  costmap.update();
+  EXPECT_EQ(INSCRIBED, costmap(12, 10));
+  EXPECT_EQ(UNKNOWN, costmap(14, 10));
+}
+
+TEST(InflationCostmap, change_bounds)
+{
+  InflationCostmap costmap(0.3, 0.0, 10.0);
+  setSize(costmap, 50, 50);
+  costmap.update();
+  costmap.getChangeBounds("test");
+
+  costmap.setSourceCost(20, 25, LETHAL);
+  costmap.update();
+  nav_core2::UIntBounds bounds = costmap.getChangeBounds("test");
+  EXPECT_EQ(17u, bounds.getMinX());
+  EXPECT_EQ(22u, bounds.getMinY());
+  EXPECT_EQ(23u, bounds.getMaxX());
+  EXPECT_EQ(28u, bounds.getMaxY());
+
+  // Nothing changed
+  costmap.setSourceCost(20, 25, LETHAL);
+  costmap.update();
+  EXPECT_TRUE(costmap.getChangeBounds("test").isEmpty());
+}
+
+TEST(InflationCostmap, incremental_matches_full)
+{
+  InflationCostmap incremental(0.5, 0.15, 5.0), full(0.5, 0.15, 5.0);
+  setSize(incremental, 120, 80);
+  setSize(full, 120, 80);
+  srand(42);
+  for (unsigned int round = 0; round < 20; round++)
+  {
+    for (unsigned int i = 0; i < 10; i++)
+    {
+      unsigned int x = rand() % 120, y = rand() % 80;
+      int r = rand() % 4;
+      unsigned char cost = r == 0 ? FREE : (r == 1 ? UNKNOWN : LETHAL);
+      incremental.setSourceCost(x, y, cost);
+      full.setSourceCost(x, y, cost);
+    }
+    incremental.update();
+    full.reinflate();
+    expectSameCosts(incremental, full);
+  }
+}
+
+TEST(InflationCostmap, incremental_work)
+{
+  // Measure work as the number of cells recomputed, which the change bounds report
+  InflationCostmap costmap(0.55, 0.2, 10.0);
+  unsigned int size = 400;
+  setSize(costmap, size, size);
+  srand(7);
+  for (unsigned int i = 0; i < size * size / 100; i++)
+  {
+    costmap.setSourceCost(rand() % size, rand() % size, LETHAL);
+  }
+  costmap.getChangeBounds("test");
+  costmap.reinflate();
+  nav_core2::UIntBounds full = costmap.getChangeBounds("test");
+  EXPECT_EQ(size * size, full.getWidth() * full.getHeight());
+
+  // Only the patch plus the inflation radius (6 cells) around it should be recomputed
+  const unsigned int patch = 40, radius = 6;
+  for (unsigned int i = 0; i < 20; i++)
+  {
+    // A sensor-sized patch of changes
+    unsigned int x0 = rand() % (size - patch), y0 = rand() % (size - patch);
+    for (unsigned int j = 0; j < 20; j++)
+    {
+      costmap.setSourceCost(x0 + rand() % patch, y0 + rand() % patch, LETHAL);
+    }
+    costmap.update();
+    nav_core2::UIntBounds changed = costmap.getChangeBounds("test");
+    if (changed.isEmpty()) continue;
+    EXPECT_LE(changed.getWidth(), patch + 2 * radius);
+    EXPECT_LE(changed.getHeight(), patch + 2 * radius);
+  }
+}
+
+// Timing only, so it is disabled by default. Run with --gtest_also_run_disabled_tests to see the numbers.
+TEST(InflationCostmap, DISABLED_benchmark)
+{
+  InflationCostmap costmap(0.55, 0.2, 10.0);
+  unsigned int size = 1000;
+  setSize(costmap, size, size);
+  srand(7);
+  for (unsigned int i = 0; i < size * size / 100; i++)
+  {
+    costmap.setSourceCost(rand() % size, rand() % size, LETHAL);
+  }
+  costmap.update();
+
+  const unsigned int n = 20;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < n; i++)
+  {
+    costmap.reinflate();
+  }
+  auto full_time = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < n; i++)
+  {
+    // A sensor-sized patch of changes
+    unsigned int x0 = rand() % (size - 40), y0 = rand() % (size - 40);
+    for (unsigned int j = 0; j < 20; j++)
+    {
+      costmap.setSourceCost(x0 + rand() % 40, y0 + rand() % 40, LETHAL);
+    }
+    costmap.update();
+  }
+  auto incremental_time = std::chrono::steady_clock::now() - start;
+
+  std::cout << "Full re-inflation: " << std::chrono::duration<double, std::milli>(full_time).count() / n
+            << " ms, incremental update of a 4m x 4m patch: "
+            << std::chrono::duration<double, std::milli>(incremental_time).count() / n << " ms" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
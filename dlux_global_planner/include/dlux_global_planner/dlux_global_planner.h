@@ -103,6 +103,11 @@ protected:
    */
   virtual bool shouldReturnNewPath(const nav_2d_msgs::Path2D& new_path, const double new_path_cost) const;
 
+  /**
+   * @brief Match the info of the potential grid in use to the costmap's (only allocating that grid)
+   */
+  void updatePotentialGridInfo();
+
   // Plugins
   pluginlib::ClassLoader<PotentialCalculator> calc_loader_;
   boost::shared_ptr<PotentialCalculator> calculator_;
@@ -115,6 +120,11 @@ protected:
   PotentialGrid potential_grid_;
   CostInterpreter::Ptr cost_interpreter_;
 
+  // Compact potential storage
+  bool quantize_potential_;
+  double max_potential_;
+  QuantizedPotentialGrid quantized_potential_grid_;
+
   // Path Caching
   bool path_caching_;
   double improvement_threshold_;
@@ -123,7 +133,7 @@ protected:
   double cached_path_cost_;
 
   // potential publishing
-  nav_grid_pub_sub::ScaleGridPublisher<float> potential_pub_;
+  nav_grid_pub_sub::ScaleGridPublisher<float> potential_pub_, quantized_potential_pub_;
 
   // debug printing
   bool print_statistics_;
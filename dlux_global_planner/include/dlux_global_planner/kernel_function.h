@@ -73,6 +73,8 @@ inline bool operator &(CardinalDirection a, CardinalDirection b)
  * For instance, if just the cell (x+1, y) was used in the calculation, upstream=EAST
  * If (x+1, y) and (x, y+1) were used, upstream=SOUTHEAST.
  *
+ * Templated on the type of potential grid, so it works with both PotentialGrid and QuantizedPotentialGrid.
+ *
  * @param potential_grid[in] potential grid where neighboring values are read from
  * @param cost[in] The cost to traversing to this cell
  * @param x[in] The x coordinate of this cell we're calculating potential for
@@ -80,7 +82,8 @@ inline bool operator &(CardinalDirection a, CardinalDirection b)
  * @param upstream[out] Direction of cells used in computation (if not null initially)
  * @return potential for this cell
  */
-static float calculateKernel(const PotentialGrid& potential_grid, unsigned char cost, unsigned int x, unsigned int y,
+template <typename PotentialGridT>
+static float calculateKernel(const PotentialGridT& potential_grid, unsigned char cost, unsigned int x, unsigned int y,
                              CardinalDirection* upstream = nullptr)
 {
   // See README.md for more about this calculation
@@ -36,7 +36,10 @@
 #define DLUX_GLOBAL_PLANNER_POTENTIAL_H
 
 #include <nav_grid/vector_nav_grid.h>
+#include <stdint.h>
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 namespace dlux_global_planner
 {
@@ -46,6 +49,124 @@ namespace dlux_global_planner
 const float HIGH_POTENTIAL = std::numeric_limits<float>::max();
 
 using PotentialGrid = nav_grid::VectorNavGrid<float>;
+
+/**
+ * @class QuantizedPotentialGrid
+ * @brief Compact alternative to PotentialGrid that stores each potential as a 16 bit fixed-point value
+ *
+ * Potentials from zero to max_potential are rounded to one of 65535 evenly spaced values, so each is within
+ * getPotentialStep() of the value that was set. Any potential greater than max_potential saturates to HIGH_POTENTIAL,
+ * i.e. the cell is treated as though it had not been reached. This halves the memory of the PotentialGrid, which
+ * matters for very large maps, at the cost of precision.
+ */
+class QuantizedPotentialGrid : public nav_grid::NavGrid<float>
+{
+public:
+  explicit QuantizedPotentialGrid(const float default_value = HIGH_POTENTIAL, const double max_potential = 65534.0)
+    : NavGrid<float>(default_value)
+  {
+    setMaxPotential(max_potential);
+  }
+
+  /**
+   * @brief Set the largest potential that can be stored. Existing values are NOT converted.
+   */
+  void setMaxPotential(const double max_potential)
+  {
+    max_potential_ = max_potential;
+    step_ = max_potential / MAX_FINITE_CODE;
+    inverse_step_ = MAX_FINITE_CODE / max_potential;
+  }
+
+  double getMaxPotential() const { return max_potential_; }
+
+  /**
+   * @brief The difference between two consecutive values that can be stored
+   */
+  double getPotentialStep() const { return step_; }
+
+  void reset() override
+  {
+    data_.assign(info_.width * info_.height, encode(default_value_, 0));
+  }
+
+  void setInfo(const nav_grid::NavGridInfo& new_info) override
+  {
+    // Unlike VectorNavGrid, the contents are not preserved, since the potentials are recalculated for every plan
+    info_ = new_info;
+    reset();
+  }
+
+  void setValue(const unsigned int x, const unsigned int y, const float& value) override
+  {
+    unsigned int index = getIndex(x, y);
+    data_[index] = encode(value, index);
+  }
+
+  float getValue(const unsigned int x, const unsigned int y) const override
+  {
+    return decode(data_[getIndex(x, y)]);
+  }
+
+  using NavGrid<float>::operator();
+  using NavGrid<float>::getValue;
+  using NavGrid<float>::setValue;
+
+  float operator[] (unsigned int i) const { return decode(data_[i]); }
+
+  unsigned int size() const { return data_.size(); }
+
+  inline unsigned int getIndex(unsigned int x, unsigned int y) const
+  {
+    return y * info_.width + x;
+  }
+
+  /**
+   * @brief Index of the cell containing the given world coordinates
+   */
+  inline unsigned int getIndex(double x, double y) const
+  {
+    unsigned int mx, my;
+    worldToGridBounded(info_, x, y, mx, my);
+    return getIndex(mx, my);
+  }
+
+  /**
+   * @brief Code used for HIGH_POTENTIAL (and anything greater than max_potential)
+   */
+  static const uint16_t HIGH_CODE = std::numeric_limits<uint16_t>::max();
+  static const uint16_t MAX_FINITE_CODE = HIGH_CODE - 1;
+  static constexpr double GOLDEN_RATIO_CONJUGATE = 0.6180339887498949;
+
+  /**
+   * @brief Convert the potential to its 16 bit code
+   *
+   * Plain rounding would be biased: each step in the same direction adds the same cost, and so would be rounded
+   * the same way every time, with the error accumulating along the path. Instead, the rounding threshold varies
+   * from cell to cell (following the golden ratio sequence of the index), so the errors mostly cancel out.
+   */
+  inline uint16_t encode(const float value, const unsigned int index) const
+  {
+    // Also catches NaN
+    if (!(value <= max_potential_))
+      return HIGH_CODE;
+    if (value <= 0.0f)
+      return 0;
+    double dither = index * GOLDEN_RATIO_CONJUGATE;
+    dither -= static_cast<unsigned int>(dither);
+    return std::min(static_cast<unsigned int>(value * inverse_step_ + dither),
+                    static_cast<unsigned int>(MAX_FINITE_CODE));
+  }
+
+  inline float decode(const uint16_t code) const
+  {
+    return code == HIGH_CODE ? HIGH_POTENTIAL : code * step_;
+  }
+
+protected:
+  std::vector<uint16_t> data_;
+  double max_potential_, step_, inverse_step_;
+};
 }  // namespace dlux_global_planner
 
 #endif  // DLUX_GLOBAL_PLANNER_POTENTIAL_H
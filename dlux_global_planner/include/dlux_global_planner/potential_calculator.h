@@ -38,6 +38,7 @@
 #include <ros/ros.h>
 #include <dlux_global_planner/potential.h>
 #include <dlux_global_planner/cost_interpreter.h>
+#include <nav_core2/exceptions.h>
 #include <geometry_msgs/Pose2D.h>
 
 namespace dlux_global_planner
@@ -78,6 +79,22 @@ public:
    */
   virtual unsigned int updatePotentials(PotentialGrid& potential_grid,
                                         const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal) = 0;
+
+  /**
+   * @brief Potential calculation on the compact QuantizedPotentialGrid, used when quantize_potential is set
+   *
+   * Optional. The default implementation throws, since not every plugin supports quantized potentials.
+   *
+   * @param potential_grid potentials are written into here
+   * @param start Start pose, in the same frame as the potential
+   * @param goal Goal pose, in the same frame as the potential
+   * @return Number of cells expanded. Used for comparing expansion strategies.
+   */
+  virtual unsigned int updatePotentials(QuantizedPotentialGrid& potential_grid,
+                                        const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+  {
+    throw nav_core2::PlannerException("This PotentialCalculator does not support quantized potentials.");
+  }
 protected:
   CostInterpreter::Ptr cost_interpreter_;
 };
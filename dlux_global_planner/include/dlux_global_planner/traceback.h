@@ -38,6 +38,7 @@
 #include <ros/ros.h>
 #include <dlux_global_planner/potential.h>
 #include <dlux_global_planner/cost_interpreter.h>
+#include <nav_core2/exceptions.h>
 #include <nav_grid/nav_grid_info.h>
 #include <nav_2d_msgs/Path2D.h>
 
@@ -78,6 +79,24 @@ public:
   virtual nav_2d_msgs::Path2D getPath(const PotentialGrid& potential_grid,
                                       const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
                                       double& path_cost) = 0;
+
+  /**
+   * @brief Create the path from start to goal using the compact QuantizedPotentialGrid
+   *
+   * Optional. The default implementation throws, since not every plugin supports quantized potentials.
+   *
+   * @param potential_grid[in] potential grid
+   * @param start[in] start pose
+   * @param goal[in] goal pose
+   * @param path_cost[out] A number representing the cost of taking this path. Open to intepretation.
+   * @return The path, in the same frame as the QuantizedPotentialGrid
+   */
+  virtual nav_2d_msgs::Path2D getPath(const QuantizedPotentialGrid& potential_grid,
+                                      const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                                      double& path_cost)
+  {
+    throw nav_core2::PlannerException("This Traceback does not support quantized potentials.");
+  }
 protected:
   /**
    * @brief Helper function to convert a path in Grid coordinates to World coordinates
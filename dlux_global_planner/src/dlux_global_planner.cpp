@@ -45,7 +45,8 @@ namespace dlux_global_planner
 DluxGlobalPlanner::DluxGlobalPlanner() :
   calc_loader_("dlux_global_planner", "dlux_global_planner::PotentialCalculator"),
   traceback_loader_("dlux_global_planner", "dlux_global_planner::Traceback"),
-  potential_grid_(HIGH_POTENTIAL), cached_goal_x_(-1), cached_goal_y_(-1), potential_pub_(potential_grid_)
+  potential_grid_(HIGH_POTENTIAL), quantized_potential_grid_(HIGH_POTENTIAL), cached_goal_x_(-1), cached_goal_y_(-1),
+  potential_pub_(potential_grid_), quantized_potential_pub_(quantized_potential_grid_)
 {
 }
 
@@ -54,11 +55,14 @@ void DluxGlobalPlanner::initialize(const ros::NodeHandle& parent, const std::str
 {
   ros::NodeHandle planner_nh(parent, name);
   costmap_ = costmap;
-  potential_grid_.setInfo(costmap_->getInfo());
 
   cost_interpreter_ = std::make_shared<CostInterpreter>();
   cost_interpreter_->initialize(planner_nh, costmap_);
 
+  planner_nh.param("quantize_potential", quantize_potential_, false);
+  planner_nh.param("max_potential", max_potential_, 0.0);
+  updatePotentialGridInfo();
+
   std::string plugin_name;
   planner_nh.param("potential_calculator", plugin_name, std::string("dlux_plugins::AStar"));
   ROS_INFO_NAMED("DluxGlobalPlanner", "Using PotentialCalculator \"%s\"", plugin_name.c_str());
@@ -77,7 +81,13 @@ void DluxGlobalPlanner::initialize(const ros::NodeHandle& parent, const std::str
   bool publish_potential;
   planner_nh.param("publish_potential", publish_potential, false);
   if (publish_potential)
-    potential_pub_.init(planner_nh, "potential_grid", "potential");
+  {
+    nav_grid_pub_sub::ScaleGridPublisher<float>& pub = quantize_potential_ ? quantized_potential_pub_ : potential_pub_;
+    pub.init(planner_nh, "potential_grid", "potential");
+    bool publish_potential_async;
+    planner_nh.param("publish_potential_async", publish_potential_async, false);
+    pub.setAsynchronous(publish_potential_async);
+  }
 
   planner_nh.param("print_statistics", print_statistics_, false);
 }
@@ -101,11 +111,10 @@ bool DluxGlobalPlanner::isPlanValid(const nav_2d_msgs::Path2D& path) const
 nav_2d_msgs::Path2D DluxGlobalPlanner::makePlan(const nav_2d_msgs::Pose2DStamped& start,
                                                 const nav_2d_msgs::Pose2DStamped& goal)
 {
-  if (potential_grid_.getInfo() != costmap_->getInfo())
-    potential_grid_.setInfo(costmap_->getInfo());
+  updatePotentialGridInfo();
 
-  geometry_msgs::Pose2D local_start = nav_2d_utils::transformStampedPose(tf_, start, potential_grid_.getFrameId());
-  geometry_msgs::Pose2D local_goal = nav_2d_utils::transformStampedPose(tf_, goal, potential_grid_.getFrameId());
+  geometry_msgs::Pose2D local_start = nav_2d_utils::transformStampedPose(tf_, start, costmap_->getFrameId());
+  geometry_msgs::Pose2D local_goal = nav_2d_utils::transformStampedPose(tf_, goal, costmap_->getFrameId());
 
   nav_core2::Costmap& costmap = *costmap_;
   const nav_grid::NavGridInfo& info = costmap.getInfo();
@@ -144,10 +153,21 @@ nav_2d_msgs::Path2D DluxGlobalPlanner::makePlan(const nav_2d_msgs::Pose2DStamped
   }
 
   // Commence path planning.
-  unsigned int n_updated = calculator_->updatePotentials(potential_grid_, local_start, local_goal);
-  potential_pub_.publish();
+  unsigned int n_updated;
   double path_cost = 0.0;  // right now we don't do anything with the cost
-  nav_2d_msgs::Path2D path = traceback_->getPath(potential_grid_, start.pose, goal.pose, path_cost);
+  nav_2d_msgs::Path2D path;
+  if (quantize_potential_)
+  {
+    n_updated = calculator_->updatePotentials(quantized_potential_grid_, local_start, local_goal);
+    quantized_potential_pub_.publish();
+    path = traceback_->getPath(quantized_potential_grid_, start.pose, goal.pose, path_cost);
+  }
+  else
+  {
+    n_updated = calculator_->updatePotentials(potential_grid_, local_start, local_goal);
+    potential_pub_.publish();
+    path = traceback_->getPath(potential_grid_, start.pose, goal.pose, path_cost);
+  }
   if (print_statistics_)
   {
     ROS_INFO_NAMED("DluxGlobalPlanner",
@@ -166,6 +186,30 @@ nav_2d_msgs::Path2D DluxGlobalPlanner::makePlan(const nav_2d_msgs::Pose2DStamped
 }
 
 
+void DluxGlobalPlanner::updatePotentialGridInfo()
+{
+  nav_grid::NavGridInfo info = costmap_->getInfo();
+  if (!quantize_potential_)
+  {
+    if (potential_grid_.getInfo() != info)
+      potential_grid_.setInfo(info);
+    return;
+  }
+
+  if (quantized_potential_grid_.getInfo() == info)
+    return;
+  if (max_potential_ > 0.0)
+  {
+    quantized_potential_grid_.setMaxPotential(max_potential_);
+  }
+  else
+  {
+    // Twice the cost of driving along two full edges of the map through free space
+    quantized_potential_grid_.setMaxPotential(2.0 * cost_interpreter_->getNeutralCost() * (info.width + info.height));
+  }
+  quantized_potential_grid_.setInfo(info);
+}
+
 bool DluxGlobalPlanner::hasValidCachedPath(const geometry_msgs::Pose2D& local_goal,
                                            unsigned int goal_x, unsigned int goal_y)
 {
@@ -0,0 +1,169 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <dlux_global_planner/potential.h>
+#include <dlux_global_planner/kernel_function.h>
+#include <algorithm>
+#include <queue>
+
+using dlux_global_planner::HIGH_POTENTIAL;
+using dlux_global_planner::PotentialGrid;
+using dlux_global_planner::QuantizedPotentialGrid;
+
+const unsigned char NEUTRAL_COST = 50;
+
+/**
+ * @brief Breadth first wavefront from the goal using the kernel function, like dlux_plugins::Dijkstra
+ *
+ * Cells with x == wall_x are impassable, except for a gap at y == gap_y
+ */
+template <typename PotentialGridT>
+void expand(PotentialGridT& potential_grid, unsigned int goal_x, unsigned int goal_y,
+            unsigned int wall_x, unsigned int gap_y)
+{
+  const nav_grid::NavGridInfo info = potential_grid.getInfo();
+  potential_grid.reset();
+  potential_grid.setValue(goal_x, goal_y, 0.0);
+  std::queue<nav_grid::Index> queue;
+  queue.push(nav_grid::Index(goal_x, goal_y));
+  while (!queue.empty())
+  {
+    nav_grid::Index i = queue.front();
+    queue.pop();
+    std::vector<nav_grid::Index> neighbors;
+    if (i.x > 0) neighbors.push_back(nav_grid::Index(i.x - 1, i.y));
+    if (i.y > 0) neighbors.push_back(nav_grid::Index(i.x, i.y - 1));
+    if (i.x < info.width - 1) neighbors.push_back(nav_grid::Index(i.x + 1, i.y));
+    if (i.y < info.height - 1) neighbors.push_back(nav_grid::Index(i.x, i.y + 1));
+    for (const nav_grid::Index& n : neighbors)
+    {
+      if (potential_grid(n.x, n.y) < HIGH_POTENTIAL || (n.x == wall_x && n.y != gap_y))
+        continue;
+      potential_grid.setValue(n, dlux_global_planner::calculateKernel(potential_grid, NEUTRAL_COST, n.x, n.y));
+      if (potential_grid(n.x, n.y) < HIGH_POTENTIAL)
+        queue.push(n);
+    }
+  }
+}
+
+TEST(QuantizedPotential, encoding)
+{
+  nav_grid::NavGridInfo info;
+  info.width = 3;
+  info.height = 2;
+  QuantizedPotentialGrid grid(HIGH_POTENTIAL, 1000.0);
+  grid.setInfo(info);
+  EXPECT_EQ(6u, grid.size());
+  EXPECT_EQ(HIGH_POTENTIAL, grid(2, 1));
+
+  double step = grid.getPotentialStep();
+  EXPECT_NEAR(1000.0 / 65534, step, 1e-9);
+
+  for (float value : {0.0f, 0.01f, 1.0f, 123.456f, 999.99f, 1000.0f})
+  {
+    grid.setValue(1, 1, value);
+    EXPECT_NEAR(value, grid(1, 1), step + 1e-6);
+    EXPECT_EQ(grid(1, 1), grid[grid.getIndex(1u, 1u)]);
+  }
+
+  // Negative values clamp to zero
+  grid.setValue(0, 0, -5.0f);
+  EXPECT_EQ(0.0f, grid(0, 0));
+
+  // Values too large to represent saturate
+  grid.setValue(0, 0, 1000.1f);
+  EXPECT_EQ(HIGH_POTENTIAL, grid(0, 0));
+  grid.setValue(0, 0, HIGH_POTENTIAL);
+  EXPECT_EQ(HIGH_POTENTIAL, grid(0, 0));
+
+  grid.reset();
+  EXPECT_EQ(HIGH_POTENTIAL, grid(1, 1));
+}
+
+TEST(QuantizedPotential, accuracy)
+{
+  nav_grid::NavGridInfo info;
+  info.width = 300;
+  info.height = 200;
+  unsigned int goal_x = 20, goal_y = 180, wall_x = 150, gap_y = 10;
+
+  PotentialGrid float_grid(HIGH_POTENTIAL);
+  float_grid.setInfo(info);
+  expand(float_grid, goal_x, goal_y, wall_x, gap_y);
+
+  // Scale to twice the cost of driving along two edges of the map, like DluxGlobalPlanner does by default
+  QuantizedPotentialGrid quantized_grid(HIGH_POTENTIAL, 2.0 * NEUTRAL_COST * (info.width + info.height));
+  quantized_grid.setInfo(info);
+  expand(quantized_grid, goal_x, goal_y, wall_x, gap_y);
+
+  float max_potential = 0.0, max_error = 0.0;
+  for (unsigned int y = 0; y < info.height; y++)
+  {
+    for (unsigned int x = 0; x < info.width; x++)
+    {
+      float expected = float_grid(x, y);
+      ASSERT_EQ(expected >= HIGH_POTENTIAL, quantized_grid(x, y) >= HIGH_POTENTIAL);
+      if (expected >= HIGH_POTENTIAL)
+        continue;
+      max_potential = std::max(max_potential, expected);
+      max_error = std::max(max_error, std::fabs(quantized_grid(x, y) - expected));
+    }
+  }
+  // The longest path goes around the wall, so the potential is well over what fits in a 16 bit integer
+  EXPECT_GT(max_potential, 20000.0);
+  // The rounding errors accumulate along the wavefront, but remain less than the cost of a single cell
+  EXPECT_LT(max_error, NEUTRAL_COST);
+  EXPECT_LT(max_error / max_potential, 2e-3);
+}
+
+TEST(QuantizedPotential, saturation)
+{
+  nav_grid::NavGridInfo info;
+  info.width = 100;
+  info.height = 10;
+
+  // Not enough range to reach the far side of the map
+  QuantizedPotentialGrid quantized_grid(HIGH_POTENTIAL, 50.0 * NEUTRAL_COST);
+  quantized_grid.setInfo(info);
+  expand(quantized_grid, 0, 0, info.width, 0);
+
+  EXPECT_LT(quantized_grid(10, 5), HIGH_POTENTIAL);
+  EXPECT_EQ(HIGH_POTENTIAL, quantized_grid(99, 9));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
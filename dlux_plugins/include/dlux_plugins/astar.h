@@ -36,7 +36,10 @@
 #define DLUX_PLUGINS_ASTAR_H
 
 #include <dlux_global_planner/potential_calculator.h>
+#include <stdint.h>
 #include <queue>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace dlux_plugins
@@ -54,7 +57,16 @@ public:
                   dlux_global_planner::CostInterpreter::Ptr cost_interpreter) override;
   unsigned int updatePotentials(dlux_global_planner::PotentialGrid& potential_grid,
                                 const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal) override;
+  unsigned int updatePotentials(dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                                const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal) override;
 protected:
+  /**
+   * @brief Implementation of updatePotentials for either type of potential grid
+   */
+  template <typename PotentialGridT>
+  unsigned int updatePotentialsImpl(PotentialGridT& potential_grid,
+                                    const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal);
+
   /**
    * @brief Calculate the potential for index if not calculated already
    *
@@ -63,7 +75,8 @@ protected:
    * @param index Coordinates of cell to calculate
    * @param start_index Coordinates of start cell (for heuristic calculation)
    */
-  void add(dlux_global_planner::PotentialGrid& potential_grid, double prev_potential,
+  template <typename PotentialGridT>
+  void add(PotentialGridT& potential_grid, double prev_potential,
            const nav_grid::Index& index, const nav_grid::Index& start_index);
 
   /**
@@ -74,6 +87,54 @@ protected:
    */
   float getHeuristicValue(const nav_grid::Index& index, const nav_grid::Index& start_index) const;
 
+  /**
+   * @brief Version of updatePotentialsImpl that jumps over uniform areas, used if jump_point_search_ is true
+   *
+   * Only the cells on the path found get potentials, which are the costs of moving along the grid (rather than the
+   * kernel function). See README for details.
+   *
+   * @param potential_grid Potential grid, with the goal already set to zero
+   * @param start_index Coordinates of start cell
+   * @param goal_index Coordinates of goal cell
+   * @return Number of jump points expanded
+   */
+  template <typename PotentialGridT>
+  unsigned int jumpPointSearch(PotentialGridT& potential_grid, const nav_grid::Index& start_index,
+                               const nav_grid::Index& goal_index);
+
+  /**
+   * @brief Write the potentials of the path from the start back to the goal, including the cells jumped over
+   */
+  template <typename PotentialGridT>
+  void fillJumpPointPath(PotentialGridT& potential_grid, const nav_grid::Index& start_index);
+
+  /**
+   * @brief Bring clear_ and clear_runs_ up to date with the current costs
+   *
+   * A cell is clear if it and all eight of its neighbors have the neutral cost. If the costmap can track changes,
+   * only the rows and columns through the region that changed since the last plan are recalculated. Otherwise
+   * (or if the grid info or the neutral cost changed) everything is.
+   */
+  void updateClearRuns(const nav_grid::NavGridInfo& info);
+
+  inline bool isClear(unsigned int x, unsigned int y) const { return clear_[y * width_ + x]; }
+
+  /**
+   * @brief Move from index in one direction until reaching the next jump point
+   *
+   * Clear cells are passed over, unless they are the target or (when moving diagonally) a straight jump from them
+   * would reach a jump point. The first cell that is not clear is a jump point, unless it is lethal.
+   *
+   * @param index Coordinates of the cell to move from
+   * @param direction Which of the eight directions to move in (straight directions are 0-3, diagonal are 4-7)
+   * @param target Coordinates of a cell that is always a jump point (i.e. the start)
+   * @param[out] jump_point Coordinates of the jump point
+   * @param[out] steps Number of steps from index to jump_point
+   * @return False if the edge of the grid or a lethal cell was reached before any jump point
+   */
+  bool jump(const nav_grid::Index& index, unsigned int direction, const nav_grid::Index& target,
+            nav_grid::Index& jump_point, unsigned int& steps) const;
+
   /**
    * @brief Helper Class for sorting indexes by their heuristic
    */
@@ -96,12 +157,48 @@ protected:
     }
   };
 
+  /**
+   * @brief QueueEntry for jump point search, which also has the direction the cell was reached from
+   */
+  struct JumpPointEntry : public QueueEntry
+  {
+  public:
+    JumpPointEntry(nav_grid::Index index, float heuristic, float potential, unsigned int direction)
+      : QueueEntry(index, heuristic), potential(potential), direction(direction) {}
+    float potential;
+    unsigned int direction;
+  };
+
   // Indexes sorted by heuristic
   using AStarQueue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, QueueEntryComparator>;
   AStarQueue queue_;
   bool manhattan_heuristic_;
   bool use_kernel_;
   double minimum_requeue_change_;
+
+  // Jump point search
+  using JumpPointQueue = std::priority_queue<JumpPointEntry, std::vector<JumpPointEntry>, QueueEntryComparator>;
+  bool jump_point_search_;
+  unsigned int width_, height_;
+  nav_core2::Costmap::Ptr costmap_;
+  std::string change_namespace_;  ///< Namespace for the costmap's change bounds
+  nav_grid::NavGridInfo clear_runs_info_;  ///< The grid info clear_runs_ was calculated for
+  float clear_runs_neutral_cost_;  ///< The neutral cost clear_runs_ was calculated for
+  std::vector<unsigned char> clear_;  ///< Nonzero where the cell is clear
+  std::vector<uint16_t> clear_runs_[4];  ///< Number of consecutive clear cells from each cell in each direction
+
+  /**
+   * @brief Best known potential of a jump point and the (index of the) jump point it was reached from
+   */
+  struct JumpPoint
+  {
+    JumpPoint() : potential(0.0), parent(0), closed(false) {}
+    JumpPoint(float potential, unsigned int parent) : potential(potential), parent(parent), closed(false) {}
+    float potential;
+    unsigned int parent;
+    bool closed;
+  };
+  std::unordered_map<unsigned int, JumpPoint> jump_points_;
 };
 }  // namespace dlux_plugins
 
@@ -50,14 +50,24 @@ public:
   // Main PotentialCalculator interface
   unsigned int updatePotentials(dlux_global_planner::PotentialGrid& potential_grid,
                                 const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal) override;
+  unsigned int updatePotentials(dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                                const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal) override;
 protected:
+  /**
+   * @brief Implementation of updatePotentials for either type of potential grid
+   */
+  template <typename PotentialGridT>
+  unsigned int updatePotentialsImpl(PotentialGridT& potential_grid,
+                                    const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal);
+
   /**
    * @brief Calculate the potential for next_index if not calculated already
    *
    * @param potential_grid Potential grid
    * @param next_index Coordinates of cell to calculate
    */
-  void add(dlux_global_planner::PotentialGrid& potential_grid, nav_grid::Index next_index);
+  template <typename PotentialGridT>
+  void add(PotentialGridT& potential_grid, nav_grid::Index next_index);
 
   std::queue<nav_grid::Index> queue_;
 };
@@ -0,0 +1,109 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DLUX_PLUGINS_FAST_SWEEPING_H
+#define DLUX_PLUGINS_FAST_SWEEPING_H
+
+#include <dlux_global_planner/potential_calculator.h>
+#include <boost/thread/barrier.hpp>
+#include <atomic>
+#include <vector>
+
+namespace dlux_plugins
+{
+/**
+ * @class FastSweeping
+ * @brief Potential calculator that repeatedly sweeps over the whole grid in alternating directions with the kernel
+ *
+ * Each cell's potential is lowered to the kernel function of its neighbors, sweeping in each of the four diagonal
+ * directions, until a full round of sweeps changes nothing. The grid is split into square tiles which are swept in
+ * row order. Tiles on the same (tile) anti-diagonal do not border each other, so they are swept in parallel with
+ * num_threads threads, with exactly the same result as a single thread. A tile is skipped if neither it nor the tiles
+ * bordering it have changed since it was last swept, so the later rounds only work on the part that is still changing.
+ */
+class FastSweeping : public dlux_global_planner::PotentialCalculator
+{
+public:
+  // Main PotentialCalculator interface
+  void initialize(ros::NodeHandle& private_nh, nav_core2::Costmap::Ptr costmap,
+                  dlux_global_planner::CostInterpreter::Ptr cost_interpreter) override;
+  unsigned int updatePotentials(dlux_global_planner::PotentialGrid& potential_grid,
+                                const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal) override;
+  unsigned int updatePotentials(dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                                const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal) override;
+protected:
+  /**
+   * @brief Implementation of updatePotentials for either type of potential grid
+   */
+  template <typename PotentialGridT>
+  unsigned int updatePotentialsImpl(PotentialGridT& potential_grid,
+                                    const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal);
+
+  /**
+   * @brief Sweep the tiles assigned to one thread, until a round of sweeps does not change the potentials
+   * @param thread_index Index of this thread, from 0 to num_threads_ - 1
+   * @param barrier Barrier shared by all the threads, waited on after each tile anti-diagonal
+   */
+  template <typename PotentialGridT>
+  void sweepThread(PotentialGridT& potential_grid, unsigned int thread_index, boost::barrier& barrier);
+
+  /**
+   * @brief Sweep one tile in the given direction
+   * @param tile_x Tile column
+   * @param tile_y Tile row
+   * @param reverse_x If true, sweep from high x to low x
+   * @param reverse_y If true, sweep from high y to low y
+   * @param sweep Index of the current sweep (four per round)
+   * @return The number of potentials that were lowered
+   */
+  template <typename PotentialGridT>
+  unsigned int sweepTile(PotentialGridT& potential_grid, unsigned int tile_x, unsigned int tile_y,
+                         bool reverse_x, bool reverse_y, int sweep);
+
+  /**
+   * @brief Check whether the tile or the tiles bordering it have changed since it was last swept
+   */
+  bool tileNeedsSweep(unsigned int tile_x, unsigned int tile_y) const;
+
+  int num_threads_, tile_size_, max_rounds_;
+
+  // State for one call to updatePotentials
+  unsigned int tiles_x_, tiles_y_;
+  std::vector<int> tile_changed_, tile_swept_;  ///< Index of the sweep when each tile last changed/was swept
+  std::atomic<unsigned int> updates_;
+  std::atomic<bool> changed_[3];  ///< Whether each round of sweeps changed anything, indexed by round % 3
+};
+}  // namespace dlux_plugins
+
+#endif  // DLUX_PLUGINS_FAST_SWEEPING_H
@@ -52,15 +52,41 @@ public:
   nav_2d_msgs::Path2D getPath(const dlux_global_planner::PotentialGrid& potential_grid,
                               const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
                               double& path_cost) override;
+  nav_2d_msgs::Path2D getPath(const dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                              const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                              double& path_cost) override;
 protected:
-  bool shouldGridStep(const dlux_global_planner::PotentialGrid& potential_grid, const nav_grid::Index& index);
-  nav_grid::Index gridStep(const dlux_global_planner::PotentialGrid& potential_grid, const nav_grid::Index& index);
-  inline void calculateGradient(const dlux_global_planner::PotentialGrid& potential_grid, const nav_grid::Index& index);
+  /**
+   * @brief Implementation of getPath for either type of potential grid
+   */
+  template <typename PotentialGridT>
+  nav_2d_msgs::Path2D getPathImpl(const PotentialGridT& potential_grid,
+                                  const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                                  double& path_cost);
+  template <typename PotentialGridT>
+  bool shouldGridStep(const PotentialGridT& potential_grid, const nav_grid::Index& index);
+  template <typename PotentialGridT>
+  nav_grid::Index gridStep(const PotentialGridT& potential_grid, const nav_grid::Index& index);
+
+  /**
+   * @brief Get the normalized gradient at index, from the cached gradients if cache_gradients_ is set
+   */
+  template <typename PotentialGridT>
+  inline void getGradient(const PotentialGridT& potential_grid, const nav_grid::Index& index,
+                          double& grad_x, double& grad_y);
+
+  /**
+   * @brief Calculate the normalized gradient at index from the potentials of the neighboring cells
+   */
+  template <typename PotentialGridT>
+  inline void calculateGradient(const PotentialGridT& potential_grid, const nav_grid::Index& index,
+                                double& grad_x, double& grad_y);
 
   double step_size_;
   double lethal_cost_;
   double iteration_factor_;
   bool grid_step_near_high_;
+  bool cache_gradients_;
   nav_grid::VectorNavGrid<double> gradx_, grady_;
 };
 }  // namespace dlux_plugins
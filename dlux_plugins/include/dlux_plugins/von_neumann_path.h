@@ -50,6 +50,17 @@ public:
   nav_2d_msgs::Path2D getPath(const dlux_global_planner::PotentialGrid& potential_grid,
                               const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
                               double& path_cost) override;
+  nav_2d_msgs::Path2D getPath(const dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                              const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                              double& path_cost) override;
+protected:
+  /**
+   * @brief Implementation of getPath for either type of potential grid
+   */
+  template <typename PotentialGridT>
+  nav_2d_msgs::Path2D getPathImpl(const PotentialGridT& potential_grid,
+                                  const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                                  double& path_cost);
 };
 }  // namespace dlux_plugins
 
@@ -38,11 +38,19 @@
 #include <dlux_global_planner/kernel_function.h>
 #include <math.h>
 #include <pluginlib/class_list_macros.h>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 
 PLUGINLIB_EXPORT_CLASS(dlux_plugins::AStar, dlux_global_planner::PotentialCalculator)
 
 namespace dlux_plugins
 {
+// The eight directions for jump point search. The first four (straight) also index AStar::clear_runs_
+const int DIRECTION_X[] = {1, -1, 0,  0, 1, -1,  1, -1};
+const int DIRECTION_Y[] = {0,  0, 1, -1, 1,  1, -1, -1};
+const unsigned int ALL_DIRECTIONS = 8;
+
 void AStar::initialize(ros::NodeHandle& private_nh, nav_core2::Costmap::Ptr costmap,
                        dlux_global_planner::CostInterpreter::Ptr cost_interpreter)
 {
@@ -50,10 +58,34 @@ void AStar::initialize(ros::NodeHandle& private_nh, nav_core2::Costmap::Ptr cost
   private_nh.param("manhattan_heuristic", manhattan_heuristic_, false);
   private_nh.param("use_kernel", use_kernel_, true);
   private_nh.param("minimum_requeue_change", minimum_requeue_change_, 1.0);
+  private_nh.param("jump_point_search", jump_point_search_, false);
+  if (jump_point_search_ && manhattan_heuristic_)
+  {
+    // With diagonal moves, the Manhattan distance overestimates the cost, so the paths would not be the shortest
+    ROS_WARN_NAMED("AStar", "The Manhattan heuristic cannot be used with jump point search. Using Euclidean instead.");
+    manhattan_heuristic_ = false;
+  }
+  costmap_ = costmap;
+  change_namespace_ = private_nh.getNamespace() + "/jump_point_search";
+  clear_runs_info_ = nav_grid::NavGridInfo();
+  clear_runs_neutral_cost_ = 0.0;
 }
 
 unsigned int AStar::updatePotentials(dlux_global_planner::PotentialGrid& potential_grid,
                                      const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+{
+  return updatePotentialsImpl(potential_grid, start, goal);
+}
+
+unsigned int AStar::updatePotentials(dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                                     const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+{
+  return updatePotentialsImpl(potential_grid, start, goal);
+}
+
+template <typename PotentialGridT>
+unsigned int AStar::updatePotentialsImpl(PotentialGridT& potential_grid,
+                                         const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
 {
   const nav_grid::NavGridInfo& info = potential_grid.getInfo();
   queue_ = AStarQueue();
@@ -73,6 +105,11 @@ unsigned int AStar::updatePotentials(dlux_global_planner::PotentialGrid& potenti
     return 0;
   }
 
+  if (jump_point_search_)
+  {
+    return jumpPointSearch(potential_grid, start_i, goal_i);
+  }
+
   unsigned int width_bound = potential_grid.getWidth() - 1, height_bound = potential_grid.getHeight() - 1;
   unsigned int c = 0;
 
@@ -100,7 +137,8 @@ unsigned int AStar::updatePotentials(dlux_global_planner::PotentialGrid& potenti
   throw nav_core2::NoGlobalPathException();
 }
 
-void AStar::add(dlux_global_planner::PotentialGrid& potential_grid, double prev_potential,
+template <typename PotentialGridT>
+void AStar::add(PotentialGridT& potential_grid, double prev_potential,
                 const nav_grid::Index& index, const nav_grid::Index& start_index)
 {
   float cost = cost_interpreter_->getCost(index.x, index.y);
@@ -121,9 +159,266 @@ void AStar::add(dlux_global_planner::PotentialGrid& potential_grid, double prev_
     return;
 
   potential_grid.setValue(index, new_potential);
+  // A potential too large for the grid to store is saturated, and there is no point in expanding from it
+  if (potential_grid(index) >= dlux_global_planner::HIGH_POTENTIAL)
+    return;
   queue_.push(QueueEntry(index, new_potential + getHeuristicValue(index, start_index)));
 }
 
+template <typename PotentialGridT>
+unsigned int AStar::jumpPointSearch(PotentialGridT& potential_grid, const nav_grid::Index& start_index,
+                                    const nav_grid::Index& goal_index)
+{
+  updateClearRuns(potential_grid.getInfo());
+  float neutral_cost = cost_interpreter_->getNeutralCost();
+  unsigned int goal = goal_index.y * width_ + goal_index.x;
+
+  JumpPointQueue queue;
+  queue.push(JumpPointEntry(goal_index, 0.0, 0.0, ALL_DIRECTIONS));
+  jump_points_.clear();
+  jump_points_[goal] = JumpPoint(0.0, goal);
+  unsigned int c = 0;
+
+  while (!queue.empty())
+  {
+    JumpPointEntry top = queue.top();
+    queue.pop();
+    JumpPoint& top_point = jump_points_[top.i.y * width_ + top.i.x];
+    if (top_point.closed || top.potential > top_point.potential)
+      continue;
+    top_point.closed = true;
+    c++;
+
+    if (top.i == start_index)
+    {
+      fillJumpPointPath(potential_grid, start_index);
+      return c;
+    }
+
+    // In a clear cell, only the natural neighbors (the ones straight ahead) need to be considered. Anywhere else,
+    // the costs may differ, so all of the neighbors are.
+    unsigned int directions[8];
+    unsigned int n_directions = 0;
+    if (top.direction == ALL_DIRECTIONS || !isClear(top.i.x, top.i.y))
+    {
+      for (unsigned int direction = 0; direction < 8; direction++)
+        directions[n_directions++] = direction;
+    }
+    else
+    {
+      directions[n_directions++] = top.direction;
+      if (top.direction >= 4)
+      {
+        directions[n_directions++] = DIRECTION_X[top.direction] > 0 ? 0 : 1;
+        directions[n_directions++] = DIRECTION_Y[top.direction] > 0 ? 2 : 3;
+      }
+    }
+
+    for (unsigned int d = 0; d < n_directions; d++)
+    {
+      unsigned int direction = directions[d];
+      nav_grid::Index jump_point;
+      unsigned int steps;
+      if (!jump(top.i, direction, start_index, jump_point, steps))
+        continue;
+
+      // The cells jumped over all have the neutral cost
+      double step_length = direction < 4 ? 1.0 : M_SQRT2;
+      float potential = top.potential + step_length * ((steps - 1) * neutral_cost +
+                                                       cost_interpreter_->getCost(jump_point.x, jump_point.y));
+      unsigned int jump_index = jump_point.y * width_ + jump_point.x;
+      auto it = jump_points_.find(jump_index);
+      if (it != jump_points_.end() && (it->second.closed || it->second.potential <= potential))
+        continue;
+
+      jump_points_[jump_index] = JumpPoint(potential, top.i.y * width_ + top.i.x);
+      queue.push(JumpPointEntry(jump_point, potential + getHeuristicValue(jump_point, start_index), potential,
+                                direction));
+    }
+  }
+
+  throw nav_core2::NoGlobalPathException();
+}
+
+template <typename PotentialGridT>
+void AStar::fillJumpPointPath(PotentialGridT& potential_grid, const nav_grid::Index& start_index)
+{
+  float neutral_cost = cost_interpreter_->getNeutralCost();
+  unsigned int index = start_index.y * width_ + start_index.x;
+  while (true)
+  {
+    JumpPoint point = jump_points_[index];
+    unsigned int x = index % width_, y = index / width_;
+    potential_grid.setValue(x, y, point.potential);
+    if (point.parent == index)
+      return;
+
+    // Fill in the cells jumped over between the jump point and its parent
+    JumpPoint parent = jump_points_[point.parent];
+    int parent_x = point.parent % width_, parent_y = point.parent / width_;
+    int dx = (static_cast<int>(x) > parent_x) - (static_cast<int>(x) < parent_x);
+    int dy = (static_cast<int>(y) > parent_y) - (static_cast<int>(y) < parent_y);
+    unsigned int steps = std::max(std::abs(static_cast<int>(x) - parent_x), std::abs(static_cast<int>(y) - parent_y));
+    double step_cost = (dx != 0 && dy != 0 ? M_SQRT2 : 1.0) * neutral_cost;
+    for (unsigned int k = 1; k < steps; k++)
+    {
+      potential_grid.setValue(parent_x + k * dx, parent_y + k * dy, parent.potential + k * step_cost);
+    }
+    index = point.parent;
+  }
+}
+
+void AStar::updateClearRuns(const nav_grid::NavGridInfo& info)
+{
+  float neutral_cost = cost_interpreter_->getNeutralCost();
+  bool can_track_changes = costmap_ && costmap_->canTrackChanges();
+  nav_core2::UIntBounds changed;
+  if (info != clear_runs_info_ || neutral_cost != clear_runs_neutral_cost_ || !can_track_changes)
+  {
+    clear_runs_info_ = info;
+    clear_runs_neutral_cost_ = neutral_cost;
+    width_ = info.width;
+    height_ = info.height;
+    clear_.assign(width_ * height_, 0);
+    for (std::vector<uint16_t>& runs : clear_runs_)
+    {
+      runs.assign(width_ * height_, 0);
+    }
+    // Start tracking the changes from here
+    if (can_track_changes)
+      costmap_->getChangeBounds(change_namespace_);
+    if (width_ == 0 || height_ == 0)
+      return;
+    changed = nav_core2::UIntBounds(0, 0, width_ - 1, height_ - 1);
+  }
+  else
+  {
+    changed = costmap_->getChangeBounds(change_namespace_);
+    if (changed.isEmpty())
+      return;
+  }
+  if (width_ < 3 || height_ < 3)
+    return;
+
+  // A change can make the cells next to it (but never the edges of the grid) clear or not
+  const unsigned int min_x = std::max(changed.getMinX(), 2u) - 1, min_y = std::max(changed.getMinY(), 2u) - 1;
+  const unsigned int max_x = std::min(changed.getMaxX() + 1, width_ - 2);
+  const unsigned int max_y = std::min(changed.getMaxY() + 1, height_ - 2);
+  const unsigned int region_width = max_x - min_x + 1;
+
+  // neutral_rows is nonzero where the cell and its left and right neighbors all have the neutral cost
+  std::vector<unsigned char> neutral(region_width + 2), neutral_rows(region_width * (max_y - min_y + 3));
+  for (unsigned int y = min_y - 1; y <= max_y + 1; y++)
+  {
+    for (unsigned int x = min_x - 1; x <= max_x + 1; x++)
+    {
+      neutral[x + 1 - min_x] = cost_interpreter_->getCost(x, y) == neutral_cost;
+    }
+    unsigned char* row = &neutral_rows[(y + 1 - min_y) * region_width];
+    for (unsigned int i = 0; i < region_width; i++)
+    {
+      row[i] = neutral[i] & neutral[i + 1] & neutral[i + 2];
+    }
+  }
+  for (unsigned int y = min_y; y <= max_y; y++)
+  {
+    const unsigned char* below = &neutral_rows[(y - min_y) * region_width];
+    const unsigned char* middle = below + region_width;
+    const unsigned char* above = middle + region_width;
+    unsigned char* clear = &clear_[y * width_ + min_x];
+    for (unsigned int i = 0; i < region_width; i++)
+    {
+      clear[i] = below[i] & middle[i] & above[i];
+    }
+  }
+
+  // Only the runs along the rows and columns through the region can change. The edges of the grid are never clear,
+  // so the runs do not need any bounds checks. All passes go row by row.
+  const unsigned int max_run = std::numeric_limits<uint16_t>::max();
+  for (unsigned int y = min_y; y <= max_y; y++)
+  {
+    const unsigned char* clear = &clear_[y * width_];
+    uint16_t* west = &clear_runs_[1][y * width_];
+    uint16_t* east = &clear_runs_[0][y * width_];
+    for (unsigned int x = 1; x + 1 < width_; x++)
+    {
+      west[x] = clear[x] ? std::min(west[x - 1] + 1u, max_run) : 0;
+    }
+    for (unsigned int x = width_ - 2; x > 0; x--)
+    {
+      east[x] = clear[x] ? std::min(east[x + 1] + 1u, max_run) : 0;
+    }
+  }
+  for (unsigned int y = 1; y + 1 < height_; y++)
+  {
+    const unsigned char* clear = &clear_[y * width_];
+    const uint16_t* south_below = &clear_runs_[3][(y - 1) * width_];
+    uint16_t* south = &clear_runs_[3][y * width_];
+    for (unsigned int x = min_x; x <= max_x; x++)
+    {
+      south[x] = clear[x] ? std::min(south_below[x] + 1u, max_run) : 0;
+    }
+  }
+  for (unsigned int y = height_ - 2; y > 0; y--)
+  {
+    const unsigned char* clear = &clear_[y * width_];
+    const uint16_t* north_above = &clear_runs_[2][(y + 1) * width_];
+    uint16_t* north = &clear_runs_[2][y * width_];
+    for (unsigned int x = min_x; x <= max_x; x++)
+    {
+      north[x] = clear[x] ? std::min(north_above[x] + 1u, max_run) : 0;
+    }
+  }
+}
+
+bool AStar::jump(const nav_grid::Index& index, unsigned int direction, const nav_grid::Index& target,
+                 nav_grid::Index& jump_point, unsigned int& steps) const
+{
+  int dx = DIRECTION_X[direction], dy = DIRECTION_Y[direction];
+  int x = index.x, y = index.y;
+  steps = 0;
+  while (true)
+  {
+    x += dx;
+    y += dy;
+    steps++;
+    if (x < 0 || y < 0 || x >= static_cast<int>(width_) || y >= static_cast<int>(height_))
+      return false;
+    jump_point.x = x;
+    jump_point.y = y;
+    if (jump_point == target)
+      return true;
+    if (!isClear(x, y))
+      return !cost_interpreter_->isLethal(cost_interpreter_->getCost(x, y));
+
+    if (direction < 4)
+    {
+      // Skip to the last clear cell of the run, unless the target is in it
+      int run = clear_runs_[direction][y * width_ + x];
+      bool target_in_line = dx != 0 ? static_cast<int>(target.y) == y : static_cast<int>(target.x) == x;
+      int target_offset = dx != 0 ? (static_cast<int>(target.x) - x) * dx : (static_cast<int>(target.y) - y) * dy;
+      if (target_in_line && target_offset > 0 && target_offset < run)
+      {
+        jump_point = target;
+        steps += target_offset;
+        return true;
+      }
+      x += (run - 1) * dx;
+      y += (run - 1) * dy;
+      steps += run - 1;
+    }
+    else
+    {
+      // A diagonal move stops wherever one of the straight moves it is made up of would find something
+      nav_grid::Index straight_point;
+      unsigned int straight_steps;
+      if (jump(jump_point, dx > 0 ? 0 : 1, target, straight_point, straight_steps) ||
+          jump(jump_point, dy > 0 ? 2 : 3, target, straight_point, straight_steps))
+        return true;
+    }
+  }
+}
+
 inline unsigned int uintDiff(const unsigned int a, const unsigned int b)
 {
   return (a > b) ? a - b : b - a;
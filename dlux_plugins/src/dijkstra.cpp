@@ -45,6 +45,19 @@ namespace dlux_plugins
 {
 unsigned int Dijkstra::updatePotentials(dlux_global_planner::PotentialGrid& potential_grid,
                                         const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+{
+  return updatePotentialsImpl(potential_grid, start, goal);
+}
+
+unsigned int Dijkstra::updatePotentials(dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                                        const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+{
+  return updatePotentialsImpl(potential_grid, start, goal);
+}
+
+template <typename PotentialGridT>
+unsigned int Dijkstra::updatePotentialsImpl(PotentialGridT& potential_grid,
+                                            const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
 {
   const nav_grid::NavGridInfo& info = potential_grid.getInfo();
   queue_ = std::queue<nav_grid::Index>();
@@ -81,7 +94,8 @@ unsigned int Dijkstra::updatePotentials(dlux_global_planner::PotentialGrid& pote
   throw nav_core2::NoGlobalPathException();
 }
 
-void Dijkstra::add(dlux_global_planner::PotentialGrid& potential_grid, nav_grid::Index next_index)
+template <typename PotentialGridT>
+void Dijkstra::add(PotentialGridT& potential_grid, nav_grid::Index next_index)
 {
   if (potential_grid(next_index.x, next_index.y) < dlux_global_planner::HIGH_POTENTIAL)
     return;
@@ -91,6 +105,9 @@ void Dijkstra::add(dlux_global_planner::PotentialGrid& potential_grid, nav_grid:
     return;
   potential_grid.setValue(next_index,
                           dlux_global_planner::calculateKernel(potential_grid, cost, next_index.x, next_index.y));
+  // A potential too large for the grid to store is saturated, and there is no point in expanding from it
+  if (potential_grid(next_index.x, next_index.y) >= dlux_global_planner::HIGH_POTENTIAL)
+    return;
   queue_.push(next_index);
 }
 
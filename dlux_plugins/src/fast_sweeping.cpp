@@ -0,0 +1,216 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <dlux_plugins/fast_sweeping.h>
+#include <nav_grid/coordinate_conversion.h>
+#include <nav_core2/exceptions.h>
+#include <dlux_global_planner/kernel_function.h>
+#include <pluginlib/class_list_macros.h>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <functional>
+
+PLUGINLIB_EXPORT_CLASS(dlux_plugins::FastSweeping, dlux_global_planner::PotentialCalculator)
+
+namespace dlux_plugins
+{
+void FastSweeping::initialize(ros::NodeHandle& private_nh, nav_core2::Costmap::Ptr costmap,
+                              dlux_global_planner::CostInterpreter::Ptr cost_interpreter)
+{
+  cost_interpreter_ = cost_interpreter;
+  private_nh.param("num_threads", num_threads_, 1);
+  private_nh.param("tile_size", tile_size_, 64);
+  private_nh.param("max_rounds", max_rounds_, 100);
+  num_threads_ = std::max(num_threads_, 1);
+  tile_size_ = std::max(tile_size_, 1);
+}
+
+unsigned int FastSweeping::updatePotentials(dlux_global_planner::PotentialGrid& potential_grid,
+                                            const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+{
+  return updatePotentialsImpl(potential_grid, start, goal);
+}
+
+unsigned int FastSweeping::updatePotentials(dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                                            const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+{
+  return updatePotentialsImpl(potential_grid, start, goal);
+}
+
+template <typename PotentialGridT>
+unsigned int FastSweeping::updatePotentialsImpl(PotentialGridT& potential_grid,
+                                                const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+{
+  const nav_grid::NavGridInfo& info = potential_grid.getInfo();
+  potential_grid.reset();
+
+  nav_grid::Index goal_i;
+  worldToGridBounded(info, goal.x, goal.y, goal_i.x, goal_i.y);
+  potential_grid.setValue(goal_i, 0.0);
+
+  nav_grid::Index start_i;
+  worldToGridBounded(info, start.x, start.y, start_i.x, start_i.y);
+
+  tiles_x_ = (info.width + tile_size_ - 1) / tile_size_;
+  tiles_y_ = (info.height + tile_size_ - 1) / tile_size_;
+  tile_changed_.assign(tiles_x_ * tiles_y_, -1);
+  tile_swept_.assign(tiles_x_ * tiles_y_, 0);
+  tile_changed_[(goal_i.y / tile_size_) * tiles_x_ + goal_i.x / tile_size_] = 0;
+  updates_ = 0;
+  for (std::atomic<bool>& changed : changed_)
+  {
+    changed = false;
+  }
+
+  boost::barrier barrier(num_threads_);
+  boost::thread_group threads;
+  for (int i = 1; i < num_threads_; i++)
+  {
+    threads.create_thread(std::bind(&FastSweeping::sweepThread<PotentialGridT>, this, std::ref(potential_grid), i,
+                                    std::ref(barrier)));
+  }
+  sweepThread(potential_grid, 0, barrier);
+  threads.join_all();
+
+  if (potential_grid(start_i.x, start_i.y) >= dlux_global_planner::HIGH_POTENTIAL)
+  {
+    throw nav_core2::NoGlobalPathException();
+  }
+  return updates_;
+}
+
+template <typename PotentialGridT>
+void FastSweeping::sweepThread(PotentialGridT& potential_grid, unsigned int thread_index, boost::barrier& barrier)
+{
+  unsigned int num_diagonals = tiles_x_ + tiles_y_ - 1;
+  for (int round = 0; round < max_rounds_; round++)
+  {
+    // changed_[(round + 1) % 3] was last read at the end of round - 2, and will not be written until round + 1
+    if (thread_index == 0)
+    {
+      changed_[(round + 1) % 3] = false;
+    }
+
+    unsigned int local_updates = 0;
+    for (unsigned int direction = 0; direction < 4; direction++)
+    {
+      bool reverse_x = direction & 1, reverse_y = direction & 2;
+      for (unsigned int diagonal = 0; diagonal < num_diagonals; diagonal++)
+      {
+        // The tiles (i, j) with i + j == diagonal, counting from the corner the sweep starts in
+        unsigned int min_i = diagonal >= tiles_y_ ? diagonal - tiles_y_ + 1 : 0;
+        unsigned int max_i = std::min(diagonal, tiles_x_ - 1);
+        for (unsigned int i = min_i + thread_index; i <= max_i; i += num_threads_)
+        {
+          unsigned int j = diagonal - i;
+          unsigned int tile_x = reverse_x ? tiles_x_ - 1 - i : i;
+          unsigned int tile_y = reverse_y ? tiles_y_ - 1 - j : j;
+          local_updates += sweepTile(potential_grid, tile_x, tile_y, reverse_x, reverse_y, round * 4 + direction);
+        }
+        barrier.wait();
+      }
+    }
+
+    if (local_updates > 0)
+    {
+      changed_[round % 3] = true;
+      updates_ += local_updates;
+    }
+    barrier.wait();
+    if (!changed_[round % 3]) break;
+  }
+}
+
+bool FastSweeping::tileNeedsSweep(unsigned int tile_x, unsigned int tile_y) const
+{
+  unsigned int tile = tile_y * tiles_x_ + tile_x;
+  int last_change = tile_changed_[tile];
+  if (tile_x > 0)
+    last_change = std::max(last_change, tile_changed_[tile - 1]);
+  if (tile_x < tiles_x_ - 1)
+    last_change = std::max(last_change, tile_changed_[tile + 1]);
+  if (tile_y > 0)
+    last_change = std::max(last_change, tile_changed_[tile - tiles_x_]);
+  if (tile_y < tiles_y_ - 1)
+    last_change = std::max(last_change, tile_changed_[tile + tiles_x_]);
+  // A neighbor swept later in the same sweep counts as changed since this tile was swept
+  return last_change >= tile_swept_[tile];
+}
+
+template <typename PotentialGridT>
+unsigned int FastSweeping::sweepTile(PotentialGridT& potential_grid,
+                                     unsigned int tile_x, unsigned int tile_y, bool reverse_x, bool reverse_y,
+                                     int sweep)
+{
+  // Only this thread reads or writes this tile's entries while it is being swept, and the bordering tiles are
+  // on the neighboring anti-diagonals, so they are not being swept at the same time.
+  if (!tileNeedsSweep(tile_x, tile_y))
+  {
+    return 0;
+  }
+  unsigned int tile = tile_y * tiles_x_ + tile_x;
+  tile_swept_[tile] = sweep;
+
+  unsigned int x0 = tile_x * tile_size_, y0 = tile_y * tile_size_;
+  unsigned int x1 = std::min(x0 + tile_size_, potential_grid.getWidth());
+  unsigned int y1 = std::min(y0 + tile_size_, potential_grid.getHeight());
+  unsigned int updates = 0;
+  for (unsigned int k = 0; k < y1 - y0; k++)
+  {
+    unsigned int y = reverse_y ? y1 - 1 - k : y0 + k;
+    for (unsigned int m = 0; m < x1 - x0; m++)
+    {
+      unsigned int x = reverse_x ? x1 - 1 - m : x0 + m;
+      float cost = cost_interpreter_->getCost(x, y);
+      if (cost_interpreter_->isLethal(cost))
+        continue;
+      float potential = dlux_global_planner::calculateKernel(potential_grid, cost, x, y);
+      float old_potential = potential_grid(x, y);
+      if (potential < old_potential)
+      {
+        potential_grid.setValue(x, y, potential);
+        // Compare what was actually stored, so that rounding or saturation does not count as a change forever
+        if (potential_grid(x, y) < old_potential)
+          updates++;
+      }
+    }
+  }
+  if (updates > 0)
+  {
+    tile_changed_[tile] = sweep;
+  }
+  return updates;
+}
+
+}  // namespace dlux_plugins
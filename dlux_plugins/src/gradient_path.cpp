@@ -58,20 +58,42 @@ void GradientPath::initialize(ros::NodeHandle& private_nh, dlux_global_planner::
   // NavFn would not attempt to calculate a gradient if one of the neighboring cells had not been initialized.
   // Setting this to true will replicate that behavior
   private_nh.param("grid_step_near_high", grid_step_near_high_, false);
+
+  // Caching the gradients takes two more grids of doubles the size of the potential grid. Without the cache, the
+  // (cheap) gradient calculation is repeated for each step of the path instead.
+  private_nh.param("cache_gradients", cache_gradients_, true);
 }
 
 nav_2d_msgs::Path2D GradientPath::getPath(const dlux_global_planner::PotentialGrid& potential_grid,
                                           const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
                                           double& path_cost)
+{
+  return getPathImpl(potential_grid, start, goal, path_cost);
+}
+
+nav_2d_msgs::Path2D GradientPath::getPath(const dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                                          const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                                          double& path_cost)
+{
+  return getPathImpl(potential_grid, start, goal, path_cost);
+}
+
+template <typename PotentialGridT>
+nav_2d_msgs::Path2D GradientPath::getPathImpl(const PotentialGridT& potential_grid,
+                                              const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                                              double& path_cost)
 {
   const nav_grid::NavGridInfo& info = potential_grid.getInfo();
-  if (gradx_.getInfo() != info)
+  if (cache_gradients_)
   {
-    gradx_.setInfo(info);
-    grady_.setInfo(info);
+    if (gradx_.getInfo() != info)
+    {
+      gradx_.setInfo(info);
+      grady_.setInfo(info);
+    }
+    gradx_.reset();
+    grady_.reset();
   }
-  gradx_.reset();
-  grady_.reset();
 
   nav_2d_msgs::Path2D path;
   path_cost = 0.0;
@@ -168,23 +190,23 @@ nav_2d_msgs::Path2D GradientPath::getPath(const dlux_global_planner::PotentialGr
       nav_grid::Index  index_e(index.x + 1, index.y),
                        index_n(index.x,     index.y + 1),
                       index_ne(index.x + 1, index.y + 1);
-      calculateGradient(potential_grid, index);
-      calculateGradient(potential_grid, index_e);
-      calculateGradient(potential_grid, index_n);
-      calculateGradient(potential_grid, index_ne);
+      double gx, gy, gx_e, gy_e, gx_n, gy_n, gx_ne, gy_ne;
+      getGradient(potential_grid, index, gx, gy);
+      getGradient(potential_grid, index_e, gx_e, gy_e);
+      getGradient(potential_grid, index_n, gx_n, gy_n);
+      getGradient(potential_grid, index_ne, gx_ne, gy_ne);
 
       // get interpolated gradient
-      float x1 = (1.0 - dx) * gradx_(index) + dx * gradx_(index_e);
-      float x2 = (1.0 - dx) * gradx_(index_n) + dx * gradx_(index_ne);
+      float x1 = (1.0 - dx) * gx + dx * gx_e;
+      float x2 = (1.0 - dx) * gx_n + dx * gx_ne;
       float x = (1.0 - dy) * x1 + dy * x2;  // interpolated x
-      float y1 = (1.0 - dx) * grady_(index) + dx * grady_(index_e);
-      float y2 = (1.0 - dx) * grady_(index_n) + dx * grady_(index_ne);
+      float y1 = (1.0 - dx) * gy + dx * gy_e;
+      float y2 = (1.0 - dx) * gy_n + dx * gy_ne;
       float y = (1.0 - dy) * y1 + dy * y2;  // interpolated y
 
       // show gradients
       ROS_DEBUG_NAMED("GradientPath", "%0.2f,%0.2f  %0.2f,%0.2f  %0.2f,%0.2f  %0.2f,%0.2f; final x=%.3f, y=%.3f",
-                      gradx_(index), grady_(index), gradx_(index_e), grady_(index_e),
-                      gradx_(index_n), grady_(index_n), gradx_(index_ne), grady_(index_ne), x, y);
+                      gx, gy, gx_e, gy_e, gx_n, gy_n, gx_ne, gy_ne, x, y);
 
       // check for zero gradient
       if (x == 0.0 && y == 0.0)
@@ -232,8 +254,8 @@ nav_2d_msgs::Path2D GradientPath::getPath(const dlux_global_planner::PotentialGr
   return path;
 }
 
-bool GradientPath::shouldGridStep(const dlux_global_planner::PotentialGrid& potential_grid,
-                                  const nav_grid::Index& index)
+template <typename PotentialGridT>
+bool GradientPath::shouldGridStep(const PotentialGridT& potential_grid, const nav_grid::Index& index)
 {
   bool near_edge = index.x == 0 || index.x >= potential_grid.getWidth() - 1 ||
                    index.y == 0 || index.y >= potential_grid.getHeight() - 1;
@@ -252,8 +274,8 @@ bool GradientPath::shouldGridStep(const dlux_global_planner::PotentialGrid& pote
       potential_grid(index.x - 1, index.y - 1) >= HIGH_POTENTIAL;
 }
 
-nav_grid::Index GradientPath::gridStep(const dlux_global_planner::PotentialGrid& potential_grid,
-                                       const nav_grid::Index& index)
+template <typename PotentialGridT>
+nav_grid::Index GradientPath::gridStep(const PotentialGridT& potential_grid, const nav_grid::Index& index)
 {
   // check eight neighbors to find the lowest
   nav_grid::Index min_index = index;
@@ -358,13 +380,31 @@ nav_grid::Index GradientPath::gridStep(const dlux_global_planner::PotentialGrid&
   return min_index;
 }
 
-void GradientPath::calculateGradient(const dlux_global_planner::PotentialGrid& potential_grid,
-                                     const nav_grid::Index& index)
+template <typename PotentialGridT>
+void GradientPath::getGradient(const PotentialGridT& potential_grid, const nav_grid::Index& index,
+                               double& grad_x, double& grad_y)
 {
+  if (!cache_gradients_)
+  {
+    calculateGradient(potential_grid, index, grad_x, grad_y);
+    return;
+  }
+
   // If non-zero, gradient already calculated, skip
-  if (gradx_(index) + grady_(index) > 0.0)
+  grad_x = gradx_(index);
+  grad_y = grady_(index);
+  if (grad_x + grad_y > 0.0)
     return;
 
+  calculateGradient(potential_grid, index, grad_x, grad_y);
+  gradx_.setValue(index, grad_x);
+  grady_.setValue(index, grad_y);
+}
+
+template <typename PotentialGridT>
+void GradientPath::calculateGradient(const PotentialGridT& potential_grid, const nav_grid::Index& index,
+                                     double& grad_x, double& grad_y)
+{
   float cv = potential_grid(index);
   float dx = 0.0;
   float dy = 0.0;
@@ -407,8 +447,13 @@ void GradientPath::calculateGradient(const dlux_global_planner::PotentialGrid& p
   if (norm > 0)
   {
     norm = 1.0 / norm;
-    gradx_.setValue(index, norm * dx);
-    grady_.setValue(index, norm * dy);
+    grad_x = norm * dx;
+    grad_y = norm * dy;
+  }
+  else
+  {
+    grad_x = 0.0;
+    grad_y = 0.0;
   }
 }
 
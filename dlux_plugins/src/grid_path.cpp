@@ -46,6 +46,21 @@ namespace dlux_plugins
 nav_2d_msgs::Path2D GridPath::getPath(const dlux_global_planner::PotentialGrid& potential_grid,
                                       const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
                                       double& path_cost)
+{
+  return getPathImpl(potential_grid, start, goal, path_cost);
+}
+
+nav_2d_msgs::Path2D GridPath::getPath(const dlux_global_planner::QuantizedPotentialGrid& potential_grid,
+                                      const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                                      double& path_cost)
+{
+  return getPathImpl(potential_grid, start, goal, path_cost);
+}
+
+template <typename PotentialGridT>
+nav_2d_msgs::Path2D GridPath::getPathImpl(const PotentialGridT& potential_grid,
+                                          const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal,
+                                          double& path_cost)
 {
   const nav_grid::NavGridInfo& info = potential_grid.getInfo();
   nav_2d_msgs::Path2D path;
@@ -33,12 +33,20 @@
  */
 #include <global_planner_tests/many_map_test_suite.h>
 #include <dlux_global_planner/dlux_global_planner.h>
+#include <dlux_plugins/astar.h>
+#include <dlux_plugins/dijkstra.h>
+#include <dlux_plugins/fast_sweeping.h>
+#include <nav_core2/basic_costmap.h>
 #include <ros/ros.h>
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <memory>
 #include <string>
 
 using global_planner_tests::many_map_test_suite;
 using dlux_global_planner::DluxGlobalPlanner;
+using dlux_global_planner::PotentialGrid;
+using dlux_global_planner::HIGH_POTENTIAL;
 
 void dlux_test(std::string ns, std::string potential_calculator = "", std::string traceback = "")
 {
@@ -68,6 +76,13 @@ TEST(GlobalPlanner, AStarGradient)
   dlux_test("AStarGradient", "dlux_plugins::AStar", "dlux_plugins::GradientPath");
 }
 
+TEST(GlobalPlanner, AStarJumpPointGrid)
+{
+  ros::NodeHandle nh("~/AStarJumpPointGrid");
+  nh.setParam("jump_point_search", true);
+  dlux_test("AStarJumpPointGrid", "dlux_plugins::AStar", "dlux_plugins::GridPath");
+}
+
 TEST(GlobalPlanner, DijkstraVon)
 {
   dlux_test("DijkstraVon", "dlux_plugins::Dijkstra", "dlux_plugins::VonNeumannPath");
@@ -83,6 +98,233 @@ TEST(GlobalPlanner, DijkstraGradient)
   dlux_test("DijkstraGradient", "dlux_plugins::Dijkstra", "dlux_plugins::GradientPath");
 }
 
+TEST(GlobalPlanner, DijkstraQuantizedGradient)
+{
+  ros::NodeHandle nh("~/DijkstraQuantizedGradient");
+  nh.setParam("quantize_potential", true);
+  dlux_test("DijkstraQuantizedGradient", "dlux_plugins::Dijkstra", "dlux_plugins::GradientPath");
+}
+
+TEST(GlobalPlanner, AStarQuantizedGrid)
+{
+  ros::NodeHandle nh("~/AStarQuantizedGrid");
+  nh.setParam("quantize_potential", true);
+  dlux_test("AStarQuantizedGrid", "dlux_plugins::AStar", "dlux_plugins::GridPath");
+}
+
+TEST(GlobalPlanner, FastSweepingGradient)
+{
+  dlux_test("FastSweepingGradient", "dlux_plugins::FastSweeping", "dlux_plugins::GradientPath");
+}
+
+TEST(GlobalPlanner, FastSweepingThreadsGradient)
+{
+  ros::NodeHandle nh("~/FastSweepingThreadsGradient");
+  nh.setParam("num_threads", 4);
+  dlux_test("FastSweepingThreadsGradient", "dlux_plugins::FastSweeping", "dlux_plugins::GradientPath");
+}
+
+/**
+ * @brief Calculate the potential with FastSweeping, using the parameters in the given namespace
+ */
+void fastSweep(const std::string& ns, nav_core2::Costmap::Ptr costmap,
+               dlux_global_planner::CostInterpreter::Ptr cost_interpreter, PotentialGrid& potential_grid,
+               const geometry_msgs::Pose2D& start, const geometry_msgs::Pose2D& goal)
+{
+  ros::NodeHandle nh("~/" + ns);
+  dlux_plugins::FastSweeping fast_sweeping;
+  fast_sweeping.initialize(nh, costmap, cost_interpreter);
+  fast_sweeping.updatePotentials(potential_grid, start, goal);
+}
+
+// Copies of the Costmap constants, so they can be passed by reference
+const unsigned char LETHAL = nav_core2::Costmap::LETHAL_OBSTACLE;
+const unsigned char FREE = nav_core2::Costmap::FREE_SPACE;
+const unsigned int WIDTH = 200, HEIGHT = 150;
+
+/**
+ * @brief Make a WIDTH x HEIGHT costmap with short horizontal walls, so the potential has to bend around obstacles
+ *
+ * @param[out] start Start pose, in cell (5, 5) which is left free
+ * @param[out] goal Goal pose, in cell (185, 135) which is left free
+ */
+nav_core2::Costmap::Ptr makeWallCostmap(geometry_msgs::Pose2D& start, geometry_msgs::Pose2D& goal)
+{
+  nav_core2::Costmap::Ptr costmap = std::make_shared<nav_core2::BasicCostmap>();
+  nav_grid::NavGridInfo info;
+  info.width = WIDTH;
+  info.height = HEIGHT;
+  info.resolution = 0.1;
+  costmap->setInfo(info);
+
+  srand(3);
+  for (unsigned int i = 0; i < 150; i++)
+  {
+    unsigned int x = rand() % (WIDTH - 8), y = rand() % HEIGHT;
+    for (unsigned int dx = 0; dx < 8; dx++)
+    {
+      costmap->setValue(x + dx, y, LETHAL);
+    }
+  }
+  start.x = 0.55;
+  start.y = 0.55;
+  goal.x = 18.55;
+  goal.y = 13.55;
+  costmap->setValue(5, 5, FREE);
+  costmap->setValue(185, 135, FREE);
+  return costmap;
+}
+
+TEST(FastSweeping, matches_single_thread_and_dijkstra)
+{
+  geometry_msgs::Pose2D start, goal;
+  nav_core2::Costmap::Ptr costmap = makeWallCostmap(start, goal);
+  const nav_grid::NavGridInfo& info = costmap->getInfo();
+
+  ros::NodeHandle nh("~/FastSweepingComparison");
+  auto cost_interpreter = std::make_shared<dlux_global_planner::CostInterpreter>();
+  cost_interpreter->initialize(nh, costmap);
+
+  ros::NodeHandle single_nh("~/FastSweepingSingle");
+  single_nh.setParam("tile_size", 16);
+  ros::NodeHandle multi_nh("~/FastSweepingMulti");
+  multi_nh.setParam("tile_size", 16);
+  multi_nh.setParam("num_threads", 4);
+
+  PotentialGrid single(HIGH_POTENTIAL), multi(HIGH_POTENTIAL), dijkstra(HIGH_POTENTIAL);
+  single.setInfo(info);
+  multi.setInfo(info);
+  dijkstra.setInfo(info);
+  fastSweep("FastSweepingSingle", costmap, cost_interpreter, single, start, goal);
+  fastSweep("FastSweepingMulti", costmap, cost_interpreter, multi, start, goal);
+  dlux_plugins::Dijkstra dijkstra_calculator;
+  dijkstra_calculator.initialize(nh, costmap, cost_interpreter);
+  dijkstra_calculator.updatePotentials(dijkstra, start, goal);
+
+  // The threads must not change the result at all, and the fixed point is never above the Dijkstra potential
+  unsigned int different = 0, higher = 0;
+  for (unsigned int y = 0; y < HEIGHT; y++)
+  {
+    for (unsigned int x = 0; x < WIDTH; x++)
+    {
+      if (single(x, y) != multi(x, y)) different++;
+      if (dijkstra(x, y) < HIGH_POTENTIAL && single(x, y) > dijkstra(x, y) * 1.00001) higher++;
+    }
+  }
+  EXPECT_EQ(0u, different);
+  EXPECT_EQ(0u, higher);
+  EXPECT_NEAR(dijkstra(5, 5), single(5, 5), dijkstra(5, 5) * 0.01);
+}
+
+TEST(AStar, jump_point_search_beats_plain)
+{
+  geometry_msgs::Pose2D start, goal;
+  nav_core2::Costmap::Ptr costmap = makeWallCostmap(start, goal);
+  const nav_grid::NavGridInfo& info = costmap->getInfo();
+  // An expensive area, which the jump point search has to expand cell by cell
+  for (unsigned int y = 40; y < 70; y++)
+  {
+    for (unsigned int x = 60; x < 90; x++)
+    {
+      costmap->setValue(x, y, 100);
+    }
+  }
+
+  ros::NodeHandle nh("~/AStarComparison");
+  auto cost_interpreter = std::make_shared<dlux_global_planner::CostInterpreter>();
+  cost_interpreter->initialize(nh, costmap);
+
+  // Without the kernel and with every improvement requeued, plain AStar finds the cheapest path along the grid
+  ros::NodeHandle plain_nh("~/AStarPlain");
+  plain_nh.setParam("use_kernel", false);
+  plain_nh.setParam("minimum_requeue_change", 0.0);
+  dlux_plugins::AStar plain;
+  plain.initialize(plain_nh, costmap, cost_interpreter);
+  ros::NodeHandle jump_point_nh("~/AStarJumpPoint");
+  jump_point_nh.setParam("jump_point_search", true);
+  // Ignored, since it would overestimate the cost of diagonal moves
+  jump_point_nh.setParam("manhattan_heuristic", true);
+  dlux_plugins::AStar jump_point;
+  jump_point.initialize(jump_point_nh, costmap, cost_interpreter);
+
+  PotentialGrid plain_grid(HIGH_POTENTIAL), jump_point_grid(HIGH_POTENTIAL);
+  plain_grid.setInfo(info);
+  jump_point_grid.setInfo(info);
+  unsigned int plain_expanded = plain.updatePotentials(plain_grid, start, goal);
+  unsigned int jump_point_expanded = jump_point.updatePotentials(jump_point_grid, start, goal);
+
+  // The jump point search can also move diagonally, so its path is never more expensive
+  EXPECT_LE(jump_point_grid(5, 5), plain_grid(5, 5) * 1.00001);
+  EXPECT_LT(jump_point_expanded, plain_expanded);
+}
+
+/**
+ * @brief AStar with access to the lengths of the clear runs
+ */
+class ClearRunsAStar : public dlux_plugins::AStar
+{
+public:
+  bool sameClearRuns(const ClearRunsAStar& other) const
+  {
+    for (unsigned int direction = 0; direction < 4; direction++)
+    {
+      if (clear_runs_[direction] != other.clear_runs_[direction]) return false;
+    }
+    return clear_ == other.clear_;
+  }
+};
+
+TEST(AStar, jump_point_search_follows_changes)
+{
+  geometry_msgs::Pose2D start, goal;
+  nav_core2::Costmap::Ptr costmap = makeWallCostmap(start, goal);
+  const nav_grid::NavGridInfo& info = costmap->getInfo();
+
+  ros::NodeHandle nh("~/AStarChanges");
+  nh.setParam("jump_point_search", true);
+  auto cost_interpreter = std::make_shared<dlux_global_planner::CostInterpreter>();
+  cost_interpreter->initialize(nh, costmap);
+  ClearRunsAStar cached;
+  cached.initialize(nh, costmap, cost_interpreter);
+  PotentialGrid cached_grid(HIGH_POTENTIAL), fresh_grid(HIGH_POTENTIAL);
+  cached_grid.setInfo(info);
+  fresh_grid.setInfo(info);
+  cached.updatePotentials(cached_grid, start, goal);
+
+  // After each batch of changes, the cached clear runs must give the same result as ones calculated from scratch
+  for (unsigned int round = 0; round < 10; round++)
+  {
+    unsigned int x0 = 10 + rand() % (WIDTH - 40), y0 = 10 + rand() % (HEIGHT - 40);
+    for (unsigned int i = 0; i < 20; i++)
+    {
+      int r = rand() % 3;
+      unsigned char cost = r == 0 ? FREE : (r == 1 ? LETHAL : 100);
+      costmap->setValue(x0 + rand() % 20, y0 + rand() % 20, cost);
+    }
+    costmap->setValue(5, 5, FREE);
+    costmap->setValue(185, 135, FREE);
+
+    ros::NodeHandle fresh_nh("~/AStarChanges" + std::to_string(round));
+    fresh_nh.setParam("jump_point_search", true);
+    ClearRunsAStar fresh;
+    fresh.initialize(fresh_nh, costmap, cost_interpreter);
+
+    unsigned int cached_expanded = cached.updatePotentials(cached_grid, start, goal);
+    unsigned int fresh_expanded = fresh.updatePotentials(fresh_grid, start, goal);
+    EXPECT_TRUE(cached.sameClearRuns(fresh));
+    EXPECT_EQ(fresh_expanded, cached_expanded);
+    unsigned int different = 0;
+    for (unsigned int y = 0; y < HEIGHT; y++)
+    {
+      for (unsigned int x = 0; x < WIDTH; x++)
+      {
+        if (cached_grid(x, y) != fresh_grid(x, y)) different++;
+      }
+    }
+    EXPECT_EQ(0u, different);
+  }
+}
+
 int main(int argc, char **argv)
 {
   ros::init(argc, argv, "planner_tests");
@@ -36,6 +36,7 @@
 #define DWB_CRITICS_ALIGNMENT_UTIL_H
 
 #include <geometry_msgs/Pose2D.h>
+#include <nav_2d_utils/trig_pose.h>
 
 namespace dwb_critics
 {
@@ -49,6 +50,14 @@ namespace dwb_critics
  */
 geometry_msgs::Pose2D getForwardPose(const geometry_msgs::Pose2D& pose, double distance);
 
+/**
+ * @brief Projects the given pose forward the specified distance, using its precomputed cosine/sine
+ */
+inline geometry_msgs::Pose2D getForwardPose(const nav_2d_utils::TrigPose2D& pose, double distance)
+{
+  return pose.forward(distance);
+}
+
 }  // namespace dwb_critics
 
 #endif  // DWB_CRITICS_ALIGNMENT_UTIL_H
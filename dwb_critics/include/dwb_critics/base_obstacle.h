@@ -55,15 +55,29 @@ class BaseObstacleCritic : public dwb_local_planner::TrajectoryCritic
 public:
   void onInit() override;
   double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) override;
+  dwb_local_planner::CriticResult checkTrajectory(const dwb_msgs::Trajectory2D& traj) override;
   void addCriticVisualization(sensor_msgs::PointCloud& pc) override;
 
   /**
-   * @brief Return the obstacle score for a particular pose
+   * @brief Return the obstacle score for a particular pose, throwing if the pose is illegal
+   *
+   * The default implementation is throwIfIllegal(checkPose(costmap, pose)).
    * @param costmap Dereferenced costmap
    * @param pose Pose to check
    */
   virtual double scorePose(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose);
 
+  /**
+   * @brief Return the obstacle score for a particular pose, or the reason it is illegal
+   *
+   * The default implementation checks the pose's cell with checkCell, without throwing. If use_score_pose_ is set,
+   * it calls scorePose instead and converts an IllegalTrajectoryException into the result.
+   * @param costmap Dereferenced costmap
+   * @param pose Pose to check
+   */
+  virtual dwb_local_planner::CriticResult checkPose(const nav_core2::Costmap& costmap,
+                                                    const geometry_msgs::Pose2D& pose);
+
   /**
    * @brief Check to see whether a given cell cost is valid for driving through.
    * @param cost Cost of the cell
@@ -72,7 +86,20 @@ public:
   virtual bool isValidCost(const unsigned char cost);
 
 protected:
+  /**
+   * @brief Return the cost of the pose's cell, or the reason it is illegal (off the grid or not a valid cost)
+   * @param costmap Dereferenced costmap
+   * @param pose Pose to check
+   */
+  dwb_local_planner::CriticResult checkCell(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose);
+
   bool sum_scores_;
+
+  /**
+   * @brief Set to true (e.g. in the constructor) by subclasses that override scorePose but not checkPose,
+   *        so that checkPose uses their scorePose. Such subclasses must not call the default scorePose.
+   */
+  bool use_score_pose_ { false };
 };
 }  // namespace dwb_critics
 
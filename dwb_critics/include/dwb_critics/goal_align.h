@@ -56,7 +56,7 @@ public:
   void onInit() override;
   bool prepare(const geometry_msgs::Pose2D& pose, const nav_2d_msgs::Twist2D& vel,
                const geometry_msgs::Pose2D& goal, const nav_2d_msgs::Path2D& global_plan) override;
-  double scorePose(const geometry_msgs::Pose2D& pose) override;
+  dwb_local_planner::CriticResult checkPose(const geometry_msgs::Pose2D& pose) override;
 protected:
   double forward_point_distance_;
 };
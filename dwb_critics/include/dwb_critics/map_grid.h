@@ -62,17 +62,29 @@ public:
   // Standard TrajectoryCritic Interface
   void onInit() override;
   double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) override;
+  dwb_local_planner::CriticResult checkTrajectory(const dwb_msgs::Trajectory2D& traj) override;
   void addCriticVisualization(sensor_msgs::PointCloud& pc) override;
   double getScale() const override { return costmap_->getResolution() * 0.5 * scale_; }
 
   // Helper Functions
   /**
-   * @brief Retrieve the score for a single pose
+   * @brief Retrieve the score for a single pose, throwing if the pose is off the grid
+   *
+   * The default implementation is throwIfIllegal(checkPose(pose)).
    * @param pose The pose to score, assumed to be in the same frame as the costmap
    * @return The score associated with the cell of the costmap where the pose lies
    */
   virtual double scorePose(const geometry_msgs::Pose2D& pose);
 
+  /**
+   * @brief Retrieve the score for a single pose, or the reason it is illegal
+   *
+   * The default implementation looks up the pose's cell with checkCell, without throwing. If use_score_pose_ is set,
+   * it calls scorePose instead and converts an IllegalTrajectoryException into the result.
+   * @param pose The pose to score, assumed to be in the same frame as the costmap
+   */
+  virtual dwb_local_planner::CriticResult checkPose(const geometry_msgs::Pose2D& pose);
+
   /**
    * @brief Retrieve the score for a particular cell of the costmap
    * @param x x-coordinate within the costmap
@@ -122,11 +134,23 @@ protected:
    */
   void propogateManhattanDistances();
 
+  /**
+   * @brief Return the score of the pose's cell, or the reason it is illegal (off the grid)
+   * @param pose The pose to score, assumed to be in the same frame as the costmap
+   */
+  dwb_local_planner::CriticResult checkCell(const geometry_msgs::Pose2D& pose);
+
   std::shared_ptr<MapGridQueue> queue_;
   nav_grid::VectorNavGrid<double> cell_values_;
   double obstacle_score_, unreachable_score_;  ///< Special cell_values
   bool stop_on_failure_;
   ScoreAggregationType aggregationType_;
+
+  /**
+   * @brief Set to true (e.g. in the constructor) by subclasses that override scorePose but not checkPose,
+   *        so that checkPose uses their scorePose. Such subclasses must not call the default scorePose.
+   */
+  bool use_score_pose_ { false };
 };
 }  // namespace dwb_critics
 
@@ -58,9 +58,20 @@ public:
   void onInit() override;
   bool prepare(const geometry_msgs::Pose2D& pose, const nav_2d_msgs::Twist2D& vel,
                const geometry_msgs::Pose2D& goal, const nav_2d_msgs::Path2D& global_plan) override;
-  double scorePose(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose) override;
-  virtual double scorePose(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose,
-                           const nav_2d_msgs::Polygon2D& oriented_footprint);
+  dwb_local_planner::CriticResult checkPose(const nav_core2::Costmap& costmap,
+                                            const geometry_msgs::Pose2D& pose) override;
+  double scorePose(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose) override
+  {
+    return throwIfIllegal(checkPose(costmap, pose));
+  }
+  double scorePose(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose,
+                   const nav_2d_msgs::Polygon2D& oriented_footprint)
+  {
+    return throwIfIllegal(checkPose(costmap, pose, oriented_footprint));
+  }
+  virtual dwb_local_planner::CriticResult checkPose(const nav_core2::Costmap& costmap,
+                                                    const geometry_msgs::Pose2D& pose,
+                                                    const nav_2d_msgs::Polygon2D& oriented_footprint);
   double getScale() const override { return costmap_->getResolution() * scale_; }
 protected:
   nav_2d_msgs::Polygon2D footprint_spec_;
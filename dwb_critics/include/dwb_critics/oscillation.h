@@ -83,6 +83,10 @@ public:
   bool prepare(const geometry_msgs::Pose2D& pose, const nav_2d_msgs::Twist2D& vel,
                const geometry_msgs::Pose2D& goal, const nav_2d_msgs::Path2D& global_plan) override;
   double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) override;
+  double scoreVelocity(const nav_2d_msgs::Twist2D& twist) override;
+  dwb_local_planner::CriticResult checkTrajectory(const dwb_msgs::Trajectory2D& traj) override;
+  dwb_local_planner::CriticResult checkVelocity(const nav_2d_msgs::Twist2D& twist) override;
+  bool isVelocityOnly() const override { return true; }
   void reset() override;
   void debrief(const nav_2d_msgs::Twist2D& cmd_vel) override;
 
@@ -109,13 +113,13 @@ protected:
      * @param velocity the velocity to evaluate
      * @return true if the sign has flipped more than once
      */
-    bool isOscillating(double velocity);
+    bool isOscillating(double velocity) const;
 
     /**
      * @brief Check whether we are currently tracking a flipped sign
      * @return True if the sign has flipped
      */
-    bool hasSignFlipped();
+    bool hasSignFlipped() const;
 
   protected:
     // Simple Enum for Tracking
@@ -56,6 +56,8 @@ public:
   PreferForwardCritic() : penalty_(1.0), strafe_x_(0.1), strafe_theta_(0.2), theta_scale_(10.0) {}
   void onInit() override;
   double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) override;
+  double scoreVelocity(const nav_2d_msgs::Twist2D& twist) override;
+  bool isVelocityOnly() const override { return true; }
 
 protected:
   double penalty_, strafe_x_, strafe_theta_, theta_scale_;
@@ -76,6 +76,15 @@ public:
                const geometry_msgs::Pose2D& goal, const nav_2d_msgs::Path2D& global_plan) override;
   double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) override;
 
+  /**
+   * @brief Check the velocity-only conditions of the second and third phases
+   * @return The slowing score in the second phase (a lower bound, since it excludes scoreRotation), otherwise 0
+   */
+  double scoreVelocity(const nav_2d_msgs::Twist2D& twist) override;
+
+  dwb_local_planner::CriticResult checkTrajectory(const dwb_msgs::Trajectory2D& traj) override;
+  dwb_local_planner::CriticResult checkVelocity(const nav_2d_msgs::Twist2D& twist) override;
+
   /**
    * @brief Assuming that this is an actual rotation when near the goal, score the trajectory.
    *
@@ -87,6 +96,11 @@ public:
   virtual double scoreRotation(const dwb_msgs::Trajectory2D& traj);
 
 protected:
+  /**
+   * @brief The velocity-only checks of the second and third phases (checkVelocity also saves the result)
+   */
+  dwb_local_planner::CriticResult checkTwist(const nav_2d_msgs::Twist2D& twist) const;
+
   bool in_window_, rotating_;
   double goal_yaw_;
   double xy_goal_tolerance_;
@@ -94,6 +108,11 @@ protected:
   double current_xy_speed_sq_, stopped_xy_velocity_sq_;
   double slowing_factor_;
   double lookahead_time_;
+
+  // Result of the most recent checkVelocity, reused by checkTrajectory for the same twist
+  bool has_velocity_result_;
+  nav_2d_msgs::Twist2D velocity_result_twist_;
+  dwb_local_planner::CriticResult velocity_result_;
 };
 
 }  // namespace dwb_critics
@@ -53,6 +53,8 @@ class TwirlingCritic: public dwb_local_planner::TrajectoryCritic
 public:
   void onInit() override;
   double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) override;
+  double scoreVelocity(const nav_2d_msgs::Twist2D& twist) override;
+  bool isVelocityOnly() const override { return true; }
 };
 }  // namespace dwb_critics
 
@@ -38,10 +38,6 @@ namespace dwb_critics
 {
 geometry_msgs::Pose2D getForwardPose(const geometry_msgs::Pose2D& pose, double distance)
 {
-  geometry_msgs::Pose2D forward_pose;
-  forward_pose.x = pose.x + distance * cos(pose.theta);
-  forward_pose.y = pose.y + distance * sin(pose.theta);
-  forward_pose.theta = pose.theta;
-  return forward_pose;
+  return nav_2d_utils::TrigPose2D(pose).forward(distance);
 }
 }  // namespace dwb_critics
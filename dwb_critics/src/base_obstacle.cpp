@@ -48,27 +48,59 @@ void BaseObstacleCritic::onInit()
 }
 
 double BaseObstacleCritic::scoreTrajectory(const dwb_msgs::Trajectory2D& traj)
+{
+  return throwIfIllegal(checkTrajectory(traj));
+}
+
+dwb_local_planner::CriticResult BaseObstacleCritic::checkTrajectory(const dwb_msgs::Trajectory2D& traj)
 {
   const nav_core2::Costmap& costmap = *costmap_;
   double score = 0.0;
   for (unsigned int i = 0; i < traj.poses.size(); ++i)
   {
-    double pose_score = scorePose(costmap, traj.poses[i]);
+    dwb_local_planner::CriticResult pose_result = checkPose(costmap, traj.poses[i]);
+    if (!pose_result.isLegal())
+    {
+      return pose_result;
+    }
     // Optimized/branchless version of if (sum_scores_) score += pose_score, else score = pose_score;
-    score = static_cast<double>(sum_scores_) * score + pose_score;
+    score = static_cast<double>(sum_scores_) * score + pose_result.score;
+  }
+  return dwb_local_planner::CriticResult(score);
+}
+
+dwb_local_planner::CriticResult BaseObstacleCritic::checkPose(const nav_core2::Costmap& costmap,
+                                                              const geometry_msgs::Pose2D& pose)
+{
+  if (!use_score_pose_)
+  {
+    return checkCell(costmap, pose);
+  }
+  try
+  {
+    return dwb_local_planner::CriticResult(scorePose(costmap, pose));
+  }
+  catch (const nav_core2::IllegalTrajectoryException& e)
+  {
+    return dwb_local_planner::CriticResult::illegal(e.what());
   }
-  return score;
 }
 
 double BaseObstacleCritic::scorePose(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose)
+{
+  return throwIfIllegal(checkPose(costmap, pose));
+}
+
+dwb_local_planner::CriticResult BaseObstacleCritic::checkCell(const nav_core2::Costmap& costmap,
+                                                              const geometry_msgs::Pose2D& pose)
 {
   unsigned int cell_x, cell_y;
   if (!worldToGridBounded(costmap.getInfo(), pose.x, pose.y, cell_x, cell_y))
-    throw nav_core2::IllegalTrajectoryException(name_, "Trajectory Goes Off Grid.");
+    return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::GOES_OFF_GRID);
   unsigned char cost = costmap(cell_x, cell_y);
   if (!isValidCost(cost))
-    throw nav_core2::IllegalTrajectoryException(name_, "Trajectory Hits Obstacle.");
-  return cost;
+    return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::HITS_OBSTACLE);
+  return dwb_local_planner::CriticResult(cost);
 }
 
 bool BaseObstacleCritic::isValidCost(const unsigned char cost)
@@ -66,9 +66,9 @@ bool GoalAlignCritic::prepare(const geometry_msgs::Pose2D& pose, const nav_2d_ms
   return GoalDistCritic::prepare(pose, vel, goal, target_poses);
 }
 
-double GoalAlignCritic::scorePose(const geometry_msgs::Pose2D& pose)
+dwb_local_planner::CriticResult GoalAlignCritic::checkPose(const geometry_msgs::Pose2D& pose)
 {
-  return GoalDistCritic::scorePose(getForwardPose(pose, forward_point_distance_));
+  return GoalDistCritic::checkPose(getForwardPose(getTrigPose(pose), forward_point_distance_));
 }
 
 }  // namespace dwb_critics
@@ -118,6 +118,11 @@ void MapGridCritic::propogateManhattanDistances()
 }
 
 double MapGridCritic::scoreTrajectory(const dwb_msgs::Trajectory2D& traj)
+{
+  return throwIfIllegal(checkTrajectory(traj));
+}
+
+dwb_local_planner::CriticResult MapGridCritic::checkTrajectory(const dwb_msgs::Trajectory2D& traj)
 {
   double score = 0.0;
   unsigned int start_index = 0;
@@ -133,16 +138,21 @@ double MapGridCritic::scoreTrajectory(const dwb_msgs::Trajectory2D& traj)
 
   for (unsigned int i = start_index; i < traj.poses.size(); ++i)
   {
-    grid_dist = scorePose(traj.poses[i]);
+    dwb_local_planner::CriticResult pose_result = checkPose(traj.poses[i]);
+    if (!pose_result.isLegal())
+    {
+      return pose_result;
+    }
+    grid_dist = pose_result.score;
     if (stop_on_failure_)
     {
       if (grid_dist == obstacle_score_)
       {
-        throw nav_core2::IllegalTrajectoryException(name_, "Trajectory Hits Obstacle.");
+        return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::HITS_OBSTACLE);
       }
       else if (grid_dist == unreachable_score_)
       {
-        throw nav_core2::IllegalTrajectoryException(name_, "Trajectory Hits Unreachable Area.");
+        return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::HITS_UNREACHABLE_AREA);
       }
     }
 
@@ -163,18 +173,39 @@ double MapGridCritic::scoreTrajectory(const dwb_msgs::Trajectory2D& traj)
     }
   }
 
-  return score;
+  return dwb_local_planner::CriticResult(score);
+}
+
+dwb_local_planner::CriticResult MapGridCritic::checkPose(const geometry_msgs::Pose2D& pose)
+{
+  if (!use_score_pose_)
+  {
+    return checkCell(pose);
+  }
+  try
+  {
+    return dwb_local_planner::CriticResult(scorePose(pose));
+  }
+  catch (const nav_core2::IllegalTrajectoryException& e)
+  {
+    return dwb_local_planner::CriticResult::illegal(e.what());
+  }
 }
 
 double MapGridCritic::scorePose(const geometry_msgs::Pose2D& pose)
+{
+  return throwIfIllegal(checkPose(pose));
+}
+
+dwb_local_planner::CriticResult MapGridCritic::checkCell(const geometry_msgs::Pose2D& pose)
 {
   unsigned int cell_x, cell_y;
   // we won't allow trajectories that go off the map... shouldn't happen that often anyways
   if (!worldToGridBounded(costmap_->getInfo(), pose.x, pose.y, cell_x, cell_y))
   {
-    throw nav_core2::IllegalTrajectoryException(name_, "Trajectory Goes Off Grid.");
+    return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::GOES_OFF_GRID);
   }
-  return getScore(cell_x, cell_y);
+  return dwb_local_planner::CriticResult(getScore(cell_x, cell_y));
 }
 
 void MapGridCritic::addCriticVisualization(sensor_msgs::PointCloud& pc)
@@ -37,7 +37,6 @@
 #include <nav_grid_iterators/polygon_outline.h>
 #include <nav_2d_utils/polygons.h>
 #include <nav_2d_utils/footprint.h>
-#include <nav_core2/exceptions.h>
 #include <pluginlib/class_list_macros.h>
 #include <algorithm>
 #include <vector>
@@ -64,16 +63,18 @@ bool ObstacleFootprintCritic::prepare(const geometry_msgs::Pose2D& pose, const n
   return true;
 }
 
-double ObstacleFootprintCritic::scorePose(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose)
+dwb_local_planner::CriticResult ObstacleFootprintCritic::checkPose(const nav_core2::Costmap& costmap,
+                                                                   const geometry_msgs::Pose2D& pose)
 {
   unsigned int cell_x, cell_y;
   if (!worldToGridBounded(costmap.getInfo(), pose.x, pose.y, cell_x, cell_y))
-    throw nav_core2::IllegalTrajectoryException(name_, "Trajectory Goes Off Grid.");
-  return scorePose(costmap, pose, nav_2d_utils::movePolygonToPose(footprint_spec_, pose));
+    return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::GOES_OFF_GRID);
+  return checkPose(costmap, pose, nav_2d_utils::movePolygonToPose(footprint_spec_, getTrigPose(pose)));
 }
 
-double ObstacleFootprintCritic::scorePose(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose,
-                                          const nav_2d_msgs::Polygon2D& footprint)
+dwb_local_planner::CriticResult ObstacleFootprintCritic::checkPose(const nav_core2::Costmap& costmap,
+                                                                   const geometry_msgs::Pose2D& pose,
+                                                                   const nav_2d_msgs::Polygon2D& footprint)
 {
   unsigned char footprint_cost = 0;
   nav_grid::NavGridInfo info = costmap.getInfo();
@@ -83,17 +84,17 @@ double ObstacleFootprintCritic::scorePose(const nav_core2::Costmap& costmap, con
     // if the cell is in an obstacle the path is invalid or unknown
     if (cost == costmap.LETHAL_OBSTACLE)
     {
-      throw nav_core2::IllegalTrajectoryException(name_, "Trajectory Hits Obstacle.");
+      return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::HITS_OBSTACLE);
     }
     else if (cost == costmap.NO_INFORMATION)
     {
-      throw nav_core2::IllegalTrajectoryException(name_, "Trajectory Hits Unknown Region.");
+      return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::HITS_UNKNOWN_REGION);
     }
     footprint_cost = std::max(cost, footprint_cost);
   }
 
   // if all line costs are legal... then we can return that the footprint is legal
-  return footprint_cost;
+  return dwb_local_planner::CriticResult(footprint_cost);
 }
 
 }  // namespace dwb_critics
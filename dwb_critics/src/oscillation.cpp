@@ -34,7 +34,6 @@
 
 #include <nav_2d_utils/parameters.h>
 #include <dwb_critics/oscillation.h>
-#include <nav_core2/exceptions.h>
 #include <pluginlib/class_list_macros.h>
 #include <cmath>
 #include <string>
@@ -81,12 +80,12 @@ bool OscillationCritic::CommandTrend::update(double velocity)
   return flag_set;
 }
 
-bool OscillationCritic::CommandTrend::isOscillating(double velocity)
+bool OscillationCritic::CommandTrend::isOscillating(double velocity) const
 {
   return (positive_only_ && velocity < 0.0) || (negative_only_ && velocity > 0.0);
 }
 
-bool OscillationCritic::CommandTrend::hasSignFlipped()
+bool OscillationCritic::CommandTrend::hasSignFlipped() const
 {
   return positive_only_ || negative_only_;
 }
@@ -211,13 +210,28 @@ bool OscillationCritic::setOscillationFlags(const nav_2d_msgs::Twist2D& cmd_vel)
 
 double OscillationCritic::scoreTrajectory(const dwb_msgs::Trajectory2D& traj)
 {
-  if (x_trend_.isOscillating(traj.velocity.x) ||
-      y_trend_.isOscillating(traj.velocity.y) ||
-      theta_trend_.isOscillating(traj.velocity.theta))
+  return scoreVelocity(traj.velocity);
+}
+
+double OscillationCritic::scoreVelocity(const nav_2d_msgs::Twist2D& twist)
+{
+  return throwIfIllegal(checkVelocity(twist));
+}
+
+dwb_local_planner::CriticResult OscillationCritic::checkTrajectory(const dwb_msgs::Trajectory2D& traj)
+{
+  return checkVelocity(traj.velocity);
+}
+
+dwb_local_planner::CriticResult OscillationCritic::checkVelocity(const nav_2d_msgs::Twist2D& twist)
+{
+  if (x_trend_.isOscillating(twist.x) ||
+      y_trend_.isOscillating(twist.y) ||
+      theta_trend_.isOscillating(twist.theta))
   {
-    throw nav_core2::IllegalTrajectoryException(name_, "Trajectory is oscillating.");
+    return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::OSCILLATING);
   }
-  return 0.0;
+  return dwb_local_planner::CriticResult(0.0);
 }
 
 }  // namespace dwb_critics
@@ -77,9 +77,9 @@ double PathAlignCritic::getScale() const
     return costmap_->getResolution() * 0.5 * scale_;
 }
 
-double PathAlignCritic::scorePose(const geometry_msgs::Pose2D& pose)
+dwb_local_planner::CriticResult PathAlignCritic::checkPose(const geometry_msgs::Pose2D& pose)
 {
-  return PathDistCritic::scorePose(getForwardPose(pose, forward_point_distance_));
+  return PathDistCritic::checkPose(getForwardPose(getTrigPose(pose), forward_point_distance_));
 }
 
 }  // namespace dwb_critics
@@ -67,6 +67,7 @@ void RotateToGoalCritic::reset()
 {
   in_window_ = false;
   rotating_ = false;
+  has_velocity_result_ = false;
 }
 
 bool RotateToGoalCritic::prepare(const geometry_msgs::Pose2D& pose, const nav_2d_msgs::Twist2D& vel,
@@ -78,33 +79,81 @@ bool RotateToGoalCritic::prepare(const geometry_msgs::Pose2D& pose, const nav_2d
   current_xy_speed_sq_ = hypot_sq(vel.x, vel.y);
   rotating_ = rotating_ || (in_window_ && current_xy_speed_sq_ <= stopped_xy_velocity_sq_);
   goal_yaw_ = goal.theta;
+  has_velocity_result_ = false;
   return true;
 }
 
 double RotateToGoalCritic::scoreTrajectory(const dwb_msgs::Trajectory2D& traj)
+{
+  return throwIfIllegal(checkTrajectory(traj));
+}
+
+double RotateToGoalCritic::scoreVelocity(const nav_2d_msgs::Twist2D& twist)
+{
+  return throwIfIllegal(checkVelocity(twist));
+}
+
+dwb_local_planner::CriticResult RotateToGoalCritic::checkTrajectory(const dwb_msgs::Trajectory2D& traj)
 {
   // If we're not sufficiently close to the goal, we don't care what the twist is
   if (!in_window_)
   {
-    return 0.0;
+    return dwb_local_planner::CriticResult(0.0);
+  }
+  // The planner checks each twist right before its trajectory, so the velocity result can usually be reused
+  const nav_2d_msgs::Twist2D& twist = traj.velocity;
+  dwb_local_planner::CriticResult result;
+  if (has_velocity_result_ && twist.x == velocity_result_twist_.x && twist.y == velocity_result_twist_.y &&
+      twist.theta == velocity_result_twist_.theta)
+  {
+    result = velocity_result_;
+  }
+  else
+  {
+    result = checkTwist(twist);
+  }
+  if (!result.isLegal())
+  {
+    return result;
+  }
+  if (traj.poses.empty())
+  {
+    return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::EMPTY_TRAJECTORY);
+  }
+  result.score += scoreRotation(traj);
+  return result;
+}
+
+dwb_local_planner::CriticResult RotateToGoalCritic::checkVelocity(const nav_2d_msgs::Twist2D& twist)
+{
+  velocity_result_ = checkTwist(twist);
+  velocity_result_twist_ = twist;
+  has_velocity_result_ = true;
+  return velocity_result_;
+}
+
+dwb_local_planner::CriticResult RotateToGoalCritic::checkTwist(const nav_2d_msgs::Twist2D& twist) const
+{
+  if (!in_window_)
+  {
+    return dwb_local_planner::CriticResult(0.0);
   }
   else if (!rotating_)
   {
-    double speed_sq = hypot_sq(traj.velocity.x, traj.velocity.y);
+    double speed_sq = hypot_sq(twist.x, twist.y);
     if (speed_sq >= current_xy_speed_sq_)
     {
-      throw nav_core2::IllegalTrajectoryException(name_, "Not slowing down near goal.");
+      return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::NOT_SLOWING_NEAR_GOAL);
     }
-    return speed_sq * slowing_factor_ + scoreRotation(traj);
+    return dwb_local_planner::CriticResult(speed_sq * slowing_factor_);
   }
 
   // If we're sufficiently close to the goal, any transforming velocity is invalid
-  if (fabs(traj.velocity.x) > EPSILON || fabs(traj.velocity.y) > EPSILON)
+  if (fabs(twist.x) > EPSILON || fabs(twist.y) > EPSILON)
   {
-    throw nav_core2::IllegalTrajectoryException(name_, "Nonrotation command near goal.");
+    return dwb_local_planner::CriticResult::illegal(dwb_local_planner::IllegalReason::NONROTATION_NEAR_GOAL);
   }
-
-  return scoreRotation(traj);
+  return dwb_local_planner::CriticResult(0.0);
 }
 
 double RotateToGoalCritic::scoreRotation(const dwb_msgs::Trajectory2D& traj)
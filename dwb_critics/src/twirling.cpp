@@ -48,7 +48,12 @@ void TwirlingCritic::onInit()
 
 double TwirlingCritic::scoreTrajectory(const dwb_msgs::Trajectory2D& traj)
 {
-  return fabs(traj.velocity.theta);  // add cost for making the robot spin
+  return scoreVelocity(traj.velocity);
+}
+
+double TwirlingCritic::scoreVelocity(const nav_2d_msgs::Twist2D& twist)
+{
+  return fabs(twist.theta);  // add cost for making the robot spin
 }
 }  // namespace dwb_critics
 
@@ -0,0 +1,132 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DWB_LOCAL_PLANNER_CRITIC_RESULT_H
+#define DWB_LOCAL_PLANNER_CRITIC_RESULT_H
+
+#include <string>
+
+namespace dwb_local_planner
+{
+/**
+ * @brief Interned reasons for a critic to reject a trajectory, so that rejecting one does not need a string
+ *
+ * OTHER is used for any other reason, in which case the description is stored in the CriticResult.
+ */
+enum class IllegalReason : unsigned char
+{
+  LEGAL = 0,
+  HITS_OBSTACLE,
+  HITS_UNREACHABLE_AREA,
+  HITS_UNKNOWN_REGION,
+  GOES_OFF_GRID,
+  OSCILLATING,
+  NOT_SLOWING_NEAR_GOAL,
+  NONROTATION_NEAR_GOAL,
+  EMPTY_TRAJECTORY,
+  DRIVES_INTO_OBSTACLE,
+  OTHER,
+  NUM_REASONS
+};
+
+/**
+ * @brief The description of an interned reason (the same string the critics used for their exceptions)
+ */
+inline const char* getIllegalReasonDescription(IllegalReason reason)
+{
+  switch (reason)
+  {
+  case IllegalReason::LEGAL:
+    return "Legal Trajectory.";
+  case IllegalReason::HITS_OBSTACLE:
+    return "Trajectory Hits Obstacle.";
+  case IllegalReason::HITS_UNREACHABLE_AREA:
+    return "Trajectory Hits Unreachable Area.";
+  case IllegalReason::HITS_UNKNOWN_REGION:
+    return "Trajectory Hits Unknown Region.";
+  case IllegalReason::GOES_OFF_GRID:
+    return "Trajectory Goes Off Grid.";
+  case IllegalReason::OSCILLATING:
+    return "Trajectory is oscillating.";
+  case IllegalReason::NOT_SLOWING_NEAR_GOAL:
+    return "Not slowing down near goal.";
+  case IllegalReason::NONROTATION_NEAR_GOAL:
+    return "Nonrotation command near goal.";
+  case IllegalReason::EMPTY_TRAJECTORY:
+    return "Empty trajectory.";
+  case IllegalReason::DRIVES_INTO_OBSTACLE:
+    return "Twist Drives Into Obstacle.";
+  default:
+    return "Illegal Trajectory.";
+  }
+}
+
+/**
+ * @class CriticResult
+ * @brief The raw score a critic gives a trajectory, or the reason it is illegal
+ */
+struct CriticResult
+{
+  explicit CriticResult(double score = 0.0) : score(score), reason(IllegalReason::LEGAL) {}
+
+  static CriticResult illegal(IllegalReason reason)
+  {
+    CriticResult result;
+    result.reason = reason;
+    return result;
+  }
+
+  static CriticResult illegal(const std::string& description)
+  {
+    CriticResult result = illegal(IllegalReason::OTHER);
+    result.description = description;
+    return result;
+  }
+
+  bool isLegal() const { return reason == IllegalReason::LEGAL; }
+
+  std::string getDescription() const
+  {
+    if (reason == IllegalReason::OTHER) return description;
+    return getIllegalReasonDescription(reason);
+  }
+
+  double score;
+  IllegalReason reason;
+  std::string description;  ///< Only used when reason is OTHER
+};
+
+}  // namespace dwb_local_planner
+
+#endif  // DWB_LOCAL_PLANNER_CRITIC_RESULT_H
@@ -39,6 +39,7 @@
 #include <dwb_local_planner/goal_checker.h>
 #include <dwb_local_planner/trajectory_critic.h>
 #include <dwb_local_planner/publisher.h>
+#include <dwb_local_planner/velocity_precheck.h>
 #include <nav_core2/local_planner.h>
 #include <pluginlib/class_loader.h>
 #include <string>
@@ -70,6 +71,14 @@ public:
   void initialize(const ros::NodeHandle& parent, const std::string& name,
                   TFListenerPtr tf, nav_core2::Costmap::Ptr costmap) override;
 
+  /**
+   * @brief nav_core2 setTransformCache - Use a shared TransformCache (cleared by the caller each cycle)
+   *
+   * Without one, the planner uses its own cache, which is cleared at the start of each call.
+   * @param cache The shared cache
+   */
+  void setTransformCache(nav_core2::TransformCache::Ptr cache) override;
+
   /**
    * @brief nav_core2 setGoalPose - Sets the global goal pose
    * @param goal_pose The Goal Pose
@@ -97,6 +106,17 @@ public:
   nav_2d_msgs::Twist2DStamped computeVelocityCommands(const nav_2d_msgs::Pose2DStamped& pose,
                                                       const nav_2d_msgs::Twist2D& velocity) override;
 
+  /**
+   * @brief nav_core2 warmUp - Transform the plan and prepare the critics, as for computeVelocityCommands
+   *
+   * Unlike computeVelocityCommands, the costmap is not updated (even if update_costmap_before_planning is set)
+   * and nothing is published.
+   *
+   * @param pose Current robot pose
+   * @param velocity Current robot velocity
+   */
+  void warmUp(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity) override;
+
   /**
    * @brief nav_core2 isGoalReached - Check whether the robot has reached its goal, given the current pose & velocity.
    *
@@ -147,6 +167,12 @@ protected:
    */
   virtual void prepare(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity);
 
+  /**
+   * @brief The part of prepare that runs after the costmap is updated
+   * @param publish If true, the transformed plan and input parameters are published
+   */
+  void prepareCritics(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity, bool publish);
+
   /**
    * @brief Iterate through all the twists and find the best one
    */
@@ -154,6 +180,31 @@ protected:
                                                          const nav_2d_msgs::Twist2D velocity,
                                                          std::shared_ptr<dwb_msgs::LocalPlanEvaluation>& results);
 
+  /**
+   * @brief Score a twist with each critic's checkVelocity, before its trajectory is generated
+   *
+   * Since scores only go up, the total is a lower bound on the score of the twist's trajectory.
+   *
+   * @param twist The command velocity
+   * @param velocity_scores Output: the raw velocity score for each critic (in the same order as critics_)
+   * @param critic_index Output: if the twist is illegal, the index of the critic that rejected it
+   * @return The scaled sum of the velocity scores, or the result of the critic that rejected the twist
+   */
+  CriticResult scoreVelocity(const nav_2d_msgs::Twist2D& twist, std::vector<double>& velocity_scores,
+                             unsigned int& critic_index);
+
+  /**
+   * @brief Score a trajectory with each critic's checkTrajectory, reusing the velocity scores for the critics
+   *        that are velocity-only
+   * @param velocity_scores Output of scoreVelocity for the trajectory's twist. If empty, all critics are called.
+   * @param score Output: the full scoring of the trajectory (only valid if the result is legal)
+   * @param critic_index Output: if the trajectory is illegal, the index of the critic that rejected it
+   * @return The total score, or the result of the critic that rejected the trajectory
+   */
+  CriticResult scoreTrajectoryWithVelocityScores(const dwb_msgs::Trajectory2D& traj, double best_score,
+                                                 const std::vector<double>& velocity_scores,
+                                                 dwb_msgs::TrajectoryScore& score, unsigned int& critic_index);
+
   /**
    * @brief Transforms global plan into same frame as pose, clips far away poses and possibly prunes passed poses
    *
@@ -189,6 +240,9 @@ protected:
   bool debug_trajectory_details_;
   bool short_circuit_trajectory_evaluation_;
 
+  bool precheck_velocities_;  ///< If true, skip twists that the precheck shows would drive into obstacles
+  VelocityPrecheck precheck_;
+
   // Plugin handling
   pluginlib::ClassLoader<TrajectoryGenerator> traj_gen_loader_;
   TrajectoryGenerator::Ptr traj_generator_;
@@ -196,6 +250,10 @@ protected:
   GoalChecker::Ptr goal_checker_;
   pluginlib::ClassLoader<TrajectoryCritic> critic_loader_;
   std::vector<TrajectoryCritic::Ptr> critics_;
+  TrigPoseCache::Ptr trig_cache_;  ///< Shared by all the critics
+
+  // Names of the critics followed by the precheck's name, for tracking illegal trajectories by index
+  std::shared_ptr<std::vector<std::string>> critic_names_;
 
   /**
    * @brief try to resolve a possibly shortened critic name with the default namespaces and the suffix "Critic"
@@ -216,6 +274,8 @@ protected:
   nav_core2::Costmap::Ptr costmap_;
   bool update_costmap_before_planning_;
   TFListenerPtr tf_;
+  nav_core2::TransformCache::Ptr tf_cache_;
+  bool owns_tf_cache_;  // True if tf_cache_ is not shared, in which case it is cleared by this class
   DWBPublisher pub_;
 
   ros::NodeHandle planner_nh_;
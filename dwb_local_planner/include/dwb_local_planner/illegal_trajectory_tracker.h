@@ -35,10 +35,13 @@
 #ifndef DWB_LOCAL_PLANNER_ILLEGAL_TRAJECTORY_TRACKER_H
 #define DWB_LOCAL_PLANNER_ILLEGAL_TRAJECTORY_TRACKER_H
 
+#include <dwb_local_planner/critic_result.h>
 #include <nav_core2/exceptions.h>
 #include <map>
+#include <memory>
 #include <utility>
 #include <string>
+#include <vector>
 
 namespace dwb_local_planner
 {
@@ -47,14 +50,37 @@ class IllegalTrajectoryTracker
 public:
   IllegalTrajectoryTracker() : legal_count_(0), illegal_count_(0) {}
 
+  /**
+   * @brief Constructor for tracking illegal trajectories by critic index
+   * @param critic_names The names of the critics, as indexed in addIllegalTrajectory
+   */
+  explicit IllegalTrajectoryTracker(std::shared_ptr<const std::vector<std::string>> critic_names);
+
   void addIllegalTrajectory(const nav_core2::IllegalTrajectoryException& e);
+  void addIllegalTrajectory(const std::string& critic_name, const std::string& reason);
+
+  /**
+   * @brief Count an illegal trajectory. Interned reasons are counted in a flat array, without any strings.
+   * @param critic_index Index of the critic (in the names given to the constructor) that rejected the trajectory.
+   *                     Critics without a name are reported by their index.
+   * @param result The illegal result
+   */
+  void addIllegalTrajectory(unsigned int critic_index, const CriticResult& result);
   void addLegalTrajectory();
 
   std::map< std::pair<std::string, std::string>, double> getPercentages() const;
 
   std::string getMessage() const;
 protected:
+  /**
+   * @brief The name of the critic with the given index, or the index itself if the name is not known
+   */
+  std::string getCriticName(unsigned int critic_index) const;
+
   std::map< std::pair<std::string, std::string>, unsigned int> counts_;
+  std::shared_ptr<const std::vector<std::string>> critic_names_;
+  // Count for each critic index and interned reason, indexed by critic_index * NUM_REASONS + reason
+  std::vector<unsigned int> reason_counts_;
   unsigned int legal_count_, illegal_count_;
 };
 
@@ -36,6 +36,9 @@
 #define DWB_LOCAL_PLANNER_TRAJECTORY_CRITIC_H
 
 #include <ros/ros.h>
+#include <dwb_local_planner/critic_result.h>
+#include <dwb_local_planner/trig_pose_cache.h>
+#include <nav_core2/exceptions.h>
 #include <nav_core2/common.h>
 #include <nav_core2/costmap.h>
 #include <geometry_msgs/Pose2D.h>
@@ -63,10 +66,17 @@ namespace dwb_local_planner
  *       It is presumed that there are multiple trajectories that we want to evaluate,
  *       and there may be some shared work that can be done beforehand to optimize
  *       the scoring of each individual trajectory.
- *  3) scoreTrajectory is called once per trajectory and returns the score.
+ *  3) checkVelocity is called once per twist, before its trajectory is generated, and returns a lower bound
+ *       on the score. checkTrajectory is then called once per trajectory (unless the critic is velocity-only
+ *       or the trajectory is pruned) and returns the score.
  *  4) debrief is called after each set of trajectories with the chosen trajectory.
  *       This can be used for stateful critics that monitor the trajectory through time.
  *
+ *  The planner only calls the non-throwing checkVelocity/checkTrajectory methods, which report illegal
+ *  trajectories with an interned IllegalReason. By default, they wrap scoreVelocity/scoreTrajectory, which
+ *  report illegal trajectories by throwing IllegalTrajectoryException. Critics that reject many trajectories
+ *  should override the check methods and implement the score methods with throwIfIllegal.
+ *
  *  Optionally, there is also a debugging mechanism for certain types of critics in the
  *  addCriticVisualization method. If the score for a trajectory depends on its relationship to
  *  the costmap, addCriticVisualization can provide that information to the dwb_local_planner
@@ -134,6 +144,60 @@ public:
    */
   virtual double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) = 0;
 
+  /**
+   * @brief Return a lower bound on the raw score of any trajectory with the given command velocity
+   *
+   * This is called before the trajectory is generated, so that twists that cannot beat the best
+   * score so far (or are invalid regardless of the trajectory) are never simulated.
+   * May throw IllegalTrajectoryException if every trajectory with this twist is invalid.
+   *
+   * If isVelocityOnly is true, this should return the exact score, and scoreTrajectory will not be called
+   * by the planner.
+   */
+  virtual double scoreVelocity(const nav_2d_msgs::Twist2D& twist)
+  {
+    return 0.0;
+  }
+
+  /**
+   * @brief True if the score only depends on the command velocity, i.e. scoreVelocity is the full score
+   */
+  virtual bool isVelocityOnly() const { return false; }
+
+  /**
+   * @brief Score the given trajectory without throwing if it is illegal
+   *
+   * The default implementation calls scoreTrajectory and converts an IllegalTrajectoryException into the result.
+   */
+  virtual CriticResult checkTrajectory(const dwb_msgs::Trajectory2D& traj)
+  {
+    try
+    {
+      return CriticResult(scoreTrajectory(traj));
+    }
+    catch (const nav_core2::IllegalTrajectoryException& e)
+    {
+      return CriticResult::illegal(e.what());
+    }
+  }
+
+  /**
+   * @brief Score the given command velocity without throwing if it is illegal. See scoreVelocity.
+   *
+   * The default implementation calls scoreVelocity and converts an IllegalTrajectoryException into the result.
+   */
+  virtual CriticResult checkVelocity(const nav_2d_msgs::Twist2D& twist)
+  {
+    try
+    {
+      return CriticResult(scoreVelocity(twist));
+    }
+    catch (const nav_core2::IllegalTrajectoryException& e)
+    {
+      return CriticResult::illegal(e.what());
+    }
+  }
+
   /**
    * @brief debrief informs the critic what the chosen cmd_vel was (if it cares)
    */
@@ -164,11 +228,41 @@ public:
 
   virtual double getScale() const { return scale_; }
   void setScale(const double scale) { scale_ = scale; }
+
+  /**
+   * @brief Share the cosine/sine of the poses in each trajectory with the other critics (set by the planner)
+   */
+  void setTrigPoseCache(TrigPoseCache::Ptr cache) { trig_cache_ = cache; }
 protected:
+  /**
+   * @brief Get the pose along with the cosine/sine of its heading
+   *
+   * If the pose is part of the trajectory the planner is currently scoring, the trig values are only computed once
+   * for all the critics.
+   */
+  nav_2d_utils::TrigPose2D getTrigPose(const geometry_msgs::Pose2D& pose)
+  {
+    if (trig_cache_) return trig_cache_->get(pose);
+    return nav_2d_utils::TrigPose2D(pose);
+  }
+
+  /**
+   * @brief Return the score of a legal result, or throw the IllegalTrajectoryException for an illegal one
+   */
+  double throwIfIllegal(const CriticResult& result) const
+  {
+    if (!result.isLegal())
+    {
+      throw nav_core2::IllegalTrajectoryException(name_, result.getDescription());
+    }
+    return result.score;
+  }
+
   std::string name_;
   nav_core2::Costmap::Ptr costmap_;
   double scale_;
   ros::NodeHandle critic_nh_, planner_nh_;
+  TrigPoseCache::Ptr trig_cache_;
 };
 
 }  // namespace dwb_local_planner
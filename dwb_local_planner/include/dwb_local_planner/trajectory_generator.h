@@ -115,6 +115,9 @@ public:
 
   /**
    * @brief Given a cmd_vel in the robot's frame and initial conditions, generate a Trajectory2D
+   *
+   * Any state that must be consistent for all the trajectories of one iteration (e.g. the kinematic limits)
+   * is taken from the latest call to startNewIteration.
    * @param start_pose Current robot location
    * @param start_vel Current robot velocity
    * @param cmd_vel The desired command velocity
@@ -46,8 +46,8 @@ namespace dwb_local_planner
  * @param time_offset The desired time_offset
  * @return reference to the pose that is closest to the particular time offset
  *
- * Linearly searches through the poses. Once the poses time_offset is greater than the desired time_offset,
- * the search ends, since the poses have increasing time_offsets.
+ * If the poses have a constant time step, the pose is found in constant time. Otherwise, the poses are
+ * binary searched, since they have increasing time_offsets.
  */
 const geometry_msgs::Pose2D& getClosestPose(const dwb_msgs::Trajectory2D& trajectory, const double time_offset);
 
@@ -0,0 +1,104 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DWB_LOCAL_PLANNER_TRIG_POSE_CACHE_H
+#define DWB_LOCAL_PLANNER_TRIG_POSE_CACHE_H
+
+#include <dwb_msgs/Trajectory2D.h>
+#include <nav_2d_utils/trig_pose.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace dwb_local_planner
+{
+/**
+ * @class TrigPoseCache
+ * @brief Shares the cosine/sine of each pose in the trajectory currently being scored between all the critics
+ *
+ * The planner calls setTrajectory before scoring each trajectory and clear afterwards. Each pose's
+ * TrigPose2D is computed the first time any critic asks for it. Poses that are not part of the current
+ * trajectory (i.e. when a critic is called directly) are computed on the spot.
+ */
+class TrigPoseCache
+{
+public:
+  using Ptr = std::shared_ptr<TrigPoseCache>;
+
+  TrigPoseCache() : trajectory_(nullptr) {}
+
+  void setTrajectory(const dwb_msgs::Trajectory2D& trajectory)
+  {
+    trajectory_ = &trajectory;
+    poses_.resize(trajectory.poses.size());
+    computed_.assign(trajectory.poses.size(), false);
+  }
+
+  void clear()
+  {
+    trajectory_ = nullptr;
+  }
+
+  /**
+   * @brief Get the TrigPose2D for the given pose, which should be a reference to a pose in the trajectory
+   */
+  nav_2d_utils::TrigPose2D get(const geometry_msgs::Pose2D& pose)
+  {
+    if (!trajectory_ || trajectory_->poses.empty())
+    {
+      return nav_2d_utils::TrigPose2D(pose);
+    }
+    const geometry_msgs::Pose2D* first = &trajectory_->poses[0];
+    std::less<const geometry_msgs::Pose2D*> before;
+    if (before(&pose, first) || !before(&pose, first + trajectory_->poses.size()))
+    {
+      return nav_2d_utils::TrigPose2D(pose);
+    }
+    unsigned int index = &pose - first;
+    if (!computed_[index])
+    {
+      poses_[index] = nav_2d_utils::TrigPose2D(pose);
+      computed_[index] = true;
+    }
+    return poses_[index];
+  }
+
+protected:
+  const dwb_msgs::Trajectory2D* trajectory_;
+  std::vector<nav_2d_utils::TrigPose2D> poses_;
+  std::vector<bool> computed_;
+};
+}  // namespace dwb_local_planner
+
+#endif  // DWB_LOCAL_PLANNER_TRIG_POSE_CACHE_H
@@ -0,0 +1,136 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DWB_LOCAL_PLANNER_VELOCITY_PRECHECK_H
+#define DWB_LOCAL_PLANNER_VELOCITY_PRECHECK_H
+
+#include <ros/ros.h>
+#include <nav_core2/costmap.h>
+#include <nav_2d_msgs/Twist2D.h>
+#include <geometry_msgs/Pose2D.h>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace dwb_local_planner
+{
+/**
+ * @class VelocityPrecheck
+ * @brief Cheap filter for twists that would obviously drive into an obstacle, run before generating trajectories
+ *
+ * Each twist with linear speed v and rotational speed w follows an arc with curvature w / v, starting in the
+ * direction of its linear velocity. For each (direction, curvature) pair (rounded to the configured resolutions),
+ * the arc is walked through the costmap once per iteration to find the distance to the first cell that the
+ * obstacle critics would reject. A twist is inadmissible if it travels farther than that distance
+ * (minus a margin) in the precheck time.
+ *
+ * This is a heuristic, not an exact check. The clearance is only computed for the center of the robot, but the arc it
+ * follows is the rounded one, which may pass closer to (or farther from) an obstacle than the twist's own arc. The
+ * travelled distance also assumes constant velocity, while StandardTrajectoryGenerator accelerates from the current
+ * velocity and so travels less far. As a result, some twists that an obstacle critic would accept can be pruned.
+ * The margin, a shorter precheck time and finer resolutions all reduce how often this happens.
+ */
+class VelocityPrecheck
+{
+public:
+  /**
+   * @brief Constructor
+   * @param time Amount of time each twist is simulated for (usually sim_time)
+   * @param margin Twists are admissible if they travel no farther than the clearance plus this distance
+   * @param direction_resolution Resolution (radians) of the direction of the linear velocity in the lookup table
+   * @param curvature_resolution Resolution (1/meters) of the curvature of the arc in the lookup table
+   */
+  explicit VelocityPrecheck(double time = 1.7, double margin = 0.1,
+                            double direction_resolution = 0.05, double curvature_resolution = 0.05);
+
+  /**
+   * @brief Load the parameters (all prefixed with precheck_) from the given namespace
+   */
+  void initialize(const ros::NodeHandle& nh);
+
+  /**
+   * @brief Start a new iteration from the given pose, clearing the lookup table
+   * @param costmap The costmap (the reference must be valid until the next call to prepare)
+   * @param pose Pose of the robot in the costmap's frame
+   */
+  void prepare(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose);
+
+  /**
+   * @brief Check whether the twist could possibly be legal
+   * @return False if the twist would drive into an obstacle within the precheck time
+   */
+  bool isAdmissible(const nav_2d_msgs::Twist2D& twist);
+
+  /**
+   * @brief Distance along the arc until the first obstacle, searching no farther than max_distance
+   * @return The distance to the obstacle, or max_distance if there is no obstacle within that distance
+   */
+  double getClearance(double direction, double curvature, double max_distance);
+
+  /**
+   * @brief The maximum admissible linear speed along the given arc
+   */
+  double getMaxSpeed(double direction, double curvature, double max_speed);
+
+  std::string getName() const { return "VelocityPrecheck"; }
+  unsigned int getNumPruned() const { return num_pruned_; }
+
+protected:
+  struct ArcClearance
+  {
+    double searched;  ///< Distance along the arc that has been checked so far
+    bool blocked;     ///< True if an obstacle was found (at distance searched)
+  };
+
+  /**
+   * @brief Check if the point is one that the obstacle critics would reject (obstacle, unknown, or off the grid)
+   */
+  bool isBlocked(double x, double y) const;
+
+  /**
+   * @brief Continue walking the arc up to the given distance
+   */
+  void extend(ArcClearance& arc, double direction, double curvature, double distance) const;
+
+  double time_, margin_, direction_resolution_, curvature_resolution_;
+
+  const nav_core2::Costmap* costmap_;
+  geometry_msgs::Pose2D pose_;
+  double step_size_;
+  std::map<std::pair<int, int>, ArcClearance> arcs_;
+  unsigned int num_pruned_;
+};
+}  // namespace dwb_local_planner
+
+#endif  // DWB_LOCAL_PLANNER_VELOCITY_PRECHECK_H
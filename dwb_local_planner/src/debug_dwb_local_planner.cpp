@@ -68,6 +68,8 @@ bool DebugDWBLocalPlanner::generateTwistsService(dwb_msgs::GenerateTwists::Reque
 bool DebugDWBLocalPlanner::generateTrajectoryService(dwb_msgs::GenerateTrajectory::Request  &req,
                                                      dwb_msgs::GenerateTrajectory::Response &res)
 {
+  // Pick up the current (possibly reconfigured) limits, as a planning iteration would
+  traj_generator_->startNewIteration(req.start_vel);
   res.traj = traj_generator_->generateTrajectory(req.start_pose, req.start_vel, req.cmd_vel);
   return true;
 }
@@ -37,17 +37,37 @@
 #include <dwb_local_planner/backwards_compatibility.h>
 #include <dwb_local_planner/illegal_trajectory_tracker.h>
 #include <nav_2d_utils/conversions.h>
-#include <nav_2d_utils/tf_help.h>
 #include <nav_2d_msgs/Twist2D.h>
 #include <dwb_msgs/CriticScore.h>
 #include <pluginlib/class_list_macros.h>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 namespace dwb_local_planner
 {
 
+namespace
+{
+/**
+ * @brief Record a trajectory that was found to be illegal by the given critic
+ */
+void addFailedScore(dwb_msgs::LocalPlanEvaluation& results, const dwb_msgs::Trajectory2D& traj,
+                    const std::string& critic_name)
+{
+  dwb_msgs::TrajectoryScore failed_score;
+  failed_score.traj = traj;
+
+  dwb_msgs::CriticScore cs;
+  cs.name = critic_name;
+  cs.raw_score = -1.0;
+  failed_score.scores.push_back(cs);
+  failed_score.total = -1.0;
+  results.twists.push_back(failed_score);
+}
+}  // namespace
+
 DWBLocalPlanner::DWBLocalPlanner() :
   traj_gen_loader_("dwb_local_planner", "dwb_local_planner::TrajectoryGenerator"),
   goal_checker_loader_("dwb_local_planner", "dwb_local_planner::GoalChecker"),
@@ -59,6 +79,9 @@ void DWBLocalPlanner::initialize(const ros::NodeHandle& parent, const std::strin
                                  TFListenerPtr tf, nav_core2::Costmap::Ptr costmap)
 {
   tf_ = tf;
+  tf_cache_ = std::make_shared<nav_core2::TransformCache>(tf_);
+  trig_cache_ = std::make_shared<TrigPoseCache>();
+  owns_tf_cache_ = true;
   costmap_ = costmap;
   planner_nh_ = ros::NodeHandle(parent, name);
 
@@ -69,6 +92,8 @@ void DWBLocalPlanner::initialize(const ros::NodeHandle& parent, const std::strin
   planner_nh_.param("prune_distance", prune_distance_, 1.0);
   planner_nh_.param("short_circuit_trajectory_evaluation", short_circuit_trajectory_evaluation_, true);
   planner_nh_.param("debug_trajectory_details", debug_trajectory_details_, false);
+  planner_nh_.param("precheck_velocities", precheck_velocities_, false);
+  precheck_.initialize(planner_nh_);
   pub_.initialize(planner_nh_);
 
   // Plugins
@@ -86,6 +111,13 @@ void DWBLocalPlanner::initialize(const ros::NodeHandle& parent, const std::strin
   goal_checker_->initialize(planner_nh_);
 
   loadCritics(name);
+
+  critic_names_ = std::make_shared<std::vector<std::string>>();
+  for (TrajectoryCritic::Ptr critic : critics_)
+  {
+    critic_names_->push_back(critic->getName());
+  }
+  critic_names_->push_back(precheck_.getName());
 }
 
 std::string DWBLocalPlanner::resolveCriticClassName(std::string base_name)
@@ -135,11 +167,23 @@ void DWBLocalPlanner::loadCritics(const std::string name)
     ROS_INFO_NAMED("DWBLocalPlanner", "Using critic \"%s\" (%s)", plugin_name.c_str(), plugin_class.c_str());
     critics_.push_back(plugin);
     plugin->initialize(planner_nh_, plugin_name, costmap_);
+    plugin->setTrigPoseCache(trig_cache_);
   }
 }
 
+void DWBLocalPlanner::setTransformCache(nav_core2::TransformCache::Ptr cache)
+{
+  tf_cache_ = cache;
+  owns_tf_cache_ = false;
+}
+
 bool DWBLocalPlanner::isGoalReached(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity)
 {
+  if (owns_tf_cache_)
+  {
+    tf_cache_->clear();
+  }
+
   if (goal_pose_.header.frame_id == "")
   {
     ROS_WARN_NAMED("DWBLocalPlanner", "Cannot check if the goal is reached without the goal being set!");
@@ -364,9 +408,27 @@ void DWBLocalPlanner::prepare(const nav_2d_msgs::Pose2DStamped& pose, const nav_
   {
     costmap_->update();
   }
+  prepareCritics(pose, velocity, true);
+}
+
+void DWBLocalPlanner::warmUp(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity)
+{
+  prepareCritics(pose, velocity, false);
+}
+
+void DWBLocalPlanner::prepareCritics(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity,
+                                     bool publish)
+{
+  if (owns_tf_cache_)
+  {
+    tf_cache_->clear();
+  }
 
   nav_2d_msgs::Path2D transformed_plan = transformGlobalPlan(pose);
-  pub_.publishTransformedPlan(transformed_plan);
+  if (publish)
+  {
+    pub_.publishTransformedPlan(transformed_plan);
+  }
 
   // Update time stamp of goal pose
   goal_pose_.header.stamp = pose.header.stamp;
@@ -375,7 +437,15 @@ void DWBLocalPlanner::prepare(const nav_2d_msgs::Pose2DStamped& pose, const nav_
   geometry_msgs::Pose2D local_start_pose = transformPoseToLocal(pose),
                         local_goal_pose = transformPoseToLocal(intermediate_goal_pose_);
 
-  pub_.publishInputParams(costmap_->getInfo(), local_start_pose, velocity, local_goal_pose);
+  if (publish)
+  {
+    pub_.publishInputParams(costmap_->getInfo(), local_start_pose, velocity, local_goal_pose);
+  }
+
+  if (precheck_velocities_)
+  {
+    precheck_.prepare(*costmap_, local_start_pose);
+  }
 
   for (TrajectoryCritic::Ptr critic : critics_)
   {
@@ -442,17 +512,59 @@ dwb_msgs::TrajectoryScore DWBLocalPlanner::coreScoringAlgorithm(const geometry_m
   dwb_msgs::TrajectoryScore best, worst;
   best.total = -1;
   worst.total = -1;
-  IllegalTrajectoryTracker tracker;
+  IllegalTrajectoryTracker tracker(critic_names_);
+  const unsigned int precheck_index = critics_.size();
+  std::vector<double> velocity_scores;
+  unsigned int critic_index;
 
   traj_generator_->startNewIteration(velocity);
   while (traj_generator_->hasMoreTwists())
   {
     twist = traj_generator_->nextTwist();
+    traj.velocity = twist;
+    traj.poses.clear();
+    traj.time_offsets.clear();
+
+    if (precheck_velocities_ && !precheck_.isAdmissible(twist))
+    {
+      if (results)
+      {
+        addFailedScore(*results, traj, precheck_.getName());
+      }
+      tracker.addIllegalTrajectory(precheck_index,
+                                   CriticResult::illegal(IllegalReason::DRIVES_INTO_OBSTACLE));
+      continue;
+    }
+
+    // Velocity-only pre-pass, so twists that are invalid or cannot beat the best score are never simulated
+    CriticResult velocity_result = scoreVelocity(twist, velocity_scores, critic_index);
+    if (!velocity_result.isLegal())
+    {
+      if (results)
+      {
+        addFailedScore(*results, traj, (*critic_names_)[critic_index]);
+      }
+      tracker.addIllegalTrajectory(critic_index, velocity_result);
+      continue;
+    }
+    if (short_circuit_trajectory_evaluation_ && best.total > 0 && velocity_result.score > best.total)
+    {
+      if (results)
+      {
+        dwb_msgs::TrajectoryScore partial_score;
+        partial_score.traj = traj;
+        partial_score.total = velocity_result.score;
+        results->twists.push_back(partial_score);
+      }
+      continue;
+    }
+
     traj = traj_generator_->generateTrajectory(pose, velocity, twist);
 
-    try
+    dwb_msgs::TrajectoryScore score;
+    CriticResult result = scoreTrajectoryWithVelocityScores(traj, best.total, velocity_scores, score, critic_index);
+    if (result.isLegal())
     {
-      dwb_msgs::TrajectoryScore score = scoreTrajectory(traj, best.total);
       tracker.addLegalTrajectory();
       if (results)
       {
@@ -475,21 +587,13 @@ dwb_msgs::TrajectoryScore DWBLocalPlanner::coreScoringAlgorithm(const geometry_m
         }
       }
     }
-    catch (const nav_core2::IllegalTrajectoryException& e)
+    else
     {
       if (results)
       {
-        dwb_msgs::TrajectoryScore failed_score;
-        failed_score.traj = traj;
-
-        dwb_msgs::CriticScore cs;
-        cs.name = e.getCriticName();
-        cs.raw_score = -1.0;
-        failed_score.scores.push_back(cs);
-        failed_score.total = -1.0;
-        results->twists.push_back(failed_score);
+        addFailedScore(*results, traj, (*critic_names_)[critic_index]);
       }
-      tracker.addIllegalTrajectory(e);
+      tracker.addIllegalTrajectory(critic_index, result);
     }
   }
 
@@ -513,10 +617,56 @@ dwb_msgs::TrajectoryScore DWBLocalPlanner::scoreTrajectory(const dwb_msgs::Traje
                                                            double best_score)
 {
   dwb_msgs::TrajectoryScore score;
+  unsigned int critic_index;
+  CriticResult result = scoreTrajectoryWithVelocityScores(traj, best_score, std::vector<double>(), score,
+                                                          critic_index);
+  if (!result.isLegal())
+  {
+    throw nav_core2::IllegalTrajectoryException(critics_[critic_index]->getName(), result.getDescription());
+  }
+  return score;
+}
+
+CriticResult DWBLocalPlanner::scoreVelocity(const nav_2d_msgs::Twist2D& twist, std::vector<double>& velocity_scores,
+                                            unsigned int& critic_index)
+{
+  velocity_scores.resize(critics_.size());
+  double total = 0.0;
+  for (unsigned int i = 0; i < critics_.size(); i++)
+  {
+    const TrajectoryCritic::Ptr& critic = critics_[i];
+    double scale = critic->getScale();
+    if (scale == 0.0)
+    {
+      velocity_scores[i] = 0.0;
+      continue;
+    }
+    CriticResult result = critic->checkVelocity(twist);
+    if (!result.isLegal())
+    {
+      critic_index = i;
+      return result;
+    }
+    velocity_scores[i] = result.score;
+    total += velocity_scores[i] * scale;
+  }
+  return CriticResult(total);
+}
+
+CriticResult DWBLocalPlanner::scoreTrajectoryWithVelocityScores(const dwb_msgs::Trajectory2D& traj,
+    double best_score, const std::vector<double>& velocity_scores, dwb_msgs::TrajectoryScore& score,
+    unsigned int& critic_index)
+{
   score.traj = traj;
+  score.scores.clear();
+  score.total = 0.0;
 
-  for (TrajectoryCritic::Ptr critic : critics_)
+  // The cache refers to traj, so it is cleared before returning
+  trig_cache_->setTrajectory(traj);
+
+  for (unsigned int i = 0; i < critics_.size(); i++)
   {
+    const TrajectoryCritic::Ptr& critic = critics_[i];
     dwb_msgs::CriticScore cs;
     cs.name = critic->getName();
     cs.scale = critic->getScale();
@@ -527,7 +677,31 @@ dwb_msgs::TrajectoryScore DWBLocalPlanner::scoreTrajectory(const dwb_msgs::Traje
       continue;
     }
 
-    double critic_score = critic->scoreTrajectory(traj);
+    double critic_score;
+    if (critic->isVelocityOnly() && i < velocity_scores.size())
+    {
+      critic_score = velocity_scores[i];
+    }
+    else
+    {
+      CriticResult result;
+      try
+      {
+        result = critic->checkTrajectory(traj);
+      }
+      catch (...)
+      {
+        trig_cache_->clear();
+        throw;
+      }
+      if (!result.isLegal())
+      {
+        trig_cache_->clear();
+        critic_index = i;
+        return result;
+      }
+      critic_score = result.score;
+    }
     cs.raw_score = critic_score;
     score.scores.push_back(cs);
     score.total += critic_score * cs.scale;
@@ -538,7 +712,8 @@ dwb_msgs::TrajectoryScore DWBLocalPlanner::scoreTrajectory(const dwb_msgs::Traje
     }
   }
 
-  return score;
+  trig_cache_->clear();
+  return CriticResult(score.total);
 }
 
 double getSquareDistance(const geometry_msgs::Pose2D& pose_a, const geometry_msgs::Pose2D& pose_b)
@@ -558,7 +733,7 @@ nav_2d_msgs::Path2D DWBLocalPlanner::transformGlobalPlan(const nav_2d_msgs::Pose
 
   // let's get the pose of the robot in the frame of the plan
   nav_2d_msgs::Pose2DStamped robot_pose;
-  if (!nav_2d_utils::transformPose(tf_, global_plan_.header.frame_id, pose, robot_pose))
+  if (!tf_cache_->transformPose(global_plan_.header.frame_id, pose, robot_pose))
   {
     throw nav_core2::PlannerTFException("Unable to transform robot pose into global plan's frame");
   }
@@ -602,7 +777,7 @@ nav_2d_msgs::Path2D DWBLocalPlanner::transformGlobalPlan(const nav_2d_msgs::Pose
   {
     // let's get the pose of the robot in the frame of the transformed_plan/costmap
     nav_2d_msgs::Pose2DStamped costmap_pose;
-    if (!nav_2d_utils::transformPose(tf_, transformed_plan.header.frame_id, pose, costmap_pose))
+    if (!tf_cache_->transformPose(transformed_plan.header.frame_id, pose, costmap_pose))
     {
       throw nav_core2::PlannerTFException("Unable to transform robot pose into costmap's frame");
     }
@@ -636,7 +811,7 @@ nav_2d_msgs::Path2D DWBLocalPlanner::transformGlobalPlan(const nav_2d_msgs::Pose
 
 geometry_msgs::Pose2D DWBLocalPlanner::transformPoseToLocal(const nav_2d_msgs::Pose2DStamped& pose)
 {
-  return nav_2d_utils::transformStampedPose(tf_, pose, costmap_->getFrameId());
+  return tf_cache_->transformStampedPose(pose, costmap_->getFrameId());
 }
 
 }  // namespace dwb_local_planner
@@ -34,18 +34,58 @@
 
 #include <dwb_local_planner/illegal_trajectory_tracker.h>
 #include <map>
+#include <memory>
 #include <utility>
 #include <string>
 #include <sstream>
+#include <vector>
 
 namespace dwb_local_planner
 {
+const unsigned int NUM_REASONS = static_cast<unsigned int>(IllegalReason::NUM_REASONS);
+
+IllegalTrajectoryTracker::IllegalTrajectoryTracker(std::shared_ptr<const std::vector<std::string>> critic_names)
+  : critic_names_(critic_names), reason_counts_(critic_names ? critic_names->size() * NUM_REASONS : 0, 0),
+    legal_count_(0), illegal_count_(0)
+{
+}
+
 void IllegalTrajectoryTracker::addIllegalTrajectory(const nav_core2::IllegalTrajectoryException& e)
 {
-  counts_[std::make_pair(e.getCriticName(), e.what())]++;
+  addIllegalTrajectory(e.getCriticName(), e.what());
+}
+
+void IllegalTrajectoryTracker::addIllegalTrajectory(const std::string& critic_name, const std::string& reason)
+{
+  counts_[std::make_pair(critic_name, reason)]++;
+  illegal_count_++;
+}
+
+void IllegalTrajectoryTracker::addIllegalTrajectory(unsigned int critic_index, const CriticResult& result)
+{
+  if (result.reason == IllegalReason::OTHER)
+  {
+    addIllegalTrajectory(getCriticName(critic_index), result.description);
+    return;
+  }
+  unsigned int index = critic_index * NUM_REASONS + static_cast<unsigned int>(result.reason);
+  if (index >= reason_counts_.size())
+  {
+    reason_counts_.resize((critic_index + 1) * NUM_REASONS, 0);
+  }
+  reason_counts_[index]++;
   illegal_count_++;
 }
 
+std::string IllegalTrajectoryTracker::getCriticName(unsigned int critic_index) const
+{
+  if (critic_names_ && critic_index < critic_names_->size())
+  {
+    return (*critic_names_)[critic_index];
+  }
+  return std::to_string(critic_index);
+}
+
 void IllegalTrajectoryTracker::addLegalTrajectory()
 {
   legal_count_++;
@@ -59,6 +99,13 @@ std::map< std::pair<std::string, std::string>, double> IllegalTrajectoryTracker:
   {
     percents[x.first] = static_cast<double>(x.second) / denominator;
   }
+  for (unsigned int i = 0; i < reason_counts_.size(); i++)
+  {
+    if (reason_counts_[i] == 0) continue;
+    auto key = std::make_pair(getCriticName(i / NUM_REASONS),
+                              std::string(getIllegalReasonDescription(static_cast<IllegalReason>(i % NUM_REASONS))));
+    percents[key] += static_cast<double>(reason_counts_[i]) / denominator;
+  }
   return percents;
 }
 
@@ -34,9 +34,42 @@
 
 #include <dwb_local_planner/trajectory_utils.h>
 #include <nav_core2/exceptions.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace dwb_local_planner
 {
+/**
+ * @brief Find the index i such that time_offsets[i] <= goal_time < time_offsets[i + 1]
+ *
+ * Assumes time_offsets[0] <= goal_time < time_offsets.back(). Since trajectories are usually generated with a
+ * constant time step, the index is first estimated from the first step, and a binary search is only needed if
+ * the estimate is wrong.
+ */
+unsigned int findTimeSegment(const std::vector<ros::Duration>& time_offsets, const ros::Duration& goal_time)
+{
+  const unsigned int num_segments = time_offsets.size() - 1;
+  double start = time_offsets[0].toSec();
+  double step = time_offsets[1].toSec() - start;
+  if (step > 0.0)
+  {
+    double estimate = floor((goal_time.toSec() - start) / step);
+    if (estimate >= 0.0 && estimate < num_segments)
+    {
+      unsigned int i = static_cast<unsigned int>(estimate);
+      if (time_offsets[i] <= goal_time && goal_time < time_offsets[i + 1])
+      {
+        return i;
+      }
+    }
+  }
+
+  // Non-uniform time steps: find the first offset greater than the goal time
+  auto upper = std::upper_bound(time_offsets.begin(), time_offsets.end(), goal_time);
+  return (upper - time_offsets.begin()) - 1;
+}
+
 const geometry_msgs::Pose2D& getClosestPose(const dwb_msgs::Trajectory2D& trajectory, const double time_offset)
 {
   ros::Duration goal_time(time_offset);
@@ -45,22 +78,20 @@ const geometry_msgs::Pose2D& getClosestPose(const dwb_msgs::Trajectory2D& trajec
   {
     throw nav_core2::PlannerException("Cannot call getClosestPose on empty trajectory.");
   }
-  unsigned int closest_index = num_poses;
-  double closest_diff = 0.0;
-  for (unsigned int i=0; i < num_poses; ++i)
+  if (goal_time <= trajectory.time_offsets[0])
   {
-    double diff = fabs((trajectory.time_offsets[i] - goal_time).toSec());
-    if (closest_index == num_poses || diff < closest_diff)
-    {
-      closest_index = i;
-      closest_diff = diff;
-    }
-    if (goal_time < trajectory.time_offsets[i])
-    {
-      break;
-    }
+    return trajectory.poses[0];
   }
-  return trajectory.poses[closest_index];
+  else if (goal_time >= trajectory.time_offsets[num_poses - 1])
+  {
+    return trajectory.poses[num_poses - 1];
+  }
+
+  // Pick the closer end of the segment, favoring the earlier pose when they are equally close
+  unsigned int i = findTimeSegment(trajectory.time_offsets, goal_time);
+  double diff_a = (goal_time - trajectory.time_offsets[i]).toSec();
+  double diff_b = (trajectory.time_offsets[i + 1] - goal_time).toSec();
+  return diff_b < diff_a ? trajectory.poses[i + 1] : trajectory.poses[i];
 }
 
 geometry_msgs::Pose2D projectPose(const dwb_msgs::Trajectory2D& trajectory, const double time_offset)
@@ -80,26 +111,17 @@ geometry_msgs::Pose2D projectPose(const dwb_msgs::Trajectory2D& trajectory, cons
     return trajectory.poses[num_poses - 1];
   }
 
-  for (unsigned int i=0; i < num_poses - 1; ++i)
-  {
-    if (goal_time >= trajectory.time_offsets[i] && goal_time < trajectory.time_offsets[i+1])
-    {
-      double time_diff = (trajectory.time_offsets[i+1] - trajectory.time_offsets[i]).toSec();
-      double ratio = (goal_time - trajectory.time_offsets[i]).toSec() / time_diff;
-      double inv_ratio = 1.0 - ratio;
-      const geometry_msgs::Pose2D& pose_a = trajectory.poses[i];
-      const geometry_msgs::Pose2D& pose_b = trajectory.poses[i + 1];
-      geometry_msgs::Pose2D projected;
-      projected.x     = pose_a.x     * inv_ratio + pose_b.x     * ratio;
-      projected.y     = pose_a.y     * inv_ratio + pose_b.y     * ratio;
-      projected.theta = pose_a.theta * inv_ratio + pose_b.theta * ratio;
-      return projected;
-    }
-  }
-
-  // Should not reach this point
-  return trajectory.poses[num_poses - 1];
+  unsigned int i = findTimeSegment(trajectory.time_offsets, goal_time);
+  double time_diff = (trajectory.time_offsets[i + 1] - trajectory.time_offsets[i]).toSec();
+  double ratio = (goal_time - trajectory.time_offsets[i]).toSec() / time_diff;
+  double inv_ratio = 1.0 - ratio;
+  const geometry_msgs::Pose2D& pose_a = trajectory.poses[i];
+  const geometry_msgs::Pose2D& pose_b = trajectory.poses[i + 1];
+  geometry_msgs::Pose2D projected;
+  projected.x     = pose_a.x     * inv_ratio + pose_b.x     * ratio;
+  projected.y     = pose_a.y     * inv_ratio + pose_b.y     * ratio;
+  projected.theta = pose_a.theta * inv_ratio + pose_b.theta * ratio;
+  return projected;
 }
 
-
 }  // namespace dwb_local_planner
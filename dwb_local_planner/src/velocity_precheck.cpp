@@ -0,0 +1,152 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <dwb_local_planner/velocity_precheck.h>
+#include <nav_grid/coordinate_conversion.h>
+#include <algorithm>
+#include <cmath>
+
+namespace dwb_local_planner
+{
+const double EPSILON = 1e-6;
+
+VelocityPrecheck::VelocityPrecheck(double time, double margin, double direction_resolution,
+                                   double curvature_resolution) :
+  time_(time), margin_(margin), direction_resolution_(direction_resolution),
+  curvature_resolution_(curvature_resolution), costmap_(nullptr), step_size_(0.0), num_pruned_(0)
+{
+}
+
+void VelocityPrecheck::initialize(const ros::NodeHandle& nh)
+{
+  double sim_time;
+  nh.param("sim_time", sim_time, 1.7);
+  nh.param("precheck_time", time_, sim_time);
+  nh.param("precheck_margin", margin_, 0.1);
+  nh.param("precheck_direction_resolution", direction_resolution_, 0.05);
+  nh.param("precheck_curvature_resolution", curvature_resolution_, 0.05);
+}
+
+void VelocityPrecheck::prepare(const nav_core2::Costmap& costmap, const geometry_msgs::Pose2D& pose)
+{
+  costmap_ = &costmap;
+  pose_ = pose;
+  // Half the cell size, so the walk cannot skip over a cell
+  step_size_ = costmap.getResolution() / 2.0;
+  arcs_.clear();
+  num_pruned_ = 0;
+}
+
+bool VelocityPrecheck::isAdmissible(const nav_2d_msgs::Twist2D& twist)
+{
+  double speed = hypot(twist.x, twist.y);
+  if (speed < EPSILON) return true;
+  double max_speed = getMaxSpeed(atan2(twist.y, twist.x), twist.theta / speed, speed);
+  if (speed <= max_speed + EPSILON) return true;
+  num_pruned_++;
+  return false;
+}
+
+double VelocityPrecheck::getMaxSpeed(double direction, double curvature, double max_speed)
+{
+  if (time_ <= 0.0) return max_speed;
+  double clearance = getClearance(direction, curvature, max_speed * time_ - margin_);
+  return (clearance + margin_) / time_;
+}
+
+double VelocityPrecheck::getClearance(double direction, double curvature, double max_distance)
+{
+  if (!costmap_ || max_distance <= 0.0) return std::max(max_distance, 0.0);
+
+  int direction_index = static_cast<int>(std::round(direction / direction_resolution_));
+  int curvature_index = static_cast<int>(std::round(curvature / curvature_resolution_));
+  auto key = std::make_pair(direction_index, curvature_index);
+  auto it = arcs_.find(key);
+  if (it == arcs_.end())
+  {
+    ArcClearance arc;
+    arc.searched = 0.0;
+    arc.blocked = isBlocked(pose_.x, pose_.y);
+    it = arcs_.insert(std::make_pair(key, arc)).first;
+  }
+
+  ArcClearance& arc = it->second;
+  if (!arc.blocked && arc.searched < max_distance)
+  {
+    extend(arc, direction_index * direction_resolution_, curvature_index * curvature_resolution_, max_distance);
+  }
+  return std::min(arc.searched, max_distance);
+}
+
+void VelocityPrecheck::extend(ArcClearance& arc, double direction, double curvature, double distance) const
+{
+  double heading = pose_.theta + direction;
+  double s = arc.searched;
+  while (s < distance)
+  {
+    s = std::min(s + step_size_, distance);
+    double x, y;
+    if (fabs(curvature) < EPSILON)
+    {
+      x = pose_.x + s * cos(heading);
+      y = pose_.y + s * sin(heading);
+    }
+    else
+    {
+      x = pose_.x + (sin(heading + curvature * s) - sin(heading)) / curvature;
+      y = pose_.y - (cos(heading + curvature * s) - cos(heading)) / curvature;
+    }
+    if (isBlocked(x, y))
+    {
+      arc.blocked = true;
+      break;
+    }
+  }
+  arc.searched = s;
+}
+
+bool VelocityPrecheck::isBlocked(double x, double y) const
+{
+  unsigned int cell_x, cell_y;
+  if (!worldToGridBounded(costmap_->getInfo(), x, y, cell_x, cell_y))
+  {
+    return true;
+  }
+  unsigned char cost = (*costmap_)(cell_x, cell_y);
+  return cost == nav_core2::Costmap::LETHAL_OBSTACLE ||
+         cost == nav_core2::Costmap::INSCRIBED_INFLATED_OBSTACLE ||
+         cost == nav_core2::Costmap::NO_INFORMATION;
+}
+
+}  // namespace dwb_local_planner
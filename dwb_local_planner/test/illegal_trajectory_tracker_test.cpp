@@ -0,0 +1,95 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <dwb_local_planner/illegal_trajectory_tracker.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using dwb_local_planner::CriticResult;
+using dwb_local_planner::IllegalReason;
+using dwb_local_planner::IllegalTrajectoryTracker;
+
+TEST(IllegalTrajectoryTracker, interned_and_string_reasons)
+{
+  auto names = std::make_shared<std::vector<std::string>>();
+  names->push_back("Obstacle");
+  names->push_back("Oscillation");
+  IllegalTrajectoryTracker tracker(names);
+
+  tracker.addLegalTrajectory();
+  tracker.addIllegalTrajectory(0, CriticResult::illegal(IllegalReason::HITS_OBSTACLE));
+  tracker.addIllegalTrajectory(0, CriticResult::illegal(IllegalReason::HITS_OBSTACLE));
+  tracker.addIllegalTrajectory(1, CriticResult::illegal(IllegalReason::OSCILLATING));
+  // Reasons that are not interned and the old string/exception interfaces still count under the same keys
+  tracker.addIllegalTrajectory(1, CriticResult::illegal("Custom reason."));
+  tracker.addIllegalTrajectory(nav_core2::IllegalTrajectoryException("Obstacle", "Trajectory Hits Obstacle."));
+
+  std::map<std::pair<std::string, std::string>, double> percents = tracker.getPercentages();
+  ASSERT_EQ(3u, percents.size());
+  EXPECT_DOUBLE_EQ(0.5, (percents[std::make_pair("Obstacle", "Trajectory Hits Obstacle.")]));
+  EXPECT_DOUBLE_EQ(1.0 / 6.0, (percents[std::make_pair("Oscillation", "Trajectory is oscillating.")]));
+  EXPECT_DOUBLE_EQ(1.0 / 6.0, (percents[std::make_pair("Oscillation", "Custom reason.")]));
+}
+
+TEST(IllegalTrajectoryTracker, unnamed_critics)
+{
+  // Without the names, the critics are reported by their index
+  IllegalTrajectoryTracker tracker;
+  tracker.addIllegalTrajectory(2, CriticResult::illegal(IllegalReason::HITS_OBSTACLE));
+  tracker.addIllegalTrajectory(0, CriticResult::illegal("Custom reason."));
+
+  std::map<std::pair<std::string, std::string>, double> percents = tracker.getPercentages();
+  ASSERT_EQ(2u, percents.size());
+  EXPECT_DOUBLE_EQ(0.5, (percents[std::make_pair("2", "Trajectory Hits Obstacle.")]));
+  EXPECT_DOUBLE_EQ(0.5, (percents[std::make_pair("0", "Custom reason.")]));
+}
+
+TEST(CriticResult, descriptions)
+{
+  EXPECT_TRUE(CriticResult(5.0).isLegal());
+  EXPECT_DOUBLE_EQ(5.0, CriticResult(5.0).score);
+  EXPECT_FALSE(CriticResult::illegal(IllegalReason::GOES_OFF_GRID).isLegal());
+  EXPECT_EQ("Trajectory Goes Off Grid.", CriticResult::illegal(IllegalReason::GOES_OFF_GRID).getDescription());
+  EXPECT_EQ("Custom reason.", CriticResult::illegal("Custom reason.").getDescription());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,260 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+#include <dwb_local_planner/dwb_local_planner.h>
+#include <dwb_local_planner/illegal_trajectory_tracker.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using dwb_local_planner::CriticResult;
+using dwb_local_planner::IllegalReason;
+
+/**
+ * @brief Generator that iterates over a fixed list of twists and counts the trajectories it generates
+ */
+class ListGenerator : public dwb_local_planner::TrajectoryGenerator
+{
+public:
+  void initialize(ros::NodeHandle& nh) override {}
+  void startNewIteration(const nav_2d_msgs::Twist2D& current_velocity) override { index_ = 0; }
+  bool hasMoreTwists() override { return index_ < twists_.size(); }
+  nav_2d_msgs::Twist2D nextTwist() override { return twists_[index_++]; }
+
+  dwb_msgs::Trajectory2D generateTrajectory(const geometry_msgs::Pose2D& start_pose,
+                                            const nav_2d_msgs::Twist2D& start_vel,
+                                            const nav_2d_msgs::Twist2D& cmd_vel) override
+  {
+    num_generated_++;
+    dwb_msgs::Trajectory2D traj;
+    traj.velocity = cmd_vel;
+    traj.poses.push_back(start_pose);
+    traj.time_offsets.push_back(ros::Duration(0.0));
+    return traj;
+  }
+
+  void addTwist(double x)
+  {
+    nav_2d_msgs::Twist2D twist;
+    twist.x = x;
+    twists_.push_back(twist);
+  }
+
+  std::vector<nav_2d_msgs::Twist2D> twists_;
+  unsigned int index_ = 0;
+  unsigned int num_generated_ = 0;
+};
+
+/**
+ * @brief Velocity-only critic that scores twist.x and rejects negative x
+ */
+class SpeedCritic : public dwb_local_planner::TrajectoryCritic
+{
+public:
+  SpeedCritic()
+  {
+    name_ = "Speed";
+    scale_ = 1.0;
+  }
+
+  CriticResult checkVelocity(const nav_2d_msgs::Twist2D& twist) override
+  {
+    num_velocity_checks_++;
+    if (twist.x < 0.0) return CriticResult::illegal(IllegalReason::OSCILLATING);
+    return CriticResult(twist.x);
+  }
+  double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) override
+  {
+    num_trajectory_checks_++;
+    return traj.velocity.x;
+  }
+  bool isVelocityOnly() const override { return true; }
+
+  unsigned int num_velocity_checks_ = 0;
+  unsigned int num_trajectory_checks_ = 0;
+};
+
+/**
+ * @brief Critic that needs the trajectory, and gives every one the same score
+ */
+class ConstantCritic : public dwb_local_planner::TrajectoryCritic
+{
+public:
+  ConstantCritic()
+  {
+    name_ = "Constant";
+    scale_ = 1.0;
+  }
+
+  double scoreTrajectory(const dwb_msgs::Trajectory2D& traj) override
+  {
+    num_trajectory_checks_++;
+    return 0.5;
+  }
+
+  unsigned int num_trajectory_checks_ = 0;
+};
+
+/**
+ * @brief Planner with test plugins instead of the ones loaded by initialize
+ */
+class TestPlanner : public dwb_local_planner::DWBLocalPlanner
+{
+public:
+  explicit TestPlanner(bool short_circuit)
+  {
+    short_circuit_trajectory_evaluation_ = short_circuit;
+    precheck_velocities_ = false;
+    debug_trajectory_details_ = false;
+    trig_cache_ = std::make_shared<dwb_local_planner::TrigPoseCache>();
+
+    generator_ = std::make_shared<ListGenerator>();
+    traj_generator_ = generator_;
+    speed_ = std::make_shared<SpeedCritic>();
+    constant_ = std::make_shared<ConstantCritic>();
+    critics_.push_back(speed_);
+    critics_.push_back(constant_);
+
+    critic_names_ = std::make_shared<std::vector<std::string>>();
+    for (const dwb_local_planner::TrajectoryCritic::Ptr& critic : critics_)
+    {
+      critic->setTrigPoseCache(trig_cache_);
+      critic_names_->push_back(critic->getName());
+    }
+    critic_names_->push_back(precheck_.getName());
+  }
+
+  dwb_msgs::TrajectoryScore score(std::shared_ptr<dwb_msgs::LocalPlanEvaluation>& results)
+  {
+    return coreScoringAlgorithm(geometry_msgs::Pose2D(), nav_2d_msgs::Twist2D(), results);
+  }
+
+  std::shared_ptr<ListGenerator> generator_;
+  std::shared_ptr<SpeedCritic> speed_;
+  std::shared_ptr<ConstantCritic> constant_;
+};
+
+TEST(CoreScoring, velocity_only_critic_not_simulated)
+{
+  TestPlanner planner(false);
+  planner.generator_->addTwist(3.0);
+  planner.generator_->addTwist(1.0);
+  planner.generator_->addTwist(2.0);
+
+  auto results = std::make_shared<dwb_msgs::LocalPlanEvaluation>();
+  dwb_msgs::TrajectoryScore best = planner.score(results);
+  EXPECT_DOUBLE_EQ(1.0, best.traj.velocity.x);
+  EXPECT_DOUBLE_EQ(1.5, best.total);
+
+  // Every trajectory is generated and scored by the other critic, but the velocity score is reused
+  EXPECT_EQ(3u, planner.generator_->num_generated_);
+  EXPECT_EQ(3u, planner.speed_->num_velocity_checks_);
+  EXPECT_EQ(0u, planner.speed_->num_trajectory_checks_);
+  EXPECT_EQ(3u, planner.constant_->num_trajectory_checks_);
+
+  ASSERT_EQ(3u, results->twists.size());
+  EXPECT_DOUBLE_EQ(3.5, results->twists[0].total);
+  ASSERT_EQ(2u, results->twists[0].scores.size());
+  EXPECT_DOUBLE_EQ(3.0, results->twists[0].scores[0].raw_score);
+  EXPECT_EQ(1u, results->best_index);
+}
+
+TEST(CoreScoring, prune_by_best_score)
+{
+  TestPlanner planner(true);
+  planner.generator_->addTwist(1.0);
+  planner.generator_->addTwist(3.0);
+  planner.generator_->addTwist(2.0);
+  planner.generator_->addTwist(0.25);
+
+  auto results = std::make_shared<dwb_msgs::LocalPlanEvaluation>();
+  dwb_msgs::TrajectoryScore best = planner.score(results);
+  EXPECT_DOUBLE_EQ(0.25, best.traj.velocity.x);
+
+  // The twists whose velocity score is already worse than the first trajectory's total are never generated
+  EXPECT_EQ(2u, planner.generator_->num_generated_);
+  EXPECT_EQ(2u, planner.constant_->num_trajectory_checks_);
+
+  // but they are still in the results, with their partial score and no poses
+  ASSERT_EQ(4u, results->twists.size());
+  EXPECT_DOUBLE_EQ(3.0, results->twists[1].total);
+  EXPECT_TRUE(results->twists[1].traj.poses.empty());
+  EXPECT_DOUBLE_EQ(2.0, results->twists[2].total);
+  EXPECT_EQ(3u, results->best_index);
+}
+
+TEST(CoreScoring, illegal_velocities_counted)
+{
+  TestPlanner planner(true);
+  planner.generator_->addTwist(-1.0);
+  planner.generator_->addTwist(-2.0);
+  planner.generator_->addTwist(1.0);
+
+  auto results = std::make_shared<dwb_msgs::LocalPlanEvaluation>();
+  dwb_msgs::TrajectoryScore best = planner.score(results);
+  EXPECT_DOUBLE_EQ(1.0, best.traj.velocity.x);
+  EXPECT_EQ(1u, planner.generator_->num_generated_);
+
+  ASSERT_EQ(3u, results->twists.size());
+  EXPECT_DOUBLE_EQ(-1.0, results->twists[0].total);
+  ASSERT_EQ(1u, results->twists[0].scores.size());
+  EXPECT_EQ("Speed", results->twists[0].scores[0].name);
+
+  // With no legal twists, the rejected velocities are reported in the exception
+  TestPlanner illegal_planner(true);
+  illegal_planner.generator_->addTwist(-1.0);
+  illegal_planner.generator_->addTwist(-2.0);
+  std::shared_ptr<dwb_msgs::LocalPlanEvaluation> no_results;
+  try
+  {
+    illegal_planner.score(no_results);
+    FAIL() << "Expected NoLegalTrajectoriesException";
+  }
+  catch (const dwb_local_planner::NoLegalTrajectoriesException& e)
+  {
+    auto percents = e.tracker_.getPercentages();
+    ASSERT_EQ(1u, percents.size());
+    EXPECT_DOUBLE_EQ(1.0, (percents[std::make_pair("Speed", "Trajectory is oscillating.")]));
+  }
+  EXPECT_EQ(0u, illegal_planner.generator_->num_generated_);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -34,6 +34,7 @@
 
 #include <gtest/gtest.h>
 #include <dwb_local_planner/trajectory_utils.h>
+#include <vector>
 
 using dwb_local_planner::getClosestPose;
 using dwb_local_planner::projectPose;
@@ -108,6 +109,34 @@ TEST(Utils, ProjectPose)
   EXPECT_DOUBLE_EQ(projectPose(traj, 3.5).theta, 0.42);
 }
 
+TEST(Utils, NonUniformTimes)
+{
+  dwb_msgs::Trajectory2D traj;
+  std::vector<double> times = {0.0, 0.1, 0.5, 0.6, 2.0};
+  traj.poses.resize(times.size());
+  traj.time_offsets.resize(times.size());
+  for (unsigned int i=0; i < traj.poses.size(); i++)
+  {
+    traj.poses[i].x = static_cast<double>(i);
+    traj.time_offsets[i] = ros::Duration(times[i]);
+  }
+
+  EXPECT_DOUBLE_EQ(getClosestPose(traj, -1.0).x, 0.0);
+  EXPECT_DOUBLE_EQ(getClosestPose(traj,  0.04).x, 0.0);
+  EXPECT_DOUBLE_EQ(getClosestPose(traj,  0.2).x, 1.0);
+  EXPECT_DOUBLE_EQ(getClosestPose(traj,  0.4).x, 2.0);
+  EXPECT_DOUBLE_EQ(getClosestPose(traj,  0.6).x, 3.0);
+  EXPECT_DOUBLE_EQ(getClosestPose(traj,  1.2).x, 3.0);
+  EXPECT_DOUBLE_EQ(getClosestPose(traj,  1.4).x, 4.0);
+  EXPECT_DOUBLE_EQ(getClosestPose(traj,  3.0).x, 4.0);
+
+  EXPECT_DOUBLE_EQ(projectPose(traj,  0.05).x, 0.5);
+  EXPECT_DOUBLE_EQ(projectPose(traj,  0.3).x, 1.5);
+  EXPECT_DOUBLE_EQ(projectPose(traj,  0.55).x, 2.5);
+  EXPECT_DOUBLE_EQ(projectPose(traj,  1.3).x, 3.5);
+  EXPECT_DOUBLE_EQ(projectPose(traj,  2.5).x, 4.0);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
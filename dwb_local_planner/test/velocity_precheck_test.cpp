@@ -0,0 +1,124 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <dwb_local_planner/velocity_precheck.h>
+#include <nav_core2/basic_costmap.h>
+
+using dwb_local_planner::VelocityPrecheck;
+
+/**
+ * 4m x 4m costmap with 0.1m resolution, with a wall at x=3.0, and the robot at (1, 2) facing +x
+ */
+class PrecheckTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    nav_grid::NavGridInfo info;
+    info.width = 40;
+    info.height = 40;
+    info.resolution = 0.1;
+    costmap_.setInfo(info);
+    unsigned char lethal = nav_core2::Costmap::LETHAL_OBSTACLE;
+    for (unsigned int y = 0; y < info.height; y++)
+    {
+      costmap_.setValue(30, y, lethal);
+    }
+    pose_.x = 1.0;
+    pose_.y = 2.0;
+  }
+
+  nav_2d_msgs::Twist2D twist(double x, double y, double theta)
+  {
+    nav_2d_msgs::Twist2D t;
+    t.x = x;
+    t.y = y;
+    t.theta = theta;
+    return t;
+  }
+
+  nav_core2::BasicCostmap costmap_;
+  geometry_msgs::Pose2D pose_;
+};
+
+TEST_F(PrecheckTest, straight)
+{
+  VelocityPrecheck precheck(1.0, 0.0);
+  precheck.prepare(costmap_, pose_);
+  EXPECT_NEAR(precheck.getClearance(0.0, 0.0, 10.0), 2.0, 0.1);
+  EXPECT_TRUE(precheck.isAdmissible(twist(1.5, 0.0, 0.0)));
+  EXPECT_FALSE(precheck.isAdmissible(twist(2.5, 0.0, 0.0)));
+  EXPECT_EQ(precheck.getNumPruned(), 1U);
+
+  // Away from the wall, the only limit is the edge of the map
+  EXPECT_TRUE(precheck.isAdmissible(twist(-0.9, 0.0, 0.0)));
+  EXPECT_FALSE(precheck.isAdmissible(twist(-1.5, 0.0, 0.0)));
+  EXPECT_TRUE(precheck.isAdmissible(twist(0.0, 1.5, 0.0)));
+}
+
+TEST_F(PrecheckTest, rotation)
+{
+  VelocityPrecheck precheck(1.0, 0.0);
+  precheck.prepare(costmap_, pose_);
+  // Rotating in place is never pruned
+  EXPECT_TRUE(precheck.isAdmissible(twist(0.0, 0.0, 1.0)));
+
+  // Turning tightly never reaches the wall
+  EXPECT_TRUE(precheck.isAdmissible(twist(3.0, 0.0, 6.0)));
+}
+
+TEST_F(PrecheckTest, margin)
+{
+  VelocityPrecheck precheck(1.0, 1.0);
+  precheck.prepare(costmap_, pose_);
+  EXPECT_TRUE(precheck.isAdmissible(twist(2.5, 0.0, 0.0)));
+  EXPECT_FALSE(precheck.isAdmissible(twist(3.5, 0.0, 0.0)));
+}
+
+TEST_F(PrecheckTest, blocked_start)
+{
+  pose_.x = 3.05;
+  VelocityPrecheck precheck(1.0, 0.0);
+  precheck.prepare(costmap_, pose_);
+  EXPECT_DOUBLE_EQ(precheck.getClearance(0.0, 0.0, 1.0), 0.0);
+  EXPECT_FALSE(precheck.isAdmissible(twist(0.1, 0.0, 0.0)));
+  EXPECT_TRUE(precheck.isAdmissible(twist(0.0, 0.0, 0.5)));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
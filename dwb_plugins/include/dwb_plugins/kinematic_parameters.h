@@ -38,37 +38,48 @@
 #include <ros/ros.h>
 #include <dynamic_reconfigure/server.h>
 #include <dwb_plugins/KinematicParamsConfig.h>
+#include <boost/thread/mutex.hpp>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace dwb_plugins
 {
 
 /**
- * @class KinematicParameters
- * @brief A dynamically reconfigurable class containing one representation of the robot's kinematics
+ * @class KinematicLimits
+ * @brief Immutable snapshot of the robot's kinematic limits at one point in time
  */
-class KinematicParameters
+class KinematicLimits
 {
 public:
-  KinematicParameters();
-  void initialize(const ros::NodeHandle& nh);
+  KinematicLimits();
 
-  inline double getMinX() { return min_vel_x_; }
-  inline double getMaxX() { return max_vel_x_; }
-  inline double getAccX() { return acc_lim_x_; }
-  inline double getDecelX() { return decel_lim_x_; }
+  inline double getMinX() const { return min_vel_x_; }
+  inline double getMaxX() const { return max_vel_x_; }
+  inline double getAccX() const { return acc_lim_x_; }
+  inline double getDecelX() const { return decel_lim_x_; }
 
-  inline double getMinY() { return min_vel_y_; }
-  inline double getMaxY() { return max_vel_y_; }
-  inline double getAccY() { return acc_lim_y_; }
-  inline double getDecelY() { return decel_lim_y_; }
+  inline double getMinY() const { return min_vel_y_; }
+  inline double getMaxY() const { return max_vel_y_; }
+  inline double getAccY() const { return acc_lim_y_; }
+  inline double getDecelY() const { return decel_lim_y_; }
 
-  inline double getMinSpeedXY() { return min_speed_xy_; }
+  inline double getMinSpeedXY() const { return min_speed_xy_; }
 
-  inline double getMinTheta() { return -max_vel_theta_; }
-  inline double getMaxTheta() { return max_vel_theta_; }
-  inline double getAccTheta() { return acc_lim_theta_; }
-  inline double getDecelTheta() { return decel_lim_theta_; }
-  inline double getMinSpeedTheta() { return min_speed_theta_; }
+  inline double getMinTheta() const { return -max_vel_theta_; }
+  inline double getMaxTheta() const { return max_vel_theta_; }
+  inline double getAccTheta() const { return acc_lim_theta_; }
+  inline double getDecelTheta() const { return decel_lim_theta_; }
+  inline double getMinSpeedTheta() const { return min_speed_theta_; }
+
+  /**
+   * @brief Number of times the parameters had been reconfigured when this snapshot was made
+   *
+   * Can be used as the key for anything computed from the limits.
+   */
+  inline uint32_t getVersion() const { return version_; }
 
   /**
    * @brief Check to see whether the combined x/y/theta velocities are valid
@@ -86,10 +97,11 @@ public:
    *
    * In Latin, quod si motus sit signum quaerit et movere ieiunium et significantissime comprehendite.
    */
-  bool isValidSpeed(double x, double y, double theta);
+  bool isValidSpeed(double x, double y, double theta) const;
 
-  using Ptr = std::shared_ptr<KinematicParameters>;
 protected:
+  friend class KinematicParameters;
+
   // For parameter descriptions, see cfg/KinematicParams.cfg
   double min_vel_x_, min_vel_y_;
   double max_vel_x_, max_vel_y_, max_vel_theta_;
@@ -103,8 +115,71 @@ protected:
   // Cached square values of min_speed_xy and max_speed_xy
   double min_speed_xy_sq_, max_speed_xy_sq_;
 
+  uint32_t version_;
+};
+
+/**
+ * @class KinematicParameters
+ * @brief A dynamically reconfigurable class containing one representation of the robot's kinematics
+ *
+ * Each reconfiguration publishes a new immutable KinematicLimits snapshot, so readers never see a half-updated set
+ * of parameters. Reading the current snapshot is a single atomic load, with no locks.
+ *
+ * The individual getters each read the latest snapshot. To read several values that are consistent with each other
+ * (i.e. for one planning iteration), get the snapshot once with getLimits.
+ */
+class KinematicParameters
+{
+public:
+  KinematicParameters();
+  void initialize(const ros::NodeHandle& nh);
+
+  /**
+   * @brief Get the current limits. The reference remains valid for the lifetime of this object.
+   */
+  inline const KinematicLimits& getLimits() const { return *current_.load(std::memory_order_acquire); }
+
+  inline uint32_t getVersion() const { return getLimits().getVersion(); }
+
+  inline double getMinX() const { return getLimits().getMinX(); }
+  inline double getMaxX() const { return getLimits().getMaxX(); }
+  inline double getAccX() const { return getLimits().getAccX(); }
+  inline double getDecelX() const { return getLimits().getDecelX(); }
+
+  inline double getMinY() const { return getLimits().getMinY(); }
+  inline double getMaxY() const { return getLimits().getMaxY(); }
+  inline double getAccY() const { return getLimits().getAccY(); }
+  inline double getDecelY() const { return getLimits().getDecelY(); }
+
+  inline double getMinSpeedXY() const { return getLimits().getMinSpeedXY(); }
+
+  inline double getMinTheta() const { return getLimits().getMinTheta(); }
+  inline double getMaxTheta() const { return getLimits().getMaxTheta(); }
+  inline double getAccTheta() const { return getLimits().getAccTheta(); }
+  inline double getDecelTheta() const { return getLimits().getDecelTheta(); }
+  inline double getMinSpeedTheta() const { return getLimits().getMinSpeedTheta(); }
+
+  /**
+   * @brief Check to see whether the combined x/y/theta velocities are valid with the current limits
+   * @see KinematicLimits::isValidSpeed
+   */
+  bool isValidSpeed(double x, double y, double theta) const { return getLimits().isValidSpeed(x, y, theta); }
+
+  using Ptr = std::shared_ptr<KinematicParameters>;
+protected:
   void reconfigureCB(KinematicParamsConfig &config, uint32_t level);
   std::shared_ptr<dynamic_reconfigure::Server<KinematicParamsConfig> > dsrv_;
+
+  /**
+   * @brief Make the given limits the current ones
+   */
+  void publish(std::unique_ptr<KinematicLimits> limits);
+
+  std::atomic<const KinematicLimits*> current_;
+
+  // Every snapshot is kept (reconfiguration is rare), so that readers never need to hold a reference count.
+  std::vector<std::unique_ptr<const KinematicLimits>> history_;
+  boost::mutex history_mutex_;
 };
 
 }  // namespace dwb_plugins
@@ -116,6 +116,14 @@ protected:
   virtual std::vector<double> getTimeSteps(const nav_2d_msgs::Twist2D& cmd_vel);
 
   KinematicParameters::Ptr kinematics_;
+
+  /**
+   * @brief Snapshot of the limits, taken once per iteration in startNewIteration (and first in initialize).
+   *
+   * Used both for sampling the twists and for generating their trajectories, so that a reconfiguration in the
+   * middle of an iteration does not mix two sets of limits.
+   */
+  const KinematicLimits* limits_ { nullptr };
   std::shared_ptr<VelocityIterator> velocity_iterator_;
 
   double sim_time_;
@@ -46,7 +46,12 @@ class VelocityIterator
 public:
   virtual ~VelocityIterator() {}
   virtual void initialize(ros::NodeHandle& nh, KinematicParameters::Ptr kinematics) = 0;
-  virtual void startNewIteration(const nav_2d_msgs::Twist2D& current_velocity, double dt) = 0;
+  /**
+   * @brief Start iterating over the twists reachable from current_velocity within dt
+   * @param limits The limits to use for the whole iteration (a snapshot from the KinematicParameters)
+   */
+  virtual void startNewIteration(const nav_2d_msgs::Twist2D& current_velocity, double dt,
+                                 const KinematicLimits& limits) = 0;
   virtual bool hasMoreTwists() = 0;
   virtual nav_2d_msgs::Twist2D nextTwist() = 0;
 };
@@ -37,24 +37,54 @@
 
 #include <dwb_plugins/velocity_iterator.h>
 #include <dwb_plugins/one_d_velocity_iterator.h>
+#include <vector>
 
 namespace dwb_plugins
 {
+/**
+ * @class XYThetaIterator
+ * @brief Iterates over the valid combinations of x, y and theta velocities
+ *
+ * At the start of each iteration, the valid combinations are written into a flat table,
+ * which is reused (without being rebuilt) for as long as the start velocity (rounded to
+ * velocity_cache_resolution), the time and the kinematic limits stay the same.
+ */
 class XYThetaIterator : public VelocityIterator
 {
 public:
-  XYThetaIterator() : kinematics_(nullptr), x_it_(nullptr), y_it_(nullptr), th_it_(nullptr) {}
+  XYThetaIterator() : kinematics_(nullptr), limits_(nullptr) {}
   void initialize(ros::NodeHandle& nh, KinematicParameters::Ptr kinematics) override;
-  void startNewIteration(const nav_2d_msgs::Twist2D& current_velocity, double dt) override;
+  void startNewIteration(const nav_2d_msgs::Twist2D& current_velocity, double dt,
+                         const KinematicLimits& limits) override;
   bool hasMoreTwists() override;
   nav_2d_msgs::Twist2D nextTwist() override;
+
+  /**
+   * @brief All of the valid twists for the current iteration, in the order they are returned by nextTwist
+   */
+  const std::vector<nav_2d_msgs::Twist2D>& getTwists() const { return twists_; }
+
 protected:
-  virtual bool isValidVelocity();
-  void iterateToValidVelocity();
+  virtual bool isValidVelocity(double x, double y, double theta) const;
+
+  /**
+   * @brief Fill twists_ with the valid combinations reachable from start_velocity
+   */
+  void buildTwists(const nav_2d_msgs::Twist2D& start_velocity, double dt);
+
   int vx_samples_, vy_samples_, vtheta_samples_;
+  double cache_resolution_;
   KinematicParameters::Ptr kinematics_;
+  const KinematicLimits* limits_;  ///< Snapshot of the limits given at the start of the iteration
+
+  std::vector<nav_2d_msgs::Twist2D> twists_;
+  size_t next_twist_index_ { 0 };
 
-  std::shared_ptr<OneDVelocityIterator> x_it_, y_it_, th_it_;
+  // The inputs used to build twists_
+  bool cache_valid_ { false };
+  nav_2d_msgs::Twist2D cached_velocity_;
+  double cached_dt_ { 0.0 };
+  uint32_t cached_version_ { 0 };
 };
 }  // namespace dwb_plugins
 
@@ -34,7 +34,9 @@
 
 #include <dwb_plugins/kinematic_parameters.h>
 #include <nav_2d_utils/parameters.h>
+#include <memory>
 #include <string>
+#include <utility>
 
 using nav_2d_utils::moveDeprecatedParameter;
 namespace dwb_plugins
@@ -60,14 +62,30 @@ void setDecelerationAsNeeded(const ros::NodeHandle& nh, const std::string dimens
   nh.setParam(decel_param, -accel);
 }
 
-KinematicParameters::KinematicParameters() :
+KinematicLimits::KinematicLimits() :
   min_vel_x_(0.0), min_vel_y_(0.0), max_vel_x_(0.0), max_vel_y_(0.0), max_vel_theta_(0.0),
   min_speed_xy_(0.0), max_speed_xy_(0.0), min_speed_theta_(0.0),
   acc_lim_x_(0.0), acc_lim_y_(0.0), acc_lim_theta_(0.0),
   decel_lim_x_(0.0), decel_lim_y_(0.0), decel_lim_theta_(0.0),
   min_speed_xy_sq_(0.0), max_speed_xy_sq_(0.0),
-  dsrv_(nullptr)
+  version_(0)
+{
+}
+
+bool KinematicLimits::isValidSpeed(double x, double y, double theta) const
+{
+  double vmag_sq = x * x + y * y;
+  if (max_speed_xy_ >= 0.0 && vmag_sq > max_speed_xy_sq_ + EPSILON) return false;
+  if (min_speed_xy_ >= 0.0 && vmag_sq + EPSILON < min_speed_xy_sq_ &&
+      min_speed_theta_ >= 0.0 && fabs(theta) + EPSILON < min_speed_theta_) return false;
+  if (vmag_sq == 0.0 && theta == 0.0) return false;
+  return true;
+}
+
+KinematicParameters::KinematicParameters() :
+  dsrv_(nullptr), current_(nullptr)
 {
+  publish(std::unique_ptr<KinematicLimits>(new KinematicLimits()));
 }
 
 void KinematicParameters::initialize(const ros::NodeHandle& nh)
@@ -92,34 +110,36 @@ void KinematicParameters::initialize(const ros::NodeHandle& nh)
 
 void KinematicParameters::reconfigureCB(KinematicParamsConfig &config, uint32_t level)
 {
-  min_vel_x_ = config.min_vel_x;
-  min_vel_y_ = config.min_vel_y;
-  max_vel_x_ = config.max_vel_x;
-  max_vel_y_ = config.max_vel_y;
-  max_vel_theta_ = config.max_vel_theta;
-
-  min_speed_xy_ = config.min_speed_xy;
-  max_speed_xy_ = config.max_speed_xy;
-  min_speed_xy_sq_ = min_speed_xy_ * min_speed_xy_;
-  max_speed_xy_sq_ = max_speed_xy_ * max_speed_xy_;
-  min_speed_theta_ = config.min_speed_theta;
-
-  acc_lim_x_ = config.acc_lim_x;
-  acc_lim_y_ = config.acc_lim_y;
-  acc_lim_theta_ = config.acc_lim_theta;
-  decel_lim_x_ = config.decel_lim_x;
-  decel_lim_y_ = config.decel_lim_y;
-  decel_lim_theta_ = config.decel_lim_theta;
+  // Fill in a new snapshot instead of overwriting the values that the planner may be reading
+  std::unique_ptr<KinematicLimits> limits(new KinematicLimits());
+  limits->min_vel_x_ = config.min_vel_x;
+  limits->min_vel_y_ = config.min_vel_y;
+  limits->max_vel_x_ = config.max_vel_x;
+  limits->max_vel_y_ = config.max_vel_y;
+  limits->max_vel_theta_ = config.max_vel_theta;
+
+  limits->min_speed_xy_ = config.min_speed_xy;
+  limits->max_speed_xy_ = config.max_speed_xy;
+  limits->min_speed_xy_sq_ = limits->min_speed_xy_ * limits->min_speed_xy_;
+  limits->max_speed_xy_sq_ = limits->max_speed_xy_ * limits->max_speed_xy_;
+  limits->min_speed_theta_ = config.min_speed_theta;
+
+  limits->acc_lim_x_ = config.acc_lim_x;
+  limits->acc_lim_y_ = config.acc_lim_y;
+  limits->acc_lim_theta_ = config.acc_lim_theta;
+  limits->decel_lim_x_ = config.decel_lim_x;
+  limits->decel_lim_y_ = config.decel_lim_y;
+  limits->decel_lim_theta_ = config.decel_lim_theta;
+  publish(std::move(limits));
 }
 
-bool KinematicParameters::isValidSpeed(double x, double y, double theta)
+void KinematicParameters::publish(std::unique_ptr<KinematicLimits> limits)
 {
-  double vmag_sq = x * x + y * y;
-  if (max_speed_xy_ >= 0.0 && vmag_sq > max_speed_xy_sq_ + EPSILON) return false;
-  if (min_speed_xy_ >= 0.0 && vmag_sq + EPSILON < min_speed_xy_sq_ &&
-      min_speed_theta_ >= 0.0 && fabs(theta) + EPSILON < min_speed_theta_) return false;
-  if (vmag_sq == 0.0 && theta == 0.0) return false;
-  return true;
+  boost::mutex::scoped_lock lock(history_mutex_);
+  limits->version_ = history_.size();
+  const KinematicLimits* raw_limits = limits.get();
+  history_.push_back(std::move(limits));
+  current_.store(raw_limits, std::memory_order_release);
 }
 
 }  // namespace dwb_plugins
@@ -78,7 +78,8 @@ void LimitedAccelGenerator::checkUseDwaParam(const ros::NodeHandle& nh)
 void LimitedAccelGenerator::startNewIteration(const nav_2d_msgs::Twist2D& current_velocity)
 {
   // Limit our search space to just those within the limited acceleration_time
-  velocity_iterator_->startNewIteration(current_velocity, acceleration_time_);
+  limits_ = &kinematics_->getLimits();
+  velocity_iterator_->startNewIteration(current_velocity, acceleration_time_, *limits_);
 }
 
 nav_2d_msgs::Twist2D LimitedAccelGenerator::computeNewVelocity(const nav_2d_msgs::Twist2D& cmd_vel,
@@ -35,6 +35,7 @@
 #include <dwb_plugins/standard_traj_generator.h>
 #include <dwb_plugins/xy_theta_iterator.h>
 #include <nav_2d_utils/parameters.h>
+#include <nav_2d_utils/trig_pose.h>
 #include <pluginlib/class_list_macros.h>
 #include <nav_core2/exceptions.h>
 #include <string>
@@ -50,6 +51,7 @@ void StandardTrajectoryGenerator::initialize(ros::NodeHandle& nh)
 {
   kinematics_ = std::make_shared<KinematicParameters>();
   kinematics_->initialize(nh);
+  limits_ = &kinematics_->getLimits();
   initializeIterator(nh);
 
   nh.param("sim_time", sim_time_, 1.7);
@@ -96,7 +98,8 @@ void StandardTrajectoryGenerator::checkUseDwaParam(const ros::NodeHandle& nh)
 
 void StandardTrajectoryGenerator::startNewIteration(const nav_2d_msgs::Twist2D& current_velocity)
 {
-  velocity_iterator_->startNewIteration(current_velocity, sim_time_);
+  limits_ = &kinematics_->getLimits();
+  velocity_iterator_->startNewIteration(current_velocity, sim_time_, *limits_);
 }
 
 bool StandardTrajectoryGenerator::hasMoreTwists()
@@ -179,9 +182,9 @@ nav_2d_msgs::Twist2D StandardTrajectoryGenerator::computeNewVelocity(const nav_2
     const nav_2d_msgs::Twist2D& start_vel, const double dt)
 {
   nav_2d_msgs::Twist2D new_vel;
-  new_vel.x = projectVelocity(start_vel.x, kinematics_->getAccX(), kinematics_->getDecelX(), dt, cmd_vel.x);
-  new_vel.y = projectVelocity(start_vel.y, kinematics_->getAccY(), kinematics_->getDecelY(), dt, cmd_vel.y);
-  new_vel.theta = projectVelocity(start_vel.theta, kinematics_->getAccTheta(), kinematics_->getDecelTheta(),
+  new_vel.x = projectVelocity(start_vel.x, limits_->getAccX(), limits_->getDecelX(), dt, cmd_vel.x);
+  new_vel.y = projectVelocity(start_vel.y, limits_->getAccY(), limits_->getDecelY(), dt, cmd_vel.y);
+  new_vel.theta = projectVelocity(start_vel.theta, limits_->getAccTheta(), limits_->getDecelTheta(),
                                   dt, cmd_vel.theta);
   return new_vel;
 }
@@ -189,9 +192,10 @@ nav_2d_msgs::Twist2D StandardTrajectoryGenerator::computeNewVelocity(const nav_2
 geometry_msgs::Pose2D StandardTrajectoryGenerator::computeNewPosition(const geometry_msgs::Pose2D start_pose,
                                                                       const nav_2d_msgs::Twist2D& vel, const double dt)
 {
+  // cos(theta + pi/2) = -sin(theta) and sin(theta + pi/2) = cos(theta), so only one cos/sin pair is needed
+  nav_2d_utils::TrigPose2D start(start_pose);
   geometry_msgs::Pose2D new_pose;
-  new_pose.x = start_pose.x + (vel.x * cos(start_pose.theta) + vel.y * cos(M_PI_2 + start_pose.theta)) * dt;
-  new_pose.y = start_pose.y + (vel.x * sin(start_pose.theta) + vel.y * sin(M_PI_2 + start_pose.theta)) * dt;
+  start.transformPoint(vel.x * dt, vel.y * dt, new_pose.x, new_pose.y);
   new_pose.theta = start_pose.theta + vel.theta * dt;
   return new_pose;
 }
@@ -34,74 +34,99 @@
 
 #include <dwb_plugins/xy_theta_iterator.h>
 #include <nav_2d_utils/parameters.h>
+#include <algorithm>
+#include <cmath>
 
 namespace dwb_plugins
 {
+/**
+ * @brief Round the value to the nearest multiple of resolution (if resolution is positive)
+ */
+inline double quantize(double value, double resolution)
+{
+  if (resolution <= 0.0) return value;
+  return std::round(value / resolution) * resolution;
+}
+
 void XYThetaIterator::initialize(ros::NodeHandle& nh, KinematicParameters::Ptr kinematics)
 {
   kinematics_ = kinematics;
   nh.param("vx_samples", vx_samples_, 20);
   nh.param("vy_samples", vy_samples_, 5);
   vtheta_samples_ = nav_2d_utils::loadParameterWithDeprecation(nh, "vtheta_samples", "vth_samples", 20);
+  nh.param("velocity_cache_resolution", cache_resolution_, 0.0);
+  twists_.reserve(std::max(vx_samples_, 1) * std::max(vy_samples_, 1) * std::max(vtheta_samples_, 1));
+  cache_valid_ = false;
 }
 
-void XYThetaIterator::startNewIteration(const nav_2d_msgs::Twist2D& current_velocity, double dt)
+void XYThetaIterator::startNewIteration(const nav_2d_msgs::Twist2D& current_velocity, double dt,
+                                        const KinematicLimits& limits)
 {
-  x_it_ = std::make_shared<OneDVelocityIterator>(current_velocity.x, kinematics_->getMinX(), kinematics_->getMaxX(),
-                                                 kinematics_->getAccX(), kinematics_->getDecelX(), dt, vx_samples_);
-  y_it_ = std::make_shared<OneDVelocityIterator>(current_velocity.y, kinematics_->getMinY(), kinematics_->getMaxY(),
-                                                 kinematics_->getAccY(), kinematics_->getDecelY(), dt, vy_samples_);
-  th_it_ = std::make_shared<OneDVelocityIterator>(current_velocity.theta,
-                                                  kinematics_->getMinTheta(), kinematics_->getMaxTheta(),
-                                                  kinematics_->getAccTheta(), kinematics_->getDecelTheta(),
-                                                  dt, vtheta_samples_);
-  if (!isValidVelocity())
+  limits_ = &limits;
+  next_twist_index_ = 0;
+
+  nav_2d_msgs::Twist2D start_velocity;
+  start_velocity.x = quantize(current_velocity.x, cache_resolution_);
+  start_velocity.y = quantize(current_velocity.y, cache_resolution_);
+  start_velocity.theta = quantize(current_velocity.theta, cache_resolution_);
+
+  if (cache_valid_ && cached_version_ == limits_->getVersion() && cached_dt_ == dt &&
+      cached_velocity_.x == start_velocity.x && cached_velocity_.y == start_velocity.y &&
+      cached_velocity_.theta == start_velocity.theta)
   {
-    iterateToValidVelocity();
+    return;
   }
+
+  buildTwists(start_velocity, dt);
+  cache_valid_ = true;
+  cached_version_ = limits_->getVersion();
+  cached_dt_ = dt;
+  cached_velocity_ = start_velocity;
 }
 
-bool XYThetaIterator::isValidVelocity()
+void XYThetaIterator::buildTwists(const nav_2d_msgs::Twist2D& start_velocity, double dt)
 {
-  return kinematics_->isValidSpeed(x_it_->getVelocity(), y_it_->getVelocity(), th_it_->getVelocity());
+  OneDVelocityIterator x_it(start_velocity.x, limits_->getMinX(), limits_->getMaxX(),
+                            limits_->getAccX(), limits_->getDecelX(), dt, vx_samples_);
+  OneDVelocityIterator y_it(start_velocity.y, limits_->getMinY(), limits_->getMaxY(),
+                            limits_->getAccY(), limits_->getDecelY(), dt, vy_samples_);
+  OneDVelocityIterator th_it(start_velocity.theta, limits_->getMinTheta(), limits_->getMaxTheta(),
+                             limits_->getAccTheta(), limits_->getDecelTheta(), dt, vtheta_samples_);
+
+  // Same order as iterating x, then y, then theta as nested loops, with theta innermost
+  twists_.clear();
+  nav_2d_msgs::Twist2D twist;
+  for (; !x_it.isFinished(); ++x_it)
+  {
+    twist.x = x_it.getVelocity();
+    for (y_it.reset(); !y_it.isFinished(); ++y_it)
+    {
+      twist.y = y_it.getVelocity();
+      for (th_it.reset(); !th_it.isFinished(); ++th_it)
+      {
+        twist.theta = th_it.getVelocity();
+        if (isValidVelocity(twist.x, twist.y, twist.theta))
+        {
+          twists_.push_back(twist);
+        }
+      }
+    }
+  }
 }
 
-bool XYThetaIterator::hasMoreTwists()
+bool XYThetaIterator::isValidVelocity(double x, double y, double theta) const
 {
-  return x_it_ && !x_it_->isFinished();
+  return limits_->isValidSpeed(x, y, theta);
 }
 
-
-nav_2d_msgs::Twist2D XYThetaIterator::nextTwist()
+bool XYThetaIterator::hasMoreTwists()
 {
-  nav_2d_msgs::Twist2D velocity;
-  velocity.x = x_it_->getVelocity();
-  velocity.y = y_it_->getVelocity();
-  velocity.theta = th_it_->getVelocity();
-
-  iterateToValidVelocity();
-
-  return velocity;
+  return next_twist_index_ < twists_.size();
 }
 
-void XYThetaIterator::iterateToValidVelocity()
+nav_2d_msgs::Twist2D XYThetaIterator::nextTwist()
 {
-  bool valid = false;
-  while (!valid && hasMoreTwists())
-  {
-    ++(*th_it_);
-    if (th_it_->isFinished())
-    {
-      th_it_->reset();
-      ++(*y_it_);
-      if (y_it_->isFinished())
-      {
-        y_it_->reset();
-        ++(*x_it_);
-      }
-    }
-    valid = isValidVelocity();
-  }
+  return twists_[next_twist_index_++];
 }
 
 }  // namespace dwb_plugins
@@ -0,0 +1,128 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2017, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <dwb_plugins/kinematic_parameters.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using dwb_plugins::KinematicLimits;
+
+/**
+ * @brief KinematicParameters with a public way to trigger the reconfigure callback
+ */
+class TestKinematicParameters : public dwb_plugins::KinematicParameters
+{
+public:
+  void setMaxSpeed(double speed)
+  {
+    dwb_plugins::KinematicParamsConfig config;
+    config.max_vel_x = speed;
+    config.max_vel_y = speed;
+    config.max_vel_theta = speed;
+    config.max_speed_xy = speed;
+    config.acc_lim_x = speed;
+    config.decel_lim_x = -speed;
+    reconfigureCB(config, 0);
+  }
+};
+
+TEST(KinematicParameters, snapshot_survives_reconfigure)
+{
+  TestKinematicParameters kinematics;
+  EXPECT_EQ(0U, kinematics.getVersion());
+
+  kinematics.setMaxSpeed(1.0);
+  const KinematicLimits& first = kinematics.getLimits();
+  EXPECT_EQ(1U, first.getVersion());
+  EXPECT_DOUBLE_EQ(1.0, first.getMaxX());
+  EXPECT_TRUE(kinematics.isValidSpeed(0.5, 0.0, 0.0));
+  EXPECT_FALSE(kinematics.isValidSpeed(1.5, 0.0, 0.0));
+
+  kinematics.setMaxSpeed(2.0);
+  kinematics.setMaxSpeed(3.0);
+
+  // The reference taken before the changes still holds the old values
+  EXPECT_EQ(1U, first.getVersion());
+  EXPECT_DOUBLE_EQ(1.0, first.getMaxX());
+  EXPECT_DOUBLE_EQ(-1.0, first.getDecelX());
+  EXPECT_FALSE(first.isValidSpeed(1.5, 0.0, 0.0));
+
+  // while the parameters report the latest ones
+  EXPECT_EQ(3U, kinematics.getVersion());
+  EXPECT_DOUBLE_EQ(3.0, kinematics.getMaxX());
+  EXPECT_DOUBLE_EQ(-3.0, kinematics.getDecelX());
+  EXPECT_TRUE(kinematics.isValidSpeed(1.5, 0.0, 0.0));
+}
+
+TEST(KinematicParameters, consistent_while_reconfiguring)
+{
+  TestKinematicParameters kinematics;
+  kinematics.setMaxSpeed(1.0);
+
+  std::atomic<bool> done(false);
+  std::thread reconfigure_thread([&kinematics, &done]()
+  {
+    for (int i = 2; i < 2000; i++)
+    {
+      kinematics.setMaxSpeed(i);
+    }
+    done = true;
+  });
+
+  // Every snapshot was made from a single config, so all of its values should match
+  unsigned int num_reads = 0;
+  uint32_t last_version = 0;
+  while (!done || num_reads == 0)
+  {
+    const KinematicLimits& limits = kinematics.getLimits();
+    double speed = limits.getMaxX();
+    ASSERT_EQ(speed, limits.getMaxY());
+    ASSERT_EQ(speed, limits.getMaxTheta());
+    ASSERT_EQ(speed, limits.getAccX());
+    ASSERT_EQ(-speed, limits.getDecelX());
+    ASSERT_EQ(static_cast<double>(limits.getVersion()), speed);
+    ASSERT_GE(limits.getVersion(), last_version);
+    last_version = limits.getVersion();
+    num_reads++;
+  }
+  reconfigure_thread.join();
+  EXPECT_EQ(1999U, kinematics.getVersion());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -220,6 +220,32 @@ TEST(VelocityIterator, nonzero)
                       0.24622144504490268, 0.0, 0.1);
 }
 
+TEST(VelocityIterator, cache_resolution)
+{
+  ros::NodeHandle nh("cache_resolution");
+  nh.setParam("velocity_cache_resolution", 0.1);
+  StandardTrajectoryGenerator gen;
+  gen.initialize(nh);
+  std::vector<nav_2d_msgs::Twist2D> twists = gen.getTwists(zero);
+  EXPECT_EQ(twists.size(), 1926U);
+
+  // Rounds to the same start velocity, so the same twists are used
+  nav_2d_msgs::Twist2D almost_zero;
+  almost_zero.x = 0.01;
+  std::vector<nav_2d_msgs::Twist2D> twists2 = gen.getTwists(almost_zero);
+  ASSERT_EQ(twists.size(), twists2.size());
+  for (unsigned int i = 0; i < twists.size(); i++)
+  {
+    EXPECT_DOUBLE_EQ(twists[i].x, twists2[i].x);
+    EXPECT_DOUBLE_EQ(twists[i].y, twists2[i].y);
+    EXPECT_DOUBLE_EQ(twists[i].theta, twists2[i].theta);
+  }
+
+  // Switching back and forth rebuilds the table
+  EXPECT_NE(gen.getTwists(forward).size(), 0U);
+  EXPECT_EQ(gen.getTwists(zero).size(), 1926U);
+}
+
 void matchPose(const geometry_msgs::Pose2D& a, const geometry_msgs::Pose2D& b)
 {
   EXPECT_DOUBLE_EQ(a.x, b.x);
@@ -413,6 +439,76 @@ TEST(TrajectoryGenerator, dwa)
   matchPose(res.poses[5], 1.5, 0, 0);
 }
 
+/**
+ * @brief StandardTrajectoryGenerator whose acceleration limits can be reconfigured directly
+ */
+class ReconfigurableGenerator : public StandardTrajectoryGenerator
+{
+public:
+  void setAccelerationX(double acc)
+  {
+    dwb_plugins::KinematicParamsConfig config;
+    config.min_vel_x = -1.0;
+    config.max_vel_x = 1.0;
+    config.min_vel_y = 0.0;
+    config.max_vel_y = 0.0;
+    config.max_vel_theta = 0.0;
+    config.min_speed_xy = -1.0;
+    config.max_speed_xy = 1.0;
+    config.min_speed_theta = 0.0;
+    config.acc_lim_x = acc;
+    config.decel_lim_x = -acc;
+    config.acc_lim_y = 0.0;
+    config.decel_lim_y = 0.0;
+    config.acc_lim_theta = 0.0;
+    config.decel_lim_theta = 0.0;
+    test_kinematics_->reconfigure(config);
+  }
+
+protected:
+  class Kinematics : public dwb_plugins::KinematicParameters
+  {
+  public:
+    void reconfigure(dwb_plugins::KinematicParamsConfig& config) { reconfigureCB(config, 0); }
+  };
+
+  void initializeIterator(ros::NodeHandle& nh) override
+  {
+    test_kinematics_ = std::make_shared<Kinematics>();
+    kinematics_ = test_kinematics_;
+    limits_ = &kinematics_->getLimits();
+    StandardTrajectoryGenerator::initializeIterator(nh);
+  }
+
+  std::shared_ptr<Kinematics> test_kinematics_;
+};
+
+TEST(TrajectoryGenerator, limits_fixed_for_iteration)
+{
+  ros::NodeHandle nh("limits_fixed_for_iteration");
+  nh.setParam("sim_time", 5.0);
+  nh.setParam("discretize_by_time", true);
+  nh.setParam("sim_granularity", 1.0);
+  ReconfigurableGenerator gen;
+  gen.initialize(nh);
+  gen.setAccelerationX(0.1);
+  gen.startNewIteration(zero);
+
+  // Reconfiguring during the iteration does not change its trajectories
+  gen.setAccelerationX(1.0);
+  dwb_msgs::Trajectory2D res = gen.generateTrajectory(origin, zero, forward);
+  ASSERT_EQ(res.poses.size(), 6U);
+  matchPose(res.poses[1], 0.1, 0, 0);
+  matchPose(res.poses[5], 1.2, 0, 0);
+
+  // The next iteration uses the new limits
+  gen.startNewIteration(zero);
+  res = gen.generateTrajectory(origin, zero, forward);
+  ASSERT_EQ(res.poses.size(), 6U);
+  matchPose(res.poses[1], 0.3, 0, 0);
+  matchPose(res.poses[5], 1.5, 0, 0);
+}
+
 int main(int argc, char **argv)
 {
   forward.x = 0.3;
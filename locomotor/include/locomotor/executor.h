@@ -41,6 +41,18 @@
 
 namespace locomotor
 {
+/**
+ * @brief How urgent a callback is, for executors that can run callbacks out of order. Lower values are more urgent.
+ */
+enum class CallbackPriority
+{
+  CONTROL = 0,
+  COSTMAP = 1,
+  GLOBAL_PLANNING = 2,
+  PUBLISHING = 3
+};
+const unsigned int NUM_CALLBACK_PRIORITIES = 4;
+
 /**
  * @class LocomotorCallback
  * @brief Extension of ros::CallbackInterface so we can insert things on the ROS Callback Queue
@@ -88,8 +100,9 @@ public:
   /**
    * @brief Add a callback to this executor's CallbackQueue
    * @param f LocomotorCallback
+   * @param priority How urgent the callback is. Ignored by this class, which runs callbacks in order.
    */
-  void addCallback(LocomotorCallback::Function f);
+  virtual void addCallback(LocomotorCallback::Function f, CallbackPriority priority = CallbackPriority::CONTROL);
 protected:
   /**
    * @brief Gets the queue for this executor
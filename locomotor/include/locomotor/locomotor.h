@@ -42,11 +42,14 @@
 #include <locomotor_msgs/ResultCode.h>
 #include <nav_core2/exceptions.h>
 #include <nav_core2/costmap.h>
+#include <nav_core2/snapshot_costmap.h>
+#include <nav_core2/transform_cache.h>
 #include <nav_core2/global_planner.h>
 #include <nav_core2/local_planner.h>
 #include <pluginlib/class_loader.h>
 #include <nav_2d_utils/odom_subscriber.h>
 #include <nav_2d_utils/plugin_mux.h>
+#include <boost/thread/mutex.hpp>
 #include <map>
 #include <string>
 #include <vector>
@@ -95,6 +98,11 @@ public:
   void initializeLocalPlanners(Executor& ex);
   /** @} */  // end of InitializeMethods group
 
+  /**
+   * @brief Override the use_costmap_snapshots parameter. Must be called before the costmaps are initialized.
+   */
+  void setUseCostmapSnapshots(bool use_costmap_snapshots) { use_costmap_snapshots_ = use_costmap_snapshots; }
+
   /**
    * @brief Starts a new navigation to the given goal
    * @param goal The goal to navigate to
@@ -162,7 +170,10 @@ public:
                                 NavigationFailureCallback cb = nullptr);
   /** @} */  // end of ActionRequests group
 
-  const locomotor_msgs::NavigationState& getNavigationState() const { return state_; }
+  /**
+   * @brief A copy of the current navigation state, consistent with itself even while planning/costmap updates run
+   */
+  locomotor_msgs::NavigationState getNavigationState() const;
 
   // Global/Local Planner Access
   std::vector<std::string> getGlobalPlannerNames() const { return global_planner_mux_.getPluginNames(); }
@@ -196,7 +207,7 @@ protected:
   void doCostmapUpdate(nav_core2::Costmap& costmap, Executor& result_ex,
                        CostmapUpdateCallback cb, CostmapUpdateExceptionCallback fail_cb);
   void makeGlobalPlan(Executor& result_ex, GlobalPlanCallback cb, PlannerExceptionCallback fail_cb);
-  void makeLocalPlan(Executor& result_ex, LocalPlanCallback cb, PlannerExceptionCallback fail_cb,
+  void makeLocalPlan(Executor& work_ex, Executor& result_ex, LocalPlanCallback cb, PlannerExceptionCallback fail_cb,
                      NavigationCompleteCallback complete_cb);
   /** @} */  // end of ActualActions group
 
@@ -207,26 +218,75 @@ protected:
    */
   virtual void switchLocalPlannerCallback(const std::string& old_planner, const std::string& new_planner);
 
+  /**
+   * @brief Give the goal and the global plan to a local planner, each only if it does not already have the latest one
+   *
+   * Requires standby_mutex_ to be held.
+   * @param name Name used on local_planner_mux of the planner
+   */
+  void syncLocalPlanner(const std::string& name);
+
+  /**
+   * @brief Keep the inactive local planners up to date and warmed up, at most once every warm_standby_period seconds
+   * @param pose Robot pose in the local costmap's frame, as used for the active planner
+   * @param velocity Robot velocity, as used for the active planner
+   */
+  void updateStandbyLocalPlanners(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity);
+
+  /**
+   * @brief The costmap the planners should read from, either the costmap itself or a snapshot of it
+   */
+  nav_core2::Costmap::Ptr getPlanningCostmap(nav_core2::Costmap::Ptr costmap,
+                                             std::shared_ptr<nav_core2::SnapshotCostmap> snapshot) const;
+
   // Costmap Loader
   pluginlib::ClassLoader<nav_core2::Costmap> costmap_loader_;
 
   // Global Planners and Costmap
   nav_2d_utils::PluginMux<nav_core2::GlobalPlanner> global_planner_mux_;
   nav_core2::Costmap::Ptr global_costmap_;
+  std::shared_ptr<nav_core2::SnapshotCostmap> global_snapshot_;
 
   // Local Planners and Costmap
   nav_2d_utils::PluginMux<nav_core2::LocalPlanner> local_planner_mux_;
   nav_core2::Costmap::Ptr local_costmap_;
+  std::shared_ptr<nav_core2::SnapshotCostmap> local_snapshot_;
+
+  // If true, the planners read from snapshots of the costmaps instead of locking them while planning
+  bool use_costmap_snapshots_;
 
   // Tools for getting the position and velocity of the robot
-  nav_2d_msgs::Pose2DStamped getRobotPose(const std::string& target_frame) const;
+  nav_2d_msgs::Pose2DStamped getRobotPose(const std::string& target_frame,
+                                          nav_core2::TransformCache* cache = nullptr) const;
   TFListenerPtr tf_;
+
+  // Transforms used during one cycle of local planning, shared with the local planners. Cleared in makeLocalPlan.
+  nav_core2::TransformCache::Ptr local_tf_cache_;
   bool use_latest_pose_;
   std::shared_ptr<nav_2d_utils::OdomSubscriber> odom_sub_;
 
+  // Inactive local planners that are kept up to date (and warmed up) so switching to them needs no setGoalPose/setPlan.
+  // Maps the planner name to the goal_version_ and plan_version_ it was last given.
+  struct SyncedVersions
+  {
+    unsigned int goal_version;
+    unsigned int plan_version;
+  };
+  double warm_standby_period_;
+  ros::WallTime last_standby_update_;
+  std::map<std::string, SyncedVersions> standby_versions_;
+  boost::mutex standby_mutex_;
+
+  // Count the changes to the goal and to the global plan in state_
+  unsigned int goal_version_, plan_version_;
+
   // Core Variables
   ros::NodeHandle private_nh_;
+
+  // Written by the costmap/planning threads and read by the feedback publisher. It and the versions above are only
+  // accessed with state_mutex_ held.
   locomotor_msgs::NavigationState state_;
+  mutable boost::mutex state_mutex_;
   std::string robot_base_frame_;
 
   // Publishers
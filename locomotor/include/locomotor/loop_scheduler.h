@@ -0,0 +1,154 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOCOMOTOR_LOOP_SCHEDULER_H
+#define LOCOMOTOR_LOOP_SCHEDULER_H
+
+#include <ros/ros.h>
+#include <boost/thread/mutex.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace locomotor
+{
+/**
+ * @brief Counts of values in buckets whose bounds are fractions of the desired loop duration
+ *
+ * counts[i] is the number of values less than bounds[i] (and not in an earlier bucket). The last count is for
+ * the values greater than or equal to the last bound.
+ */
+struct LoopHistogram
+{
+  std::vector<double> bounds;
+  std::vector<uint64_t> counts;
+
+  explicit LoopHistogram(const std::vector<double>& bounds);
+  void add(double fraction);
+  void reset();
+  std::string toString() const;
+};
+
+/**
+ * @brief Statistics for one periodic loop
+ */
+struct LoopStatistics
+{
+  uint64_t iterations { 0 };    ///< Number of iterations started
+  uint64_t skipped { 0 };       ///< Number of requests dropped because the previous iteration was still running
+  uint64_t overruns { 0 };      ///< Number of iterations that took longer than the desired duration
+  LoopHistogram jitter;         ///< How late each iteration started, relative to the desired duration
+  LoopHistogram durations;      ///< How long each iteration took, relative to the desired duration
+
+  LoopStatistics();
+};
+
+/**
+ * @class LoopScheduler
+ * @brief Tracks the deadline of a periodic loop (e.g. the control loop) that runs asynchronously
+ *
+ * Each iteration is started with tryStart and ended with finish or cancel. If a new iteration is requested before the
+ * previous one has ended, the request is dropped, since the running iteration will produce an answer sooner than a
+ * queued one would. Thus requests are coalesced instead of piling up on the executors when the loop is overrunning.
+ *
+ * After overruns_before_degrading consecutive overruns, the loop is marked as degraded, so that the state machine
+ * can switch to something cheaper. It recovers after recoveries_before_restoring consecutive iterations on time.
+ *
+ * All methods are thread-safe.
+ */
+class LoopScheduler
+{
+public:
+  /**
+   * @brief Constructor
+   * @param name Name of the loop, used for logging
+   * @param desired_duration How long each iteration should take
+   * @param overruns_before_degrading Number of consecutive overruns before the loop is degraded. Zero to never degrade.
+   * @param recoveries_before_restoring Number of consecutive iterations on time before the loop is no longer degraded
+   */
+  LoopScheduler(const std::string& name, const ros::Duration& desired_duration,
+                unsigned int overruns_before_degrading = 0, unsigned int recoveries_before_restoring = 10);
+
+  /**
+   * @brief Try to start a new iteration
+   * @param expected_start When the iteration should have started, i.e. ros::TimerEvent::current_expected.
+   *                       If zero (i.e. the iteration was not triggered by the timer), the jitter is not recorded.
+   * @return False if the previous iteration is still running, in which case the request should be dropped
+   */
+  bool tryStart(const ros::Time& expected_start = ros::Time());
+
+  /**
+   * @brief End the current iteration, and record how long it took
+   * @return The duration of the iteration
+   */
+  ros::Duration finish();
+
+  /**
+   * @brief End the current iteration without recording it (i.e. when it failed)
+   */
+  void cancel();
+
+  bool isRunning() const;
+
+  /**
+   * @brief Whether there have been enough consecutive overruns that the loop is degraded
+   */
+  bool isDegraded() const;
+
+  const std::string& getName() const { return name_; }
+  const ros::Duration& getDesiredDuration() const { return desired_duration_; }
+
+  LoopStatistics getStatistics() const;
+  void resetStatistics();
+
+  /**
+   * @brief Human readable summary of the statistics, for logging
+   */
+  std::string getSummary() const;
+
+protected:
+  std::string name_;
+  ros::Duration desired_duration_;
+  unsigned int overruns_before_degrading_, recoveries_before_restoring_;
+
+  mutable boost::mutex mutex_;
+  bool running_ { false };
+  ros::WallTime start_time_;
+  unsigned int consecutive_overruns_ { 0 }, consecutive_on_time_ { 0 };
+  bool degraded_ { false };
+  LoopStatistics stats_;
+};
+}  // namespace locomotor
+
+#endif  // LOCOMOTOR_LOOP_SCHEDULER_H
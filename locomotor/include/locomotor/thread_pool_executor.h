@@ -0,0 +1,179 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOCOMOTOR_THREAD_POOL_EXECUTOR_H
+#define LOCOMOTOR_THREAD_POOL_EXECUTOR_H
+
+#include <locomotor/executor.h>
+#include <boost/thread.hpp>
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace locomotor
+{
+class ThreadPoolExecutor;
+
+/**
+ * @class ThreadPool
+ * @brief A fixed number of worker threads that run the callbacks of one or more ThreadPoolExecutors
+ *
+ * A free worker runs the most urgent callback waiting in any executor that is not already running one (the oldest
+ * one if there is a tie), so the workers are shared by the executors as needed. Idle workers wait on a condition
+ * variable. Callbacks that are already running are never interrupted.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Constructor
+   * @param num_threads Number of worker threads
+   * @param cpu_affinity If not empty, worker i will be pinned to the CPU cpu_affinity[i % cpu_affinity.size()]
+   */
+  explicit ThreadPool(unsigned int num_threads, const std::vector<int>& cpu_affinity = std::vector<int>());
+
+  /**
+   * @brief Destructor. Waits for the running callbacks to finish.
+   */
+  ~ThreadPool();
+
+  unsigned int getNumThreads() const { return workers_.size(); }
+
+protected:
+  friend class ThreadPoolExecutor;
+
+  void workerLoop();
+
+  /**
+   * @brief Choose the executor whose most urgent waiting callback should run next. Requires mutex_ to be held.
+   * @return nullptr if no executor has a callback that can run now
+   */
+  ThreadPoolExecutor* chooseExecutor() const;
+
+  std::vector<boost::thread> workers_;
+
+  // Everything below (including the queues of the executors) is guarded by mutex_
+  boost::mutex mutex_;
+  boost::condition_variable condition_;
+  std::vector<ThreadPoolExecutor*> executors_;
+  uint64_t next_sequence_ { 0 };
+  bool running_ { true };
+};
+
+/**
+ * @class ThreadPoolExecutor
+ * @brief Executor that runs the Locomotor callbacks on a shared ThreadPool, most urgent first
+ *
+ * Like the base Executor, the callbacks of one ThreadPoolExecutor run one at a time (so Locomotor can rely on the
+ * callbacks of a single executor never running concurrently), but the waiting callbacks are run in order of their
+ * CallbackPriority, and in the order they were added within each priority. Thus a control callback never has to wait
+ * behind more than one slow global planning callback. Several executors can share one pool, in which case each
+ * of them is serialized separately and the workers go to the most urgent callbacks first.
+ *
+ * The NodeHandle from getNodeHandle still uses this executor's own CallbackQueue (with a single thread) so that the
+ * ROS subscriptions and timers of components initialized with this executor work as usual.
+ */
+class ThreadPoolExecutor : public Executor
+{
+public:
+  /**
+   * @brief Statistics for the callbacks of a single priority
+   */
+  struct LaneMetrics
+  {
+    uint64_t callbacks_run { 0 };
+    unsigned int queue_depth { 0 };      ///< Number of callbacks currently waiting
+    unsigned int max_queue_depth { 0 };
+    ros::WallDuration total_latency;     ///< Total time callbacks spent waiting to be run
+    ros::WallDuration max_latency;
+  };
+
+  /**
+   * @brief Constructor
+   * @param base_nh Base NodeHandle that this executor's NodeHandle will be derived from
+   * @param pool The pool to run the callbacks on
+   */
+  ThreadPoolExecutor(const ros::NodeHandle& base_nh, std::shared_ptr<ThreadPool> pool);
+
+  /**
+   * @brief Destructor. Waits for the running callback to finish, and drops those that have not started.
+   */
+  ~ThreadPoolExecutor() override;
+
+  void addCallback(LocomotorCallback::Function f, CallbackPriority priority = CallbackPriority::CONTROL) override;
+
+  std::shared_ptr<ThreadPool> getPool() const { return pool_; }
+
+  /**
+   * @brief Get the statistics for each priority, indexed by the CallbackPriority value
+   */
+  std::vector<LaneMetrics> getMetrics() const;
+
+  /**
+   * @brief Reset the statistics (except the current queue depths)
+   */
+  void resetMetrics();
+
+protected:
+  friend class ThreadPool;
+
+  struct Task
+  {
+    LocomotorCallback::Function function;
+    ros::WallTime enqueued;
+    uint64_t sequence;
+  };
+
+  /**
+   * @brief The most urgent waiting task, or nullptr if there is none or a callback is already running.
+   * Requires the pool's mutex to be held.
+   */
+  const Task* peekTask(unsigned int& priority) const;
+
+  /**
+   * @brief Remove the most urgent task and mark the executor as running. Requires the pool's mutex to be held.
+   */
+  Task popTask();
+
+  std::shared_ptr<ThreadPool> pool_;
+
+  // Guarded by the pool's mutex
+  std::deque<Task> lanes_[NUM_CALLBACK_PRIORITIES];
+  bool busy_ { false };
+  std::vector<LaneMetrics> metrics_;
+};
+}  // namespace locomotor
+
+#endif  // LOCOMOTOR_THREAD_POOL_EXECUTOR_H
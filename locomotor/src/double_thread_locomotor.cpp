@@ -33,8 +33,13 @@
  */
 #include <locomotor/locomotor.h>
 #include <locomotor/locomotor_action_server.h>
+#include <locomotor/loop_scheduler.h>
+#include <locomotor/thread_pool_executor.h>
 #include <nav_2d_utils/conversions.h>
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace locomotor
 {
@@ -51,13 +56,28 @@ using nav_core2::getResultCode;
  * When the first global plan is generated, it starts a timer to update the local costmap on the local_planning_ex.
  * When the local costmap update finishes, it requests a local plan on the local_planning_ex.
  * When the goal is reached, it stops both the timers.
+ *
+ * If the pipeline_local_planning parameter is true, the local costmap is updated on a third executor, and the
+ * local planner does not wait for the update. Each control cycle starts a local costmap update (unless the previous
+ * one is still running) and at the same time requests a local plan using the snapshot of the costmap from the most
+ * recently completed update. This requires (and turns on) costmap snapshots.
+ *
+ * If the thread_pool_size parameter is positive, global_planning_ex (and the local costmap executor, if pipelined)
+ * are ThreadPoolExecutors sharing a pool of that many threads, so that with fewer threads than executors, local
+ * costmap updates run ahead of waiting global planning callbacks. The callbacks of each executor still run one at a
+ * time. local_planning_ex stays on the global CallbackQueue, with the timers.
+ *
+ * The deadlines of both loops are tracked with LoopSchedulers. If a timer fires while the previous iteration of its
+ * loop is still running, that tick is skipped rather than queued. If the degraded_local_planner parameter is set,
+ * Locomotor switches to that local planner after overruns_before_degrading consecutive control loop overruns, and
+ * switches back after recoveries_before_restoring consecutive control loops on time.
  */
 class DoubleThreadLocomotor
 {
 public:
   explicit DoubleThreadLocomotor(const ros::NodeHandle& private_nh)
     : private_nh_(private_nh), locomotor_(private_nh_),
-      local_planning_ex_(private_nh_, false), global_planning_ex_(private_nh_),
+      local_planning_ex_(private_nh_, false),
       as_(private_nh_, std::bind(&DoubleThreadLocomotor::setGoal, this, std::placeholders::_1))
   {
     private_nh_.param("planner_frequency", planner_frequency_, planner_frequency_);
@@ -69,27 +89,74 @@ public:
     control_loop_timer_ = private_nh_.createTimer(desired_control_duration_,
                                                   &DoubleThreadLocomotor::controlLoopCallback,
                                                   this, false, false);  // one_shot=false(default), auto_start=false
-    locomotor_.initializeGlobalCostmap(global_planning_ex_);
-    locomotor_.initializeGlobalPlanners(global_planning_ex_);
-    locomotor_.initializeLocalCostmap(local_planning_ex_);
+
+    int overruns_before_degrading, recoveries_before_restoring;
+    private_nh_.param("overruns_before_degrading", overruns_before_degrading, 5);
+    private_nh_.param("recoveries_before_restoring", recoveries_before_restoring, 20);
+    private_nh_.param("degraded_local_planner", degraded_local_planner_, std::string(""));
+    if (degraded_local_planner_.empty())
+    {
+      overruns_before_degrading = 0;
+    }
+    plan_loop_ = std::make_shared<LoopScheduler>("plan", desired_plan_duration_);
+    control_loop_ = std::make_shared<LoopScheduler>("control", desired_control_duration_,
+                                                    std::max(overruns_before_degrading, 0),
+                                                    std::max(recoveries_before_restoring, 1));
+
+    int thread_pool_size;
+    private_nh_.param("thread_pool_size", thread_pool_size, 0);
+    if (thread_pool_size > 0)
+    {
+      std::vector<int> cpu_affinity;
+      private_nh_.getParam("thread_pool_cpus", cpu_affinity);
+      thread_pool_ = std::make_shared<ThreadPool>(thread_pool_size, cpu_affinity);
+    }
+    global_planning_ex_ = makeExecutor();
+
+    private_nh_.param("pipeline_local_planning", pipeline_local_planning_, false);
+    if (pipeline_local_planning_)
+    {
+      local_costmap_ex_ = makeExecutor();
+      locomotor_.setUseCostmapSnapshots(true);
+    }
+    locomotor_.initializeGlobalCostmap(*global_planning_ex_);
+    locomotor_.initializeGlobalPlanners(*global_planning_ex_);
+    locomotor_.initializeLocalCostmap(local_costmap_ex_ ? *local_costmap_ex_ : local_planning_ex_);
     locomotor_.initializeLocalPlanners(local_planning_ex_);
   }
 
   void setGoal(nav_2d_msgs::Pose2DStamped goal)
   {
     locomotor_.setGoal(goal);
+    local_costmap_ready_ = false;
+    plan_loop_->resetStatistics();
+    control_loop_->resetStatistics();
     plan_loop_timer_.start();
   }
 
 protected:
+  /**
+   * @brief Create an executor with its own thread, or on the thread pool if there is one
+   */
+  std::shared_ptr<Executor> makeExecutor()
+  {
+    if (thread_pool_)
+    {
+      return std::make_shared<ThreadPoolExecutor>(private_nh_, thread_pool_);
+    }
+    return std::make_shared<Executor>(private_nh_);
+  }
+
   void planLoopCallback(const ros::TimerEvent& event)
   {
-    requestGlobalCostmapUpdate();
+    requestGlobalCostmapUpdate(event.current_expected);
   }
 
-  void requestGlobalCostmapUpdate()
+  void requestGlobalCostmapUpdate(const ros::Time& expected_start = ros::Time())
   {
-    locomotor_.requestGlobalCostmapUpdate(global_planning_ex_, global_planning_ex_,
+    // If the previous global plan has not been made yet, its result will be newer than the one requested here
+    if (!plan_loop_->tryStart(expected_start)) return;
+    locomotor_.requestGlobalCostmapUpdate(*global_planning_ex_, *global_planning_ex_,
       std::bind(&DoubleThreadLocomotor::onGlobalCostmapUpdate, this, std::placeholders::_1),
       std::bind(&DoubleThreadLocomotor::onGlobalCostmapException, this, std::placeholders::_1, std::placeholders::_2));
   }
@@ -104,13 +171,14 @@ protected:
   void onGlobalCostmapUpdate(const ros::Duration& planning_time)
   {
     // Run the global planning on the separate executor, but put the result on the main executor
-    locomotor_.requestGlobalPlan(global_planning_ex_, local_planning_ex_,
+    locomotor_.requestGlobalPlan(*global_planning_ex_, local_planning_ex_,
       std::bind(&DoubleThreadLocomotor::onNewGlobalPlan, this, std::placeholders::_1, std::placeholders::_2),
       std::bind(&DoubleThreadLocomotor::onGlobalPlanningException, this, std::placeholders::_1, std::placeholders::_2));
   }
 
   void onGlobalCostmapException(nav_core2::NavCore2ExceptionPtr e_ptr, const ros::Duration& planning_time)
   {
+    plan_loop_->cancel();
     requestNavigationFailure(makeResultCode(locomotor_msgs::ResultCode::GLOBAL_COSTMAP, getResultCode(e_ptr),
                                             "Global Costmap failure."));
   }
@@ -120,11 +188,12 @@ protected:
     locomotor_.publishPath(new_global_plan);
     locomotor_.getCurrentLocalPlanner().setPlan(new_global_plan);
 
-    if (planning_time > desired_plan_duration_)
+    ros::Duration loop_time = plan_loop_->finish();
+    if (loop_time > desired_plan_duration_)
     {
       ROS_WARN_NAMED("locomotor", "Global planning missed its desired rate of %.4fHz... "
                      "the loop actually took %.4f seconds (>%.4f).",
-                     planner_frequency_, planning_time.toSec(), desired_plan_duration_.toSec());
+                     planner_frequency_, loop_time.toSec(), desired_plan_duration_.toSec());
     }
     control_loop_timer_.start();
     as_.publishFeedback(locomotor_.getNavigationState());
@@ -133,18 +202,48 @@ protected:
   void onGlobalPlanningException(nav_core2::NavCore2ExceptionPtr e_ptr, const ros::Duration& planning_time)
   {
     ROS_ERROR_NAMED("Locomotor", "Global planning error. Giving up.");
+    plan_loop_->cancel();
     requestNavigationFailure(makeResultCode(locomotor_msgs::ResultCode::GLOBAL_PLANNER, getResultCode(e_ptr),
                                             "Global Planning Failure."));
   }
 
   void controlLoopCallback(const ros::TimerEvent& event)
   {
+    // Skip this tick if the last control loop is still running, instead of queueing up a stale request
+    if (!control_loop_->tryStart(event.current_expected)) return;
+
+    if (pipeline_local_planning_)
+    {
+      pipelinedControlLoop();
+      return;
+    }
     locomotor_.requestLocalCostmapUpdate(local_planning_ex_, local_planning_ex_,
       std::bind(&DoubleThreadLocomotor::onLocalCostmapUpdate, this, std::placeholders::_1),
       std::bind(&DoubleThreadLocomotor::onLocalCostmapException, this, std::placeholders::_1, std::placeholders::_2));
   }
 
-  void onLocalCostmapUpdate(const ros::Duration& planning_time)
+  void pipelinedControlLoop()
+  {
+    if (!local_update_pending_)
+    {
+      local_update_pending_ = true;
+      locomotor_.requestLocalCostmapUpdate(*local_costmap_ex_, local_planning_ex_,
+        std::bind(&DoubleThreadLocomotor::onPipelinedLocalCostmapUpdate, this, std::placeholders::_1),
+        std::bind(&DoubleThreadLocomotor::onLocalCostmapException, this, std::placeholders::_1, std::placeholders::_2));
+    }
+
+    // Don't plan for a new goal until the local costmap has been updated at least once
+    if (local_costmap_ready_)
+    {
+      requestLocalPlan();
+    }
+    else
+    {
+      control_loop_->cancel();
+    }
+  }
+
+  void requestLocalPlan()
   {
     locomotor_.requestLocalPlan(local_planning_ex_, local_planning_ex_,
       std::bind(&DoubleThreadLocomotor::onNewLocalPlan, this, std::placeholders::_1, std::placeholders::_2),
@@ -152,8 +251,30 @@ protected:
       std::bind(&DoubleThreadLocomotor::onNavigationCompleted, this));
   }
 
+  void onLocalCostmapUpdate(const ros::Duration& planning_time)
+  {
+    requestLocalPlan();
+  }
+
+  void onPipelinedLocalCostmapUpdate(const ros::Duration& update_time)
+  {
+    local_update_pending_ = false;
+    local_costmap_ready_ = true;
+    if (update_time > desired_control_duration_)
+    {
+      ROS_WARN_NAMED("locomotor", "Local costmap update missed the desired control rate of %.4fHz... "
+                     "the update actually took %.4f seconds (>%.4f).",
+                     controller_frequency_, update_time.toSec(), desired_control_duration_.toSec());
+    }
+  }
+
   void onLocalCostmapException(nav_core2::NavCore2ExceptionPtr e_ptr, const ros::Duration& planning_time)
   {
+    local_update_pending_ = false;
+    if (!pipeline_local_planning_)
+    {
+      control_loop_->cancel();
+    }
     requestNavigationFailure(makeResultCode(locomotor_msgs::ResultCode::LOCAL_COSTMAP, getResultCode(e_ptr),
                                             "Local Costmap failure."));
   }
@@ -161,18 +282,48 @@ protected:
   void onNewLocalPlan(nav_2d_msgs::Twist2DStamped new_command, const ros::Duration& planning_time)
   {
     locomotor_.publishTwist(new_command);
-    if (planning_time > desired_control_duration_)
+    ros::Duration loop_time = control_loop_->finish();
+    if (loop_time > desired_control_duration_)
     {
       ROS_WARN_NAMED("locomotor", "Control loop missed its desired rate of %.4fHz... "
                      "the loop actually took %.4f seconds (>%.4f).",
-                     controller_frequency_, planning_time.toSec(), desired_control_duration_.toSec());
+                     controller_frequency_, loop_time.toSec(), desired_control_duration_.toSec());
     }
+    updateDegradedLocalPlanner();
     as_.publishFeedback(locomotor_.getNavigationState());
   }
 
+  /**
+   * @brief Switch to/from the degraded_local_planner when the control loop becomes degraded/recovers
+   */
+  void updateDegradedLocalPlanner()
+  {
+    if (degraded_local_planner_.empty()) return;
+    bool using_degraded = !normal_local_planner_.empty();
+    if (control_loop_->isDegraded() == using_degraded) return;
+
+    if (!using_degraded)
+    {
+      normal_local_planner_ = locomotor_.getCurrentLocalPlannerName();
+      if (normal_local_planner_ == degraded_local_planner_ || !locomotor_.useLocalPlanner(degraded_local_planner_))
+      {
+        normal_local_planner_.clear();
+        return;
+      }
+      ROS_WARN_NAMED("Locomotor", "Switching to the degraded local planner %s.", degraded_local_planner_.c_str());
+    }
+    else
+    {
+      ROS_INFO_NAMED("Locomotor", "Switching back to the local planner %s.", normal_local_planner_.c_str());
+      locomotor_.useLocalPlanner(normal_local_planner_);
+      normal_local_planner_.clear();
+    }
+  }
+
   void onLocalPlanningException(nav_core2::NavCore2ExceptionPtr e_ptr, const ros::Duration& planning_time)
   {
     ROS_WARN_NAMED("Locomotor", "Local planning error. Creating new global plan.");
+    control_loop_->cancel();
     control_loop_timer_.stop();
     requestGlobalCostmapUpdate();
   }
@@ -180,6 +331,8 @@ protected:
   void onNavigationCompleted()
   {
     ROS_INFO_NAMED("Locomotor", "Plan completed! Stopping.");
+    control_loop_->cancel();
+    logLoopStatistics();
     plan_loop_timer_.stop();
     control_loop_timer_.stop();
     as_.completeNavigation();
@@ -189,9 +342,16 @@ protected:
   {
     plan_loop_timer_.stop();
     control_loop_timer_.stop();
+    logLoopStatistics();
     as_.failNavigation(result);
   }
 
+  void logLoopStatistics()
+  {
+    ROS_INFO_NAMED("Locomotor", "%s", plan_loop_->getSummary().c_str());
+    ROS_INFO_NAMED("Locomotor", "%s", control_loop_->getSummary().c_str());
+  }
+
   ros::NodeHandle private_nh_;
   // Locomotor Object
   Locomotor locomotor_;
@@ -201,8 +361,21 @@ protected:
   ros::Duration desired_plan_duration_, desired_control_duration_;
   ros::Timer plan_loop_timer_, control_loop_timer_;
 
-  // The Two Executors
-  Executor local_planning_ex_, global_planning_ex_;
+  // Deadline Tracking
+  std::shared_ptr<LoopScheduler> plan_loop_, control_loop_;
+  std::string degraded_local_planner_;
+  std::string normal_local_planner_;  // The planner to switch back to, if currently using the degraded planner
+
+  // The Two Executors (global_planning_ex_ may be on the thread pool)
+  std::shared_ptr<ThreadPool> thread_pool_;
+  Executor local_planning_ex_;
+  std::shared_ptr<Executor> global_planning_ex_;
+
+  // Pipelined Local Planning (the local costmap gets a third executor)
+  bool pipeline_local_planning_;
+  std::shared_ptr<Executor> local_costmap_ex_;
+  bool local_update_pending_ { false };
+  bool local_costmap_ready_ { false };
 
   // Action Server
   LocomotorActionServer as_;
@@ -61,7 +61,7 @@ const ros::NodeHandle& Executor::getNodeHandle() const
   return ex_nh_;
 }
 
-void Executor::addCallback(LocomotorCallback::Function f)
+void Executor::addCallback(LocomotorCallback::Function f, CallbackPriority priority)
 {
   getQueue().addCallback(boost::make_shared<LocomotorCallback>(f));
 }
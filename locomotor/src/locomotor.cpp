@@ -53,15 +53,25 @@ Locomotor::Locomotor(const ros::NodeHandle& private_nh) :
   local_planner_mux_("nav_core2", "nav_core2::LocalPlanner",
                      "local_planner_namespaces", "dwb_local_planner::DWBLocalPlanner",
                      "current_local_planner", "switch_local_planner"),
-  private_nh_(private_nh), path_pub_(private_nh_), twist_pub_(private_nh_)
+  goal_version_(0), plan_version_(0), private_nh_(private_nh), path_pub_(private_nh_), twist_pub_(private_nh_)
 {
   tf_ = std::make_shared<tf::TransformListener>(ros::Duration(10));
+  local_tf_cache_ = std::make_shared<nav_core2::TransformCache>(tf_);
 
   private_nh_.param("robot_base_frame", robot_base_frame_, std::string("base_link"));
 
   // If true, when getting robot pose, use ros::Time(0) instead of ros::Time::now()
   private_nh_.param("use_latest_pose", use_latest_pose_, true);
 
+  // If true, the planners read from snapshots of the costmaps published after each update, so that costmap updates
+  // and planning do not block each other
+  private_nh_.param("use_costmap_snapshots", use_costmap_snapshots_, false);
+
+  // If positive, the inactive local planners are given the goal and the latest global plan and are warmed up with
+  // the current pose (at most this often, in seconds), so that switching to them needs no setGoalPose/setPlan and
+  // their first computeVelocityCommands does not have to do the setup that warmUp does
+  private_nh_.param("warm_standby_period", warm_standby_period_, 0.0);
+
   local_planner_mux_.setSwitchCallback(std::bind(&Locomotor::switchLocalPlannerCallback, this, std::placeholders::_1,
       std::placeholders::_2));
 
@@ -77,6 +87,10 @@ void Locomotor::initializeGlobalCostmap(Executor& ex)
   global_costmap_ = costmap_loader_.createUniqueInstance(costmap_class);
   ROS_INFO_NAMED("Locomotor", "Initializing Global Costmap");
   global_costmap_->initialize(ex.getNodeHandle(), "global_costmap", tf_);
+  if (use_costmap_snapshots_)
+  {
+    global_snapshot_ = std::make_shared<nav_core2::SnapshotCostmap>(global_costmap_);
+  }
 }
 
 void Locomotor::initializeLocalCostmap(Executor& ex)
@@ -87,6 +101,10 @@ void Locomotor::initializeLocalCostmap(Executor& ex)
   local_costmap_ = costmap_loader_.createUniqueInstance(costmap_class);
   ROS_INFO_NAMED("Locomotor", "Initializing Local Costmap");
   local_costmap_->initialize(ex.getNodeHandle(), "local_costmap", tf_);
+  if (use_costmap_snapshots_)
+  {
+    local_snapshot_ = std::make_shared<nav_core2::SnapshotCostmap>(local_costmap_);
+  }
 }
 
 void Locomotor::initializeGlobalPlanners(Executor& ex)
@@ -94,7 +112,8 @@ void Locomotor::initializeGlobalPlanners(Executor& ex)
   for (auto planner_name : global_planner_mux_.getPluginNames())
   {
     ROS_INFO_NAMED("Locomotor", "Initializing global planner %s", planner_name.c_str());
-    global_planner_mux_.getPlugin(planner_name).initialize(ex.getNodeHandle(), planner_name, tf_, global_costmap_);
+    global_planner_mux_.getPlugin(planner_name).initialize(ex.getNodeHandle(), planner_name, tf_,
+                                                           getPlanningCostmap(global_costmap_, global_snapshot_));
   }
 }
 
@@ -103,49 +122,152 @@ void Locomotor::initializeLocalPlanners(Executor& ex)
   for (auto planner_name : local_planner_mux_.getPluginNames())
   {
     ROS_INFO_NAMED("Locomotor", "Initializing local planner %s", planner_name.c_str());
-    local_planner_mux_.getPlugin(planner_name).initialize(ex.getNodeHandle(), planner_name, tf_, local_costmap_);
+    auto& local_planner = local_planner_mux_.getPlugin(planner_name);
+    local_planner.initialize(ex.getNodeHandle(), planner_name, tf_,
+                             getPlanningCostmap(local_costmap_, local_snapshot_));
+    local_planner.setTransformCache(local_tf_cache_);
   }
 }
 
+nav_core2::Costmap::Ptr Locomotor::getPlanningCostmap(nav_core2::Costmap::Ptr costmap,
+                                                      std::shared_ptr<nav_core2::SnapshotCostmap> snapshot) const
+{
+  if (snapshot)
+    return snapshot;
+  return costmap;
+}
+
 void Locomotor::setGoal(nav_2d_msgs::Pose2DStamped goal)
 {
   local_planner_mux_.getCurrentPlugin().setGoalPose(goal);
+  boost::unique_lock<boost::mutex> lock(state_mutex_);
   state_ = locomotor_msgs::NavigationState();
   state_.goal = goal;
+  // Resetting state_ also clears the global plan
+  ++goal_version_;
+  ++plan_version_;
+}
+
+locomotor_msgs::NavigationState Locomotor::getNavigationState() const
+{
+  boost::unique_lock<boost::mutex> lock(state_mutex_);
+  return state_;
 }
 
-void Locomotor::switchLocalPlannerCallback(const std::string&, const std::string& new_planner)
+void Locomotor::switchLocalPlannerCallback(const std::string& old_planner, const std::string& new_planner)
 {
-  auto& new_local_planner = local_planner_mux_.getPlugin(new_planner);
-  new_local_planner.setGoalPose(state_.goal);
-  new_local_planner.setPlan(state_.global_plan);
+  boost::unique_lock<boost::mutex> lock(standby_mutex_);
+  // A warm standby planner already has the goal and plan, so there is nothing left to do
+  syncLocalPlanner(new_planner);
+  standby_versions_.erase(new_planner);
+  // The old planner may not have been given the latest plan while it was active, so it gets synced again
+  standby_versions_.erase(old_planner);
+}
+
+void Locomotor::syncLocalPlanner(const std::string& name)
+{
+  // Copy the goal and plan along with their versions, since the global planner may replace them at any time
+  nav_2d_msgs::Pose2DStamped goal;
+  nav_2d_msgs::Path2D global_plan;
+  SyncedVersions current;
+  bool new_goal, new_plan;
+  {
+    boost::unique_lock<boost::mutex> lock(state_mutex_);
+    current.goal_version = goal_version_;
+    current.plan_version = plan_version_;
+    auto it = standby_versions_.find(name);
+    bool synced = it != standby_versions_.end();
+    new_goal = !synced || it->second.goal_version != current.goal_version;
+    new_plan = !synced || it->second.plan_version != current.plan_version;
+    if (new_goal)
+    {
+      goal = state_.goal;
+    }
+    if (new_plan)
+    {
+      global_plan = state_.global_plan;
+    }
+  }
+  auto& local_planner = local_planner_mux_.getPlugin(name);
+  if (new_goal)
+  {
+    local_planner.setGoalPose(goal);
+  }
+  if (new_plan)
+  {
+    local_planner.setPlan(global_plan);
+  }
+  standby_versions_[name] = current;
+}
+
+void Locomotor::updateStandbyLocalPlanners(const nav_2d_msgs::Pose2DStamped& pose,
+                                           const nav_2d_msgs::Twist2D& velocity)
+{
+  if (warm_standby_period_ <= 0.0)
+  {
+    return;
+  }
+  ros::WallTime now = ros::WallTime::now();
+  if ((now - last_standby_update_).toSec() < warm_standby_period_)
+  {
+    return;
+  }
+  last_standby_update_ = now;
+
+  boost::unique_lock<boost::mutex> lock(standby_mutex_);
+  std::string current_name = local_planner_mux_.getCurrentPluginName();
+  nav_core2::Costmap::Ptr costmap = getPlanningCostmap(local_costmap_, local_snapshot_);
+  for (const std::string& name : local_planner_mux_.getPluginNames())
+  {
+    if (name == current_name)
+    {
+      continue;
+    }
+    syncLocalPlanner(name);
+    try
+    {
+      // Neither the costmap nor the snapshot (refreshed by the active planner's cycle) may change while it is read
+      boost::unique_lock<boost::recursive_mutex> costmap_lock(*(costmap->getMutex()));
+      local_planner_mux_.getPlugin(name).warmUp(pose, velocity);
+    }
+    catch (const nav_core2::PlannerException& e)
+    {
+      // e.g. there is no global plan yet. The planner will be warmed up again next time.
+      ROS_DEBUG_NAMED("Locomotor", "Could not warm up local planner %s: %s", name.c_str(), e.what());
+    }
+  }
 }
 
 void Locomotor::requestGlobalCostmapUpdate(Executor& work_ex, Executor& result_ex,
                                            CostmapUpdateCallback cb, CostmapUpdateExceptionCallback fail_cb)
 {
   work_ex.addCallback(
-    std::bind(&Locomotor::doCostmapUpdate, this, std::ref(*global_costmap_), std::ref(result_ex), cb, fail_cb));
+    std::bind(&Locomotor::doCostmapUpdate, this, std::ref(*global_costmap_), std::ref(result_ex), cb, fail_cb),
+    CallbackPriority::COSTMAP);
 }
 
 void Locomotor::requestLocalCostmapUpdate(Executor& work_ex, Executor& result_ex,
                                           CostmapUpdateCallback cb, CostmapUpdateExceptionCallback fail_cb)
 {
   work_ex.addCallback(
-    std::bind(&Locomotor::doCostmapUpdate, this, std::ref(*local_costmap_), std::ref(result_ex), cb, fail_cb));
+    std::bind(&Locomotor::doCostmapUpdate, this, std::ref(*local_costmap_), std::ref(result_ex), cb, fail_cb),
+    CallbackPriority::COSTMAP);
 }
 
 void Locomotor::requestGlobalPlan(Executor& work_ex, Executor& result_ex,
                                   GlobalPlanCallback cb, PlannerExceptionCallback fail_cb)
 {
-  work_ex.addCallback(std::bind(&Locomotor::makeGlobalPlan, this, std::ref(result_ex), cb, fail_cb));
+  work_ex.addCallback(std::bind(&Locomotor::makeGlobalPlan, this, std::ref(result_ex), cb, fail_cb),
+                      CallbackPriority::GLOBAL_PLANNING);
 }
 
 void Locomotor::requestLocalPlan(Executor& work_ex, Executor& result_ex,
                                  LocalPlanCallback cb, PlannerExceptionCallback fail_cb,
                                  NavigationCompleteCallback complete_cb)
 {
-  work_ex.addCallback(std::bind(&Locomotor::makeLocalPlan, this, std::ref(result_ex), cb, fail_cb, complete_cb));
+  work_ex.addCallback(std::bind(&Locomotor::makeLocalPlan, this, std::ref(work_ex), std::ref(result_ex), cb, fail_cb,
+                                complete_cb),
+                      CallbackPriority::CONTROL);
 }
 
 void Locomotor::requestNavigationFailure(Executor& result_ex, const locomotor_msgs::ResultCode& result,
@@ -163,8 +285,17 @@ void Locomotor::doCostmapUpdate(nav_core2::Costmap& costmap, Executor& result_ex
     {
       boost::unique_lock<boost::recursive_mutex> lock(*(costmap.getMutex()));
       costmap.update();
+      if (use_costmap_snapshots_) costmap.publishSnapshot();
+    }
+    ros::Duration update_time = getTimeDiffFromNow(start_t);
+    {
+      boost::unique_lock<boost::mutex> lock(state_mutex_);
+      if (&costmap == global_costmap_.get())
+        state_.global_costmap_update_time = update_time;
+      else
+        state_.local_costmap_update_time = update_time;
     }
-    if (cb) result_ex.addCallback(std::bind(cb, getTimeDiffFromNow(start_t)));
+    if (cb) result_ex.addCallback(std::bind(cb, update_time));
   }
   catch (const nav_core2::CostmapException& e)
   {
@@ -178,13 +309,34 @@ void Locomotor::makeGlobalPlan(Executor& result_ex, GlobalPlanCallback cb, Plann
   ros::WallTime start_t = ros::WallTime::now();
   try
   {
-    state_.global_pose = getGlobalRobotPose();
+    nav_2d_msgs::Pose2DStamped global_pose = getGlobalRobotPose();
+    nav_2d_msgs::Pose2DStamped goal;
+    {
+      boost::unique_lock<boost::mutex> lock(state_mutex_);
+      state_.global_pose = global_pose;
+      goal = state_.goal;
+    }
 
+    nav_2d_msgs::Path2D global_plan;
+    if (global_snapshot_)
+    {
+      // The snapshot will not change while planning, so the costmap can keep updating
+      global_snapshot_->refresh();
+      global_plan = global_planner_mux_.getCurrentPlugin().makePlan(global_pose, goal);
+    }
+    else
     {
       boost::unique_lock<boost::recursive_mutex> lock(*(global_costmap_->getMutex()));
-      state_.global_plan = global_planner_mux_.getCurrentPlugin().makePlan(state_.global_pose, state_.goal);
+      global_plan = global_planner_mux_.getCurrentPlugin().makePlan(global_pose, goal);
     }
-    if (cb) result_ex.addCallback(std::bind(cb, state_.global_plan, getTimeDiffFromNow(start_t)));
+    ros::Duration planning_time = getTimeDiffFromNow(start_t);
+    {
+      boost::unique_lock<boost::mutex> lock(state_mutex_);
+      state_.global_planning_time = planning_time;
+      state_.global_plan = global_plan;
+      ++plan_version_;
+    }
+    if (cb) result_ex.addCallback(std::bind(cb, global_plan, planning_time));
   }
   // if we didn't get a plan and we are in the planning state (the robot isn't moving)
   catch (const nav_core2::PlannerException& e)
@@ -194,15 +346,23 @@ void Locomotor::makeGlobalPlan(Executor& result_ex, GlobalPlanCallback cb, Plann
   }
 }
 
-void Locomotor::makeLocalPlan(Executor& result_ex, LocalPlanCallback cb, PlannerExceptionCallback fail_cb,
-                              NavigationCompleteCallback complete_cb)
+void Locomotor::makeLocalPlan(Executor& work_ex, Executor& result_ex, LocalPlanCallback cb,
+                              PlannerExceptionCallback fail_cb, NavigationCompleteCallback complete_cb)
 {
-  state_.global_pose = getGlobalRobotPose();
-  state_.local_pose = getLocalRobotPose();
-  state_.current_velocity = odom_sub_->getTwistStamped();
+  // Look up each transform needed for this cycle at most once, here and in the local planner
+  local_tf_cache_->clear();
+  nav_2d_msgs::Pose2DStamped global_pose = getRobotPose(global_costmap_->getFrameId(), local_tf_cache_.get());
+  nav_2d_msgs::Pose2DStamped local_pose = getRobotPose(local_costmap_->getFrameId(), local_tf_cache_.get());
+  nav_2d_msgs::Twist2DStamped current_velocity = odom_sub_->getTwistStamped();
+  {
+    boost::unique_lock<boost::mutex> lock(state_mutex_);
+    state_.global_pose = global_pose;
+    state_.local_pose = local_pose;
+    state_.current_velocity = current_velocity;
+  }
   auto& local_planner = local_planner_mux_.getCurrentPlugin();
 
-  if (local_planner.isGoalReached(state_.local_pose, state_.current_velocity.velocity))
+  if (local_planner.isGoalReached(local_pose, current_velocity.velocity))
   {
     if (complete_cb) result_ex.addCallback(std::bind(complete_cb));
     return;
@@ -211,25 +371,50 @@ void Locomotor::makeLocalPlan(Executor& result_ex, LocalPlanCallback cb, Planner
   // Actual Control
   // Extra Scope for Mutex
   {
-    boost::unique_lock<boost::recursive_mutex> lock(*(local_costmap_->getMutex()));
+    boost::unique_lock<boost::recursive_mutex> lock(*(local_costmap_->getMutex()), boost::defer_lock);
+    if (local_snapshot_)
+    {
+      // The snapshot will not change while planning, so the costmap can keep updating
+      local_snapshot_->refresh();
+    }
+    else
+    {
+      lock.lock();
+    }
     ros::WallTime start_t = ros::WallTime::now();
     try
     {
-      state_.command_velocity = local_planner.computeVelocityCommands(state_.local_pose,
-                                                                      state_.current_velocity.velocity);
-      lock.unlock();
-      if (cb) result_ex.addCallback(std::bind(cb, state_.command_velocity, getTimeDiffFromNow(start_t)));
+      nav_2d_msgs::Twist2DStamped command = local_planner.computeVelocityCommands(local_pose,
+                                                                                  current_velocity.velocity);
+      if (lock.owns_lock()) lock.unlock();
+      ros::Duration planning_time = getTimeDiffFromNow(start_t);
+      {
+        boost::unique_lock<boost::mutex> state_lock(state_mutex_);
+        state_.command_velocity = command;
+        state_.local_planning_time = planning_time;
+      }
+      if (cb) result_ex.addCallback(std::bind(cb, command, planning_time));
     }
     catch (const nav_core2::PlannerException& e)
     {
-      lock.unlock();
+      if (lock.owns_lock()) lock.unlock();
       if (fail_cb)
         result_ex.addCallback(std::bind(fail_cb, std::current_exception(), getTimeDiffFromNow(start_t)));
     }
   }
+
+  // The inactive planners are updated in a separate callback on the planning executor, with the lowest priority.
+  // When the result executor is the same one, the result callbacks above are queued first and so are not delayed.
+  if (warm_standby_period_ > 0.0)
+  {
+    work_ex.addCallback(std::bind(&Locomotor::updateStandbyLocalPlanners, this, local_pose,
+                                  current_velocity.velocity),
+                        CallbackPriority::PUBLISHING);
+  }
 }
 
-nav_2d_msgs::Pose2DStamped Locomotor::getRobotPose(const std::string& target_frame) const
+nav_2d_msgs::Pose2DStamped Locomotor::getRobotPose(const std::string& target_frame,
+                                                   nav_core2::TransformCache* cache) const
 {
   nav_2d_msgs::Pose2DStamped robot_pose, transformed_pose;
   robot_pose.header.frame_id = robot_base_frame_;
@@ -237,7 +422,11 @@ nav_2d_msgs::Pose2DStamped Locomotor::getRobotPose(const std::string& target_fra
   {
     robot_pose.header.stamp = ros::Time::now();
   }
-  bool ret = nav_2d_utils::transformPose(tf_, target_frame, robot_pose, transformed_pose);
+  bool ret;
+  if (cache)
+    ret = cache->transformPose(target_frame, robot_pose, transformed_pose);
+  else
+    ret = nav_2d_utils::transformPose(tf_, target_frame, robot_pose, transformed_pose);
   if (!ret)
   {
     throw nav_core2::PlannerTFException("Could not get pose into costmap frame!");
@@ -0,0 +1,180 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <locomotor/loop_scheduler.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace locomotor
+{
+const std::vector<double> HISTOGRAM_BOUNDS = {0.1, 0.25, 0.5, 0.75, 1.0, 1.5, 2.0, 4.0};
+
+LoopHistogram::LoopHistogram(const std::vector<double>& bounds) : bounds(bounds), counts(bounds.size() + 1, 0) {}
+
+void LoopHistogram::add(double fraction)
+{
+  unsigned int i = 0;
+  while (i < bounds.size() && fraction >= bounds[i])
+  {
+    i++;
+  }
+  counts[i]++;
+}
+
+void LoopHistogram::reset()
+{
+  counts.assign(bounds.size() + 1, 0);
+}
+
+std::string LoopHistogram::toString() const
+{
+  std::string s;
+  for (unsigned int i = 0; i < counts.size(); i++)
+  {
+    if (i < bounds.size())
+      s += "<" + std::to_string(bounds[i]).substr(0, 4);
+    else
+      s += ">=" + std::to_string(bounds.back()).substr(0, 4);
+    s += ":" + std::to_string(counts[i]) + " ";
+  }
+  return s;
+}
+
+LoopStatistics::LoopStatistics() : jitter(HISTOGRAM_BOUNDS), durations(HISTOGRAM_BOUNDS) {}
+
+LoopScheduler::LoopScheduler(const std::string& name, const ros::Duration& desired_duration,
+                             unsigned int overruns_before_degrading, unsigned int recoveries_before_restoring)
+  : name_(name), desired_duration_(desired_duration), overruns_before_degrading_(overruns_before_degrading),
+    recoveries_before_restoring_(recoveries_before_restoring)
+{
+}
+
+bool LoopScheduler::tryStart(const ros::Time& expected_start)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  if (running_)
+  {
+    stats_.skipped++;
+    return false;
+  }
+  running_ = true;
+  start_time_ = ros::WallTime::now();
+  stats_.iterations++;
+
+  if (!expected_start.isZero())
+  {
+    double late = (ros::Time::now() - expected_start).toSec();
+    stats_.jitter.add(std::max(late, 0.0) / desired_duration_.toSec());
+  }
+  return true;
+}
+
+ros::Duration LoopScheduler::finish()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  ros::WallDuration elapsed = ros::WallTime::now() - start_time_;
+  ros::Duration duration(elapsed.sec, elapsed.nsec);
+  if (!running_)
+  {
+    return duration;
+  }
+  running_ = false;
+  stats_.durations.add(duration.toSec() / desired_duration_.toSec());
+
+  if (duration > desired_duration_)
+  {
+    stats_.overruns++;
+    consecutive_overruns_++;
+    consecutive_on_time_ = 0;
+    if (!degraded_ && overruns_before_degrading_ > 0 && consecutive_overruns_ >= overruns_before_degrading_)
+    {
+      ROS_WARN_NAMED("Locomotor", "The %s loop overran %u times in a row. Degrading.", name_.c_str(),
+                     consecutive_overruns_);
+      degraded_ = true;
+    }
+  }
+  else
+  {
+    consecutive_overruns_ = 0;
+    consecutive_on_time_++;
+    if (degraded_ && consecutive_on_time_ >= recoveries_before_restoring_)
+    {
+      ROS_INFO_NAMED("Locomotor", "The %s loop has been on time %u times in a row. Restoring.", name_.c_str(),
+                     consecutive_on_time_);
+      degraded_ = false;
+    }
+  }
+  return duration;
+}
+
+void LoopScheduler::cancel()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  running_ = false;
+}
+
+bool LoopScheduler::isRunning() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return running_;
+}
+
+bool LoopScheduler::isDegraded() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return degraded_;
+}
+
+LoopStatistics LoopScheduler::getStatistics() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return stats_;
+}
+
+void LoopScheduler::resetStatistics()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  stats_ = LoopStatistics();
+}
+
+std::string LoopScheduler::getSummary() const
+{
+  LoopStatistics stats = getStatistics();
+  return name_ + " loop: " + std::to_string(stats.iterations) + " iterations, " +
+         std::to_string(stats.skipped) + " skipped, " + std::to_string(stats.overruns) + " overruns. "
+         "Jitter [" + stats.jitter.toString() + "] Durations [" + stats.durations.toString() + "]";
+}
+
+}  // namespace locomotor
@@ -0,0 +1,206 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <locomotor/thread_pool_executor.h>
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace locomotor
+{
+ThreadPool::ThreadPool(unsigned int num_threads, const std::vector<int>& cpu_affinity)
+{
+  num_threads = std::max(num_threads, 1u);
+  for (unsigned int i = 0; i < num_threads; i++)
+  {
+    workers_.push_back(boost::thread(&ThreadPool::workerLoop, this));
+    if (cpu_affinity.empty()) continue;
+
+    int cpu = cpu_affinity[i % cpu_affinity.size()];
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    if (pthread_setaffinity_np(workers_[i].native_handle(), sizeof(cpu_set_t), &cpu_set) != 0)
+    {
+      ROS_WARN_NAMED("Locomotor", "Unable to pin executor thread %u to CPU %d", i, cpu);
+    }
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    running_ = false;
+  }
+  condition_.notify_all();
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+void ThreadPool::workerLoop()
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  while (true)
+  {
+    ThreadPoolExecutor* executor = nullptr;
+    while (running_ && !(executor = chooseExecutor()))
+    {
+      condition_.wait(lock);
+    }
+    if (!running_) return;
+
+    ThreadPoolExecutor::Task task = executor->popTask();
+    lock.unlock();
+    task.function();
+    lock.lock();
+
+    // The executor's next callback can run now, and its destructor may be waiting for this one to finish
+    executor->busy_ = false;
+    condition_.notify_all();
+  }
+}
+
+ThreadPoolExecutor* ThreadPool::chooseExecutor() const
+{
+  ThreadPoolExecutor* best = nullptr;
+  unsigned int best_priority = NUM_CALLBACK_PRIORITIES;
+  uint64_t best_sequence = 0;
+  for (ThreadPoolExecutor* executor : executors_)
+  {
+    unsigned int priority;
+    const ThreadPoolExecutor::Task* task = executor->peekTask(priority);
+    if (!task) continue;
+    if (!best || priority < best_priority || (priority == best_priority && task->sequence < best_sequence))
+    {
+      best = executor;
+      best_priority = priority;
+      best_sequence = task->sequence;
+    }
+  }
+  return best;
+}
+
+ThreadPoolExecutor::ThreadPoolExecutor(const ros::NodeHandle& base_nh, std::shared_ptr<ThreadPool> pool)
+  : Executor(base_nh), pool_(pool), metrics_(NUM_CALLBACK_PRIORITIES)
+{
+  boost::unique_lock<boost::mutex> lock(pool_->mutex_);
+  pool_->executors_.push_back(this);
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+  boost::unique_lock<boost::mutex> lock(pool_->mutex_);
+  for (auto& lane : lanes_)
+  {
+    lane.clear();
+  }
+  while (busy_)
+  {
+    pool_->condition_.wait(lock);
+  }
+  auto& executors = pool_->executors_;
+  executors.erase(std::remove(executors.begin(), executors.end(), this), executors.end());
+}
+
+void ThreadPoolExecutor::addCallback(LocomotorCallback::Function f, CallbackPriority priority)
+{
+  unsigned int index = static_cast<unsigned int>(priority);
+  {
+    boost::unique_lock<boost::mutex> lock(pool_->mutex_);
+    Task task;
+    task.function = f;
+    task.enqueued = ros::WallTime::now();
+    task.sequence = pool_->next_sequence_++;
+    lanes_[index].push_back(task);
+
+    LaneMetrics& lane = metrics_[index];
+    lane.queue_depth++;
+    lane.max_queue_depth = std::max(lane.max_queue_depth, lane.queue_depth);
+  }
+  pool_->condition_.notify_one();
+}
+
+std::vector<ThreadPoolExecutor::LaneMetrics> ThreadPoolExecutor::getMetrics() const
+{
+  boost::unique_lock<boost::mutex> lock(pool_->mutex_);
+  return metrics_;
+}
+
+void ThreadPoolExecutor::resetMetrics()
+{
+  boost::unique_lock<boost::mutex> lock(pool_->mutex_);
+  for (LaneMetrics& lane : metrics_)
+  {
+    unsigned int queue_depth = lane.queue_depth;
+    lane = LaneMetrics();
+    lane.queue_depth = queue_depth;
+    lane.max_queue_depth = queue_depth;
+  }
+}
+
+const ThreadPoolExecutor::Task* ThreadPoolExecutor::peekTask(unsigned int& priority) const
+{
+  if (busy_) return nullptr;
+  for (priority = 0; priority < NUM_CALLBACK_PRIORITIES; priority++)
+  {
+    if (!lanes_[priority].empty())
+    {
+      return &lanes_[priority].front();
+    }
+  }
+  return nullptr;
+}
+
+ThreadPoolExecutor::Task ThreadPoolExecutor::popTask()
+{
+  unsigned int priority;
+  peekTask(priority);
+  Task task = lanes_[priority].front();
+  lanes_[priority].pop_front();
+  busy_ = true;
+
+  ros::WallDuration latency = ros::WallTime::now() - task.enqueued;
+  LaneMetrics& lane = metrics_[priority];
+  lane.queue_depth--;
+  lane.callbacks_run++;
+  lane.total_latency += latency;
+  lane.max_latency = std::max(lane.max_latency, latency);
+  return task;
+}
+}  // namespace locomotor
@@ -0,0 +1,338 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <locomotor/locomotor.h>
+#include <locomotor_test_plugins/test_plugins.h>
+#include <future>
+#include <memory>
+#include <string>
+
+using locomotor_test_plugins::GatedCostmap;
+using locomotor_test_plugins::RecordingLocalPlanner;
+
+const std::chrono::seconds TIMEOUT(5);
+
+/**
+ * @brief Locomotor with access to the inactive local planners
+ */
+class TestLocomotor : public locomotor::Locomotor
+{
+public:
+  using locomotor::Locomotor::Locomotor;
+
+  RecordingLocalPlanner& getLocalPlanner(const std::string& name)
+  {
+    return dynamic_cast<RecordingLocalPlanner&>(local_planner_mux_.getPlugin(name));
+  }
+};
+
+/**
+ * @brief Locomotor with the local costmap on its own executor, set up like the pipelined DoubleThreadLocomotor
+ */
+class LocomotorTest : public testing::Test
+{
+protected:
+  LocomotorTest() : nh_("~"), locomotor_(nh_), costmap_ex_(nh_), planning_ex_(nh_)
+  {
+    locomotor_.setUseCostmapSnapshots(true);
+    locomotor_.initializeGlobalCostmap(planning_ex_);
+    locomotor_.initializeLocalCostmap(costmap_ex_);
+    locomotor_.initializeGlobalPlanners(planning_ex_);
+    locomotor_.initializeLocalPlanners(planning_ex_);
+    local_costmap_ = std::dynamic_pointer_cast<GatedCostmap>(locomotor_.getLocalCostmap());
+  }
+
+  void TearDown() override
+  {
+    // Don't leave a call waiting at a gate, or the executors could not be shut down
+    local_costmap_->openGate();
+    for (const std::string& name : locomotor_.getLocalPlannerNames())
+    {
+      locomotor_.getLocalPlanner(name).openGate();
+    }
+  }
+
+  void setGoal(double x)
+  {
+    nav_2d_msgs::Pose2DStamped goal;
+    goal.header.frame_id = "map";
+    goal.pose.x = x;
+    locomotor_.setGoal(goal);
+  }
+
+  std::future<nav_2d_msgs::Path2D> requestGlobalPlan()
+  {
+    auto result = std::make_shared<std::promise<nav_2d_msgs::Path2D>>();
+    locomotor_.requestGlobalPlan(planning_ex_, planning_ex_,
+      [result](const nav_2d_msgs::Path2D& plan, const ros::Duration&) { result->set_value(plan); },
+      [result](nav_core2::NavCore2ExceptionPtr e_ptr, const ros::Duration&) { result->set_exception(e_ptr); });
+    return result->get_future();
+  }
+
+  std::future<void> requestLocalCostmapUpdate()
+  {
+    auto done = std::make_shared<std::promise<void>>();
+    locomotor_.requestLocalCostmapUpdate(costmap_ex_, planning_ex_,
+      [done](const ros::Duration&) { done->set_value(); },
+      [done](nav_core2::NavCore2ExceptionPtr e_ptr, const ros::Duration&) { done->set_exception(e_ptr); });
+    return done->get_future();
+  }
+
+  /**
+   * @brief Request a local plan. The result is the x velocity of the command, i.e. the cost the planner read.
+   */
+  std::future<double> requestLocalPlan()
+  {
+    auto result = std::make_shared<std::promise<double>>();
+    locomotor_.requestLocalPlan(planning_ex_, planning_ex_,
+      [result](const nav_2d_msgs::Twist2DStamped& cmd, const ros::Duration&) { result->set_value(cmd.velocity.x); },
+      [result](nav_core2::NavCore2ExceptionPtr e_ptr, const ros::Duration&) { result->set_exception(e_ptr); });
+    return result->get_future();
+  }
+
+  /**
+   * @brief Wait for everything queued on the planning executor (including the lowest priority callbacks) to finish
+   */
+  bool waitForPlanningExecutor()
+  {
+    auto done = std::make_shared<std::promise<void>>();
+    planning_ex_.addCallback([done]() { done->set_value(); }, locomotor::CallbackPriority::PUBLISHING);
+    return done->get_future().wait_for(TIMEOUT) == std::future_status::ready;
+  }
+
+  ros::NodeHandle nh_;
+  TestLocomotor locomotor_;
+  locomotor::Executor costmap_ex_, planning_ex_;
+  std::shared_ptr<GatedCostmap> local_costmap_;
+};
+
+TEST_F(LocomotorTest, plan_during_costmap_update)
+{
+  ASSERT_TRUE(local_costmap_);
+  std::future<void> update = requestLocalCostmapUpdate();
+  ASSERT_EQ(std::future_status::ready, update.wait_for(TIMEOUT));
+  update.get();
+
+  // Hold up the next update with the costmap locked
+  local_costmap_->closeGate();
+  update = requestLocalCostmapUpdate();
+  ASSERT_TRUE(local_costmap_->waitUntilBlocked(TIMEOUT.count()));
+
+  // The local planner runs anyway, using the snapshot from the update that completed
+  std::future<double> plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  EXPECT_EQ(1.0, plan.get());
+  EXPECT_EQ(std::future_status::timeout, update.wait_for(std::chrono::seconds(0)));
+
+  ros::WallDuration(0.1).sleep();
+  local_costmap_->openGate();
+  ASSERT_EQ(std::future_status::ready, update.wait_for(TIMEOUT));
+  update.get();
+  EXPECT_GE(locomotor_.getNavigationState().local_costmap_update_time.toSec(), 0.1);
+
+  // Once the update completes, the next plan uses it
+  plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  EXPECT_EQ(2.0, plan.get());
+}
+
+TEST_F(LocomotorTest, navigation_state)
+{
+  setGoal(1.0);
+  std::future<nav_2d_msgs::Path2D> global_plan = requestGlobalPlan();
+  ASSERT_EQ(std::future_status::ready, global_plan.wait_for(TIMEOUT));
+  nav_2d_msgs::Path2D path = global_plan.get();
+
+  // The state is read while the local costmap update is held up (i.e. while another thread may be writing it)
+  local_costmap_->closeGate();
+  std::future<void> update = requestLocalCostmapUpdate();
+  ASSERT_TRUE(local_costmap_->waitUntilBlocked(TIMEOUT.count()));
+  std::future<double> plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  double cost = plan.get();
+  locomotor_msgs::NavigationState state = locomotor_.getNavigationState();
+  EXPECT_EQ(1.0, state.goal.pose.x);
+  EXPECT_EQ(path.poses.size(), state.global_plan.poses.size());
+  EXPECT_EQ(cost, state.command_velocity.velocity.x);
+
+  local_costmap_->openGate();
+  ASSERT_EQ(std::future_status::ready, update.wait_for(TIMEOUT));
+  EXPECT_GT(locomotor_.getNavigationState().local_costmap_update_time, ros::Duration(0));
+
+  // A new goal resets the rest of the state
+  setGoal(2.0);
+  state = locomotor_.getNavigationState();
+  EXPECT_EQ(2.0, state.goal.pose.x);
+  EXPECT_EQ(0u, state.global_plan.poses.size());
+}
+
+TEST_F(LocomotorTest, standby_planner_kept_up_to_date)
+{
+  RecordingLocalPlanner& first = locomotor_.getLocalPlanner("first");
+  RecordingLocalPlanner& second = locomotor_.getLocalPlanner("second");
+  setGoal(1.0);
+  std::future<nav_2d_msgs::Path2D> global_plan = requestGlobalPlan();
+  ASSERT_EQ(std::future_status::ready, global_plan.wait_for(TIMEOUT));
+  nav_2d_msgs::Path2D path = global_plan.get();
+
+  // After a local planning cycle, the inactive planner has the latest global plan
+  std::future<double> plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(1u, second.getNumPlans());
+  ASSERT_EQ(path.poses.size(), second.getPlan().poses.size());
+  EXPECT_EQ(1.0, second.getPlan().poses.back().x);
+  EXPECT_EQ(0u, first.getNumPlans());
+
+  // It is not given the same plan again
+  ros::WallDuration(0.05).sleep();
+  plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(1u, second.getNumPlans());
+
+  // but does get the next one
+  setGoal(2.0);
+  global_plan = requestGlobalPlan();
+  ASSERT_EQ(std::future_status::ready, global_plan.wait_for(TIMEOUT));
+  ros::WallDuration(0.05).sleep();
+  plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(2u, second.getNumPlans());
+  EXPECT_EQ(2.0, second.getPlan().poses.back().x);
+
+  // Switching to the up to date planner does not give it the plan again
+  EXPECT_TRUE(locomotor_.useLocalPlanner("second"));
+  EXPECT_EQ(2u, second.getNumPlans());
+
+  // The planner that is now inactive is brought up to date after the next cycle
+  ros::WallDuration(0.05).sleep();
+  plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(1u, first.getNumPlans());
+  EXPECT_EQ(2.0, first.getPlan().poses.back().x);
+  EXPECT_EQ(2u, second.getNumPlans());
+}
+
+TEST_F(LocomotorTest, standby_goal_only_given_when_changed)
+{
+  RecordingLocalPlanner& second = locomotor_.getLocalPlanner("second");
+  setGoal(1.0);
+  std::future<nav_2d_msgs::Path2D> global_plan = requestGlobalPlan();
+  ASSERT_EQ(std::future_status::ready, global_plan.wait_for(TIMEOUT));
+  std::future<double> plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(1u, second.getNumGoals());
+  EXPECT_EQ(1u, second.getNumPlans());
+
+  // Replanning to the same goal only gives the inactive planner the new plan
+  global_plan = requestGlobalPlan();
+  ASSERT_EQ(std::future_status::ready, global_plan.wait_for(TIMEOUT));
+  ros::WallDuration(0.05).sleep();
+  plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(1u, second.getNumGoals());
+  EXPECT_EQ(2u, second.getNumPlans());
+
+  // A new goal is given to it
+  setGoal(2.0);
+  global_plan = requestGlobalPlan();
+  ASSERT_EQ(std::future_status::ready, global_plan.wait_for(TIMEOUT));
+  ros::WallDuration(0.05).sleep();
+  plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(2u, second.getNumGoals());
+  EXPECT_EQ(3u, second.getNumPlans());
+}
+
+TEST_F(LocomotorTest, standby_planner_warmed_up)
+{
+  RecordingLocalPlanner& first = locomotor_.getLocalPlanner("first");
+  RecordingLocalPlanner& second = locomotor_.getLocalPlanner("second");
+  setGoal(1.0);
+  std::future<nav_2d_msgs::Path2D> global_plan = requestGlobalPlan();
+  ASSERT_EQ(std::future_status::ready, global_plan.wait_for(TIMEOUT));
+  ASSERT_EQ(std::future_status::ready, requestLocalCostmapUpdate().wait_for(TIMEOUT));
+
+  // The inactive planner is warmed up on the same costmap the active planner just read
+  std::future<double> plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  double cost = plan.get();
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(1u, second.getNumWarmUps());
+  EXPECT_EQ(cost, second.getWarmUpCost());
+  EXPECT_EQ(0u, first.getNumWarmUps());
+
+  // and again after the next cycle, once the period has passed
+  ros::WallDuration(0.05).sleep();
+  plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(2u, second.getNumWarmUps());
+  EXPECT_EQ(0u, first.getNumWarmUps());
+}
+
+TEST_F(LocomotorTest, standby_does_not_delay_command)
+{
+  RecordingLocalPlanner& second = locomotor_.getLocalPlanner("second");
+  setGoal(1.0);
+  std::future<nav_2d_msgs::Path2D> global_plan = requestGlobalPlan();
+  ASSERT_EQ(std::future_status::ready, global_plan.wait_for(TIMEOUT));
+
+  // The result of the local planning cycle is delivered (on the same executor) while the inactive planner's setPlan
+  // is held up
+  second.closeGate();
+  std::future<double> plan = requestLocalPlan();
+  ASSERT_EQ(std::future_status::ready, plan.wait_for(TIMEOUT));
+  plan.get();
+  ASSERT_TRUE(second.waitUntilBlocked(TIMEOUT.count()));
+  EXPECT_EQ(0u, second.getNumPlans());
+
+  second.openGate();
+  ASSERT_TRUE(waitForPlanningExecutor());
+  EXPECT_EQ(1u, second.getNumPlans());
+}
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "locomotor_test");
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,154 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <locomotor/loop_scheduler.h>
+#include <vector>
+
+using locomotor::LoopHistogram;
+using locomotor::LoopScheduler;
+using locomotor::LoopStatistics;
+
+TEST(LoopScheduler, histogram)
+{
+  LoopHistogram histogram({0.5, 1.0});
+  histogram.add(0.2);
+  histogram.add(0.5);
+  histogram.add(0.99);
+  histogram.add(3.0);
+  EXPECT_EQ(std::vector<uint64_t>({1, 2, 1}), histogram.counts);
+  histogram.reset();
+  EXPECT_EQ(std::vector<uint64_t>({0, 0, 0}), histogram.counts);
+}
+
+TEST(LoopScheduler, skip_while_running)
+{
+  LoopScheduler loop("test", ros::Duration(1.0));
+  EXPECT_TRUE(loop.tryStart());
+  EXPECT_TRUE(loop.isRunning());
+  EXPECT_FALSE(loop.tryStart());
+  EXPECT_FALSE(loop.tryStart());
+  loop.finish();
+  EXPECT_FALSE(loop.isRunning());
+  EXPECT_TRUE(loop.tryStart());
+
+  // A cancelled iteration is counted, but not its duration
+  loop.cancel();
+  EXPECT_FALSE(loop.isRunning());
+  EXPECT_TRUE(loop.tryStart());
+  loop.finish();
+
+  LoopStatistics stats = loop.getStatistics();
+  EXPECT_EQ(3u, stats.iterations);
+  EXPECT_EQ(2u, stats.skipped);
+  EXPECT_EQ(0u, stats.overruns);
+  EXPECT_EQ(2u, stats.durations.counts[0]);
+
+  loop.resetStatistics();
+  stats = loop.getStatistics();
+  EXPECT_EQ(0u, stats.iterations);
+  EXPECT_EQ(0u, stats.skipped);
+}
+
+TEST(LoopScheduler, jitter)
+{
+  // Started 0.3 periods late
+  LoopScheduler loop("test", ros::Duration(1.0));
+  ASSERT_TRUE(loop.tryStart(ros::Time::now() - ros::Duration(0.3)));
+  loop.finish();
+
+  // Not triggered by a timer, so no jitter is recorded
+  ASSERT_TRUE(loop.tryStart());
+  loop.finish();
+
+  LoopStatistics stats = loop.getStatistics();
+  EXPECT_EQ(std::vector<uint64_t>({0, 0, 1, 0, 0, 0, 0, 0, 0}), stats.jitter.counts);
+}
+
+TEST(LoopScheduler, deadlines)
+{
+  const ros::Duration desired(0.05);
+  LoopScheduler loop("test", desired, 2, 2);
+
+  auto run = [&](bool overrun)
+  {
+    ASSERT_TRUE(loop.tryStart());
+    if (overrun)
+    {
+      (desired * 1.2).sleep();
+    }
+    ros::Duration duration = loop.finish();
+    EXPECT_EQ(overrun, duration > desired);
+  };
+
+  run(true);
+  EXPECT_FALSE(loop.isDegraded());
+  run(true);
+  EXPECT_TRUE(loop.isDegraded());
+  run(true);
+  run(false);
+  EXPECT_TRUE(loop.isDegraded());
+
+  // Overruns in between reset the count of iterations on time
+  run(true);
+  run(false);
+  EXPECT_TRUE(loop.isDegraded());
+  run(false);
+  EXPECT_FALSE(loop.isDegraded());
+
+  LoopStatistics stats = loop.getStatistics();
+  EXPECT_EQ(7u, stats.iterations);
+  EXPECT_EQ(4u, stats.overruns);
+}
+
+TEST(LoopScheduler, never_degrade)
+{
+  const ros::Duration desired(0.01);
+  LoopScheduler loop("test", desired);
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_TRUE(loop.tryStart());
+    (desired * 1.5).sleep();
+    loop.finish();
+  }
+  EXPECT_FALSE(loop.isDegraded());
+  EXPECT_EQ(3u, loop.getStatistics().overruns);
+}
+
+int main(int argc, char** argv)
+{
+  ros::Time::init();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,196 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <locomotor/thread_pool_executor.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+using locomotor::CallbackPriority;
+using locomotor::ThreadPool;
+using locomotor::ThreadPoolExecutor;
+
+const std::chrono::seconds TIMEOUT(5);
+
+/**
+ * @brief Callback that does not return until the test releases it
+ */
+class Blocker
+{
+public:
+  Blocker() : release_future_(release_.get_future().share()) {}
+
+  std::function<void()> callback()
+  {
+    auto started = std::make_shared<std::promise<void>>();
+    started_ = started->get_future();
+    std::shared_future<void> release = release_future_;
+    return [started, release]
+    {
+      started->set_value();
+      release.wait();
+    };
+  }
+
+  bool waitUntilStarted() { return started_.wait_for(TIMEOUT) == std::future_status::ready; }
+  void release() { release_.set_value(); }
+
+private:
+  std::promise<void> release_;
+  std::shared_future<void> release_future_;
+  std::future<void> started_;
+};
+
+/**
+ * @brief Wait for all the callbacks added to the executor so far to have run
+ */
+bool waitForCallbacks(ThreadPoolExecutor& ex, CallbackPriority priority = CallbackPriority::PUBLISHING)
+{
+  auto done = std::make_shared<std::promise<void>>();
+  ex.addCallback([done] { done->set_value(); }, priority);
+  return done->get_future().wait_for(TIMEOUT) == std::future_status::ready;
+}
+
+TEST(ThreadPoolExecutor, priority_order)
+{
+  ros::NodeHandle nh("~");
+  ThreadPoolExecutor ex(nh, std::make_shared<ThreadPool>(1));
+
+  // Keep the executor busy while the other callbacks are added
+  Blocker blocker;
+  ex.addCallback(blocker.callback());
+  ASSERT_TRUE(blocker.waitUntilStarted());
+
+  std::vector<int> order;
+  ex.addCallback([&order] { order.push_back(4); }, CallbackPriority::PUBLISHING);
+  ex.addCallback([&order] { order.push_back(3); }, CallbackPriority::GLOBAL_PLANNING);
+  ex.addCallback([&order] { order.push_back(0); }, CallbackPriority::CONTROL);
+  ex.addCallback([&order] { order.push_back(2); }, CallbackPriority::COSTMAP);
+  ex.addCallback([&order] { order.push_back(1); }, CallbackPriority::CONTROL);
+
+  std::vector<ThreadPoolExecutor::LaneMetrics> metrics = ex.getMetrics();
+  EXPECT_EQ(2u, metrics[0].queue_depth);
+  EXPECT_EQ(1u, metrics[3].queue_depth);
+
+  blocker.release();
+  ASSERT_TRUE(waitForCallbacks(ex));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4}), order);
+
+  metrics = ex.getMetrics();
+  EXPECT_EQ(3u, metrics[0].callbacks_run);
+  EXPECT_EQ(0u, metrics[0].queue_depth);
+  EXPECT_EQ(2u, metrics[0].max_queue_depth);
+}
+
+TEST(ThreadPoolExecutor, one_at_a_time)
+{
+  ros::NodeHandle nh("~");
+  ThreadPoolExecutor ex(nh, std::make_shared<ThreadPool>(4));
+
+  std::atomic<int> running(0), max_running(0), count(0);
+  for (int i = 0; i < 200; i++)
+  {
+    ex.addCallback([&]
+    {
+      int now_running = ++running;
+      if (now_running > max_running) max_running = now_running;
+      ros::WallDuration(0.0001).sleep();
+      count++;
+      running--;
+    }, CallbackPriority(i % locomotor::NUM_CALLBACK_PRIORITIES));
+  }
+  ASSERT_TRUE(waitForCallbacks(ex));
+  EXPECT_EQ(200, count);
+  EXPECT_EQ(1, max_running);
+}
+
+TEST(ThreadPoolExecutor, shared_pool)
+{
+  ros::NodeHandle nh("~");
+  auto pool = std::make_shared<ThreadPool>(2);
+  ThreadPoolExecutor ex0(nh, pool), ex1(nh, pool);
+
+  // While one executor is busy, the other executor's callbacks run on the other thread
+  Blocker blocker;
+  ex0.addCallback(blocker.callback(), CallbackPriority::GLOBAL_PLANNING);
+  ASSERT_TRUE(blocker.waitUntilStarted());
+  EXPECT_TRUE(waitForCallbacks(ex1));
+  blocker.release();
+  EXPECT_TRUE(waitForCallbacks(ex0));
+}
+
+TEST(ThreadPoolExecutor, shutdown)
+{
+  ros::NodeHandle nh("~");
+  auto pool = std::make_shared<ThreadPool>(1);
+  std::atomic<bool> finished(false), dropped_ran(false);
+  Blocker blocker;
+  std::future<void> destroyed;
+  {
+    auto ex = std::make_shared<ThreadPoolExecutor>(nh, pool);
+    auto block = blocker.callback();
+    ex->addCallback([&finished, block]
+    {
+      block();
+      finished = true;
+    });
+    ASSERT_TRUE(blocker.waitUntilStarted());
+    ex->addCallback([&dropped_ran] { dropped_ran = true; });
+
+    // The destructor waits for the running callback to finish
+    destroyed = std::async(std::launch::async, [&ex] { ex.reset(); });
+    EXPECT_EQ(std::future_status::timeout, destroyed.wait_for(std::chrono::milliseconds(100)));
+    blocker.release();
+    ASSERT_EQ(std::future_status::ready, destroyed.wait_for(TIMEOUT));
+  }
+  EXPECT_TRUE(finished);
+
+  // The callback that had not started was dropped, and the pool is still usable
+  ThreadPoolExecutor ex(nh, pool);
+  EXPECT_TRUE(waitForCallbacks(ex));
+  EXPECT_FALSE(dropped_ran);
+
+  // Destroying the pool joins the idle workers
+  pool.reset();
+}
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "thread_pool_test");
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
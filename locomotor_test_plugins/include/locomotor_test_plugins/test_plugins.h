@@ -0,0 +1,136 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOCOMOTOR_TEST_PLUGINS_TEST_PLUGINS_H
+#define LOCOMOTOR_TEST_PLUGINS_TEST_PLUGINS_H
+
+#include <nav_core2/basic_costmap.h>
+#include <nav_core2/global_planner.h>
+#include <nav_core2/local_planner.h>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <string>
+
+namespace locomotor_test_plugins
+{
+/**
+ * @brief Lets a test hold up a plugin method until it is ready
+ */
+class Gate
+{
+public:
+  /**
+   * @brief Make the next calls to passGate wait until the gate is opened again
+   */
+  void closeGate();
+  void openGate();
+
+  /**
+   * @brief Wait until a call is waiting at the closed gate
+   * @return False if that did not happen within the timeout
+   */
+  bool waitUntilBlocked(double timeout);
+
+protected:
+  /**
+   * @brief Return immediately if the gate is open, otherwise wait until it is
+   */
+  void passGate();
+
+  boost::mutex gate_mutex_;
+  boost::condition_variable gate_cv_;
+  bool gate_open_ { true };
+  bool blocked_ { false };
+};
+
+/**
+ * @brief Tiny costmap whose cell (0, 0) counts the updates. Closing the gate holds up the updates (with the costmap
+ *        mutex locked).
+ */
+class GatedCostmap : public nav_core2::BasicCostmap, public Gate
+{
+public:
+  void initialize(const ros::NodeHandle& parent, const std::string& name, TFListenerPtr tf) override;
+  void update() override;
+};
+
+/**
+ * @brief Global planner that plans a straight line from the start to the goal
+ */
+class StraightLinePlanner : public nav_core2::GlobalPlanner
+{
+public:
+  void initialize(const ros::NodeHandle& parent, const std::string& name,
+                  TFListenerPtr tf, nav_core2::Costmap::Ptr costmap) override {}
+  nav_2d_msgs::Path2D makePlan(const nav_2d_msgs::Pose2DStamped& start,
+                               const nav_2d_msgs::Pose2DStamped& goal) override;
+};
+
+/**
+ * @brief Local planner that records what it is given, and commands an x velocity equal to the cost of cell (0, 0).
+ *        warmUp records that cost too. Closing the gate holds up setPlan.
+ */
+class RecordingLocalPlanner : public nav_core2::LocalPlanner, public Gate
+{
+public:
+  void initialize(const ros::NodeHandle& parent, const std::string& name,
+                  TFListenerPtr tf, nav_core2::Costmap::Ptr costmap) override;
+  void setGoalPose(const nav_2d_msgs::Pose2DStamped& goal_pose) override;
+  void setPlan(const nav_2d_msgs::Path2D& path) override;
+  nav_2d_msgs::Twist2DStamped computeVelocityCommands(const nav_2d_msgs::Pose2DStamped& pose,
+                                                      const nav_2d_msgs::Twist2D& velocity) override;
+  void warmUp(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity) override;
+  bool isGoalReached(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity) override
+  {
+    return false;
+  }
+
+  unsigned int getNumGoals() const;
+  unsigned int getNumPlans() const;
+  nav_2d_msgs::Path2D getPlan() const;
+  unsigned int getNumWarmUps() const;
+  double getWarmUpCost() const;
+
+protected:
+  nav_core2::Costmap::Ptr costmap_;
+  mutable boost::mutex mutex_;
+  unsigned int num_goals_ { 0 };
+  unsigned int num_plans_ { 0 };
+  nav_2d_msgs::Path2D plan_;
+  unsigned int num_warm_ups_ { 0 };
+  double warm_up_cost_ { -1.0 };
+};
+}  // namespace locomotor_test_plugins
+
+#endif  // LOCOMOTOR_TEST_PLUGINS_TEST_PLUGINS_H
@@ -0,0 +1,166 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <locomotor_test_plugins/test_plugins.h>
+#include <pluginlib/class_list_macros.h>
+#include <string>
+
+namespace locomotor_test_plugins
+{
+void Gate::closeGate()
+{
+  boost::unique_lock<boost::mutex> lock(gate_mutex_);
+  gate_open_ = false;
+}
+
+void Gate::openGate()
+{
+  boost::unique_lock<boost::mutex> lock(gate_mutex_);
+  gate_open_ = true;
+  gate_cv_.notify_all();
+}
+
+bool Gate::waitUntilBlocked(double timeout)
+{
+  boost::unique_lock<boost::mutex> lock(gate_mutex_);
+  return gate_cv_.wait_for(lock, boost::chrono::duration<double>(timeout), [this] { return blocked_; });
+}
+
+void Gate::passGate()
+{
+  boost::unique_lock<boost::mutex> lock(gate_mutex_);
+  blocked_ = !gate_open_;
+  gate_cv_.notify_all();
+  while (!gate_open_)
+  {
+    gate_cv_.wait(lock);
+  }
+  blocked_ = false;
+}
+
+void GatedCostmap::initialize(const ros::NodeHandle& parent, const std::string& name, TFListenerPtr tf)
+{
+  nav_grid::NavGridInfo info;
+  info.width = 2;
+  info.height = 2;
+  info.frame_id = "map";
+  setInfo(info);
+}
+
+void GatedCostmap::update()
+{
+  passGate();
+  setValue(0, 0, getValue(0, 0) + 1);
+}
+
+nav_2d_msgs::Path2D StraightLinePlanner::makePlan(const nav_2d_msgs::Pose2DStamped& start,
+                                                  const nav_2d_msgs::Pose2DStamped& goal)
+{
+  nav_2d_msgs::Path2D path;
+  path.header = goal.header;
+  path.poses.push_back(start.pose);
+  path.poses.push_back(goal.pose);
+  return path;
+}
+
+void RecordingLocalPlanner::initialize(const ros::NodeHandle& parent, const std::string& name,
+                                       TFListenerPtr tf, nav_core2::Costmap::Ptr costmap)
+{
+  costmap_ = costmap;
+}
+
+void RecordingLocalPlanner::setGoalPose(const nav_2d_msgs::Pose2DStamped& goal_pose)
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  num_goals_++;
+}
+
+void RecordingLocalPlanner::setPlan(const nav_2d_msgs::Path2D& path)
+{
+  passGate();
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  num_plans_++;
+  plan_ = path;
+}
+
+nav_2d_msgs::Twist2DStamped RecordingLocalPlanner::computeVelocityCommands(const nav_2d_msgs::Pose2DStamped& pose,
+                                                                           const nav_2d_msgs::Twist2D& velocity)
+{
+  nav_2d_msgs::Twist2DStamped cmd;
+  cmd.header = pose.header;
+  cmd.velocity.x = costmap_->getCost(0, 0);
+  return cmd;
+}
+
+void RecordingLocalPlanner::warmUp(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity)
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  num_warm_ups_++;
+  warm_up_cost_ = costmap_->getCost(0, 0);
+}
+
+unsigned int RecordingLocalPlanner::getNumGoals() const
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  return num_goals_;
+}
+
+unsigned int RecordingLocalPlanner::getNumPlans() const
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  return num_plans_;
+}
+
+nav_2d_msgs::Path2D RecordingLocalPlanner::getPlan() const
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  return plan_;
+}
+
+unsigned int RecordingLocalPlanner::getNumWarmUps() const
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  return num_warm_ups_;
+}
+
+double RecordingLocalPlanner::getWarmUpCost() const
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  return warm_up_cost_;
+}
+}  // namespace locomotor_test_plugins
+
+PLUGINLIB_EXPORT_CLASS(locomotor_test_plugins::GatedCostmap, nav_core2::Costmap)
+PLUGINLIB_EXPORT_CLASS(locomotor_test_plugins::StraightLinePlanner, nav_core2::GlobalPlanner)
+PLUGINLIB_EXPORT_CLASS(locomotor_test_plugins::RecordingLocalPlanner, nav_core2::LocalPlanner)
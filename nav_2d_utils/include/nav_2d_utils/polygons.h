@@ -38,6 +38,7 @@
 #include <ros/ros.h>
 #include <nav_2d_msgs/Polygon2D.h>
 #include <geometry_msgs/Pose2D.h>
+#include <nav_2d_utils/trig_pose.h>
 #include <vector>
 #include <string>
 
@@ -149,6 +150,15 @@ bool equals(const nav_2d_msgs::Polygon2D& polygon0, const nav_2d_msgs::Polygon2D
 nav_2d_msgs::Polygon2D movePolygonToPose(const nav_2d_msgs::Polygon2D& polygon,
                                          const geometry_msgs::Pose2D& pose);
 
+/**
+ * @brief Translate and rotate a polygon to a new pose, using its precomputed cosine/sine
+ * @param polygon The polygon
+ * @param pose The pose to move the polygon to
+ * @return A new moved polygon
+ */
+nav_2d_msgs::Polygon2D movePolygonToPose(const nav_2d_msgs::Polygon2D& polygon,
+                                         const TrigPose2D& pose);
+
 /**
  * @brief Check if a given point is inside of a polygon
  *
@@ -0,0 +1,79 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAV_2D_UTILS_TRIG_POSE_H
+#define NAV_2D_UTILS_TRIG_POSE_H
+
+#include <geometry_msgs/Pose2D.h>
+#include <cmath>
+
+namespace nav_2d_utils
+{
+/**
+ * @struct TrigPose2D
+ * @brief A Pose2D along with the cosine and sine of its heading, so they only need to be computed once
+ */
+struct TrigPose2D
+{
+  TrigPose2D() : cos_theta(1.0), sin_theta(0.0) {}
+  explicit TrigPose2D(const geometry_msgs::Pose2D& pose)
+    : pose(pose), cos_theta(cos(pose.theta)), sin_theta(sin(pose.theta)) {}
+
+  /**
+   * @brief Transform a point from the pose's frame into the parent frame
+   */
+  inline void transformPoint(double x, double y, double& out_x, double& out_y) const
+  {
+    out_x = pose.x + x * cos_theta - y * sin_theta;
+    out_y = pose.y + x * sin_theta + y * cos_theta;
+  }
+
+  /**
+   * @brief The pose distance meters ahead of this pose (with the same heading)
+   */
+  inline geometry_msgs::Pose2D forward(double distance) const
+  {
+    geometry_msgs::Pose2D forward_pose;
+    forward_pose.x = pose.x + distance * cos_theta;
+    forward_pose.y = pose.y + distance * sin_theta;
+    forward_pose.theta = pose.theta;
+    return forward_pose;
+  }
+
+  geometry_msgs::Pose2D pose;
+  double cos_theta, sin_theta;
+};
+}  // namespace nav_2d_utils
+
+#endif  // NAV_2D_UTILS_TRIG_POSE_H
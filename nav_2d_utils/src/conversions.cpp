@@ -143,14 +143,17 @@ nav_2d_msgs::Path2D posesToPath2D(const std::vector<geometry_msgs::PoseStamped>&
   if (poses.empty())
     return path;
 
-  nav_2d_msgs::Pose2DStamped pose;
   path.poses.resize(poses.size());
   path.header.frame_id = poses[0].header.frame_id;
   path.header.stamp = poses[0].header.stamp;
   for (unsigned int i = 0; i < poses.size(); i++)
   {
-    pose = poseStampedToPose2D(poses[i]);
-    path.poses[i] = pose.pose;
+    // Convert just the pose, without copying each header
+    geometry_msgs::Pose2D& pose2d = path.poses[i];
+    const geometry_msgs::Pose& pose = poses[i].pose;
+    pose2d.x = pose.position.x;
+    pose2d.y = pose.position.y;
+    pose2d.theta = tf::getYaw(pose.orientation);
   }
   return path;
 }
@@ -364,16 +364,19 @@ bool equals(const nav_2d_msgs::Polygon2D& polygon0, const nav_2d_msgs::Polygon2D
 
 nav_2d_msgs::Polygon2D movePolygonToPose(const nav_2d_msgs::Polygon2D& polygon,
                                          const geometry_msgs::Pose2D& pose)
+{
+  return movePolygonToPose(polygon, TrigPose2D(pose));
+}
+
+nav_2d_msgs::Polygon2D movePolygonToPose(const nav_2d_msgs::Polygon2D& polygon,
+                                         const TrigPose2D& pose)
 {
   nav_2d_msgs::Polygon2D new_polygon;
   new_polygon.points.resize(polygon.points.size());
-  double cos_th = cos(pose.theta);
-  double sin_th = sin(pose.theta);
   for (unsigned int i = 0; i < polygon.points.size(); ++i)
   {
     nav_2d_msgs::Point2D& new_pt = new_polygon.points[i];
-    new_pt.x = pose.x + polygon.points[i].x * cos_th - polygon.points[i].y * sin_th;
-    new_pt.y = pose.y + polygon.points[i].x * sin_th + polygon.points[i].y * cos_th;
+    pose.transformPoint(polygon.points[i].x, polygon.points[i].y, new_pt.x, new_pt.y);
   }
   return new_polygon;
 }
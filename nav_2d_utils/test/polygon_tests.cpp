@@ -168,6 +168,25 @@ TEST(Polygon2D, test_move)
   EXPECT_DOUBLE_EQ(pose.y,        diamond.points[ 3 ].y);
 }
 
+TEST(Polygon2D, test_move_trig)
+{
+  Polygon2D square = polygonFromString("[[0.5, 0.5], [0.5, -0.5], [-0.5, -0.5], [-0.5, 0.5]]");
+  geometry_msgs::Pose2D pose;
+  pose.x = 15;
+  pose.y = -10;
+  pose.theta = 2.0;
+  nav_2d_utils::TrigPose2D trig_pose(pose);
+  EXPECT_DOUBLE_EQ(cos(pose.theta), trig_pose.cos_theta);
+  EXPECT_DOUBLE_EQ(sin(pose.theta), trig_pose.sin_theta);
+  EXPECT_TRUE(nav_2d_utils::equals(nav_2d_utils::movePolygonToPose(square, pose),
+                                   nav_2d_utils::movePolygonToPose(square, trig_pose)));
+
+  geometry_msgs::Pose2D forward = trig_pose.forward(2.0);
+  EXPECT_DOUBLE_EQ(pose.x + 2.0 * cos(pose.theta), forward.x);
+  EXPECT_DOUBLE_EQ(pose.y + 2.0 * sin(pose.theta), forward.y);
+  EXPECT_DOUBLE_EQ(pose.theta, forward.theta);
+}
+
 TEST(Polygon2D, inside)
 {
   Polygon2D square = polygonFromString("[[0.5, 0.5], [0.5, -0.5], [-0.5, -0.5], [-0.5, 0.5]]");
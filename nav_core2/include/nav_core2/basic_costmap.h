@@ -36,6 +36,7 @@
 #define NAV_CORE2_BASIC_COSTMAP_H
 
 #include <nav_core2/costmap.h>
+#include <nav_core2/change_tracker.h>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,11 @@ class BasicCostmap : public nav_core2::Costmap
 public:
   // Standard Costmap Interface
   mutex_t* getMutex() override { return &my_mutex_; }
+  bool canTrackChanges() override { return true; }
+  UIntBounds getChangeBounds(const std::string& ns) override
+  {
+    return changes_.getChangeBounds(ns, info_.width, info_.height);
+  }
 
   // NavGrid Interface
   void reset() override;
@@ -62,6 +68,7 @@ public:
 protected:
   mutex_t my_mutex_;
   std::vector<unsigned char> data_;
+  ChangeTracker changes_;
 };
 }  // namespace nav_core2
 
@@ -111,6 +111,17 @@ public:
     update(other.min_x_, other.min_y_, other.max_x_, other.max_y_);
   }
 
+  /**
+   * @brief Returns true if the two bounds share at least one point
+   * @param other Another bounds object
+   */
+  bool overlaps(const GenericBounds<NumericType>& other) const
+  {
+    return !isEmpty() && !other.isEmpty()
+           && min_x_ <= other.max_x_ && other.min_x_ <= max_x_
+           && min_y_ <= other.max_y_ && other.min_y_ <= max_y_;
+  }
+
   /**
    * @brief Returns true if the range is empty
    */
@@ -0,0 +1,128 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAV_CORE2_CHANGE_TRACKER_H
+#define NAV_CORE2_CHANGE_TRACKER_H
+
+#include <nav_core2/bounds.h>
+#include <algorithm>
+#include <map>
+#include <string>
+
+namespace nav_core2
+{
+/**
+ * @class ChangeTracker
+ * @brief Keeps track of the bounds of what has changed for each namespace, for implementing Costmap::getChangeBounds
+ *
+ * The costmap reports each change with touch/update, or with touchAll if everything changed (e.g. the info changed).
+ * The changes are added to the bounds of every namespace that has called getChangeBounds before.
+ *
+ * Not thread-safe. The methods should be called with the costmap's mutex locked.
+ */
+class ChangeTracker
+{
+public:
+  /**
+   * @brief Mark the cell (x, y) as changed
+   */
+  void touch(unsigned int x, unsigned int y)
+  {
+    for (auto& entry : bounds_)
+    {
+      entry.second.touch(x, y);
+    }
+  }
+
+  /**
+   * @brief Mark the cells in [x0, x1] x [y0, y1] as changed
+   */
+  void update(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1)
+  {
+    for (auto& entry : bounds_)
+    {
+      entry.second.update(x0, y0, x1, y1);
+    }
+  }
+
+  /**
+   * @brief Mark the cells within the bounds as changed
+   */
+  void update(const UIntBounds& bounds)
+  {
+    if (bounds.isEmpty()) return;
+    update(bounds.getMinX(), bounds.getMinY(), bounds.getMaxX(), bounds.getMaxY());
+  }
+
+  /**
+   * @brief Mark the whole costmap as changed
+   */
+  void touchAll(unsigned int width, unsigned int height)
+  {
+    if (width == 0 || height == 0) return;
+    update(0, 0, width - 1, height - 1);
+  }
+
+  /**
+   * @brief Get the bounds of what has changed since the last call with this namespace, and reset them
+   *
+   * The first call for a namespace returns the whole costmap. The bounds are clipped to the current size.
+   */
+  UIntBounds getChangeBounds(const std::string& ns, unsigned int width, unsigned int height)
+  {
+    UIntBounds changed;
+    auto it = bounds_.find(ns);
+    if (it == bounds_.end())
+    {
+      bounds_[ns] = UIntBounds();
+      if (width == 0 || height == 0) return changed;
+      return UIntBounds(0, 0, width - 1, height - 1);
+    }
+    changed = it->second;
+    it->second.reset();
+
+    if (changed.isEmpty() || width == 0 || height == 0 || changed.getMinX() >= width || changed.getMinY() >= height)
+    {
+      return UIntBounds();
+    }
+    return UIntBounds(changed.getMinX(), changed.getMinY(),
+                      std::min(changed.getMaxX(), width - 1), std::min(changed.getMaxY(), height - 1));
+  }
+
+protected:
+  std::map<std::string, UIntBounds> bounds_;
+};
+}  // namespace nav_core2
+
+#endif  // NAV_CORE2_CHANGE_TRACKER_H
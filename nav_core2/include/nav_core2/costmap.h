@@ -36,10 +36,15 @@
 #define NAV_CORE2_COSTMAP_H
 
 #include <nav_grid/nav_grid.h>
+#include <nav_grid/vector_nav_grid.h>
 #include <nav_core2/common.h>
 #include <nav_core2/bounds.h>
 #include <boost/thread.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace nav_core2
 {
@@ -71,16 +76,42 @@ public:
    */
   virtual void initialize(const ros::NodeHandle& parent, const std::string& name, TFListenerPtr tf) {}
 
-  inline unsigned char getCost(const unsigned int x, const unsigned int y)
+  /**
+   * @brief Get the cost of a cell, reading the char map directly if the derived class provides one
+   *
+   * This avoids the virtual call to getValue for each cell. Like getValue, it does not check the bounds.
+   */
+  inline unsigned char operator()(const unsigned int x, const unsigned int y) const
   {
+    if (char_map_)
+    {
+      return char_map_[y * info_.width + x];
+    }
     return getValue(x, y);
   }
 
+  inline unsigned char operator()(const nav_grid::Index& index) const
+  {
+    return operator()(index.x, index.y);
+  }
+
+  inline unsigned char getCost(const unsigned int x, const unsigned int y)
+  {
+    return operator()(x, y);
+  }
+
   inline unsigned char getCost(const nav_grid::Index& index)
   {
-    return getValue(index.x, index.y);
+    return operator()(index.x, index.y);
   }
 
+  /**
+   * @brief The costs in row-major order (with getWidth() cells per row), or nullptr if not stored contiguously
+   *
+   * The pointer is only valid while the mutex is held, and until the next call to update, setInfo or updateInfo.
+   */
+  const unsigned char* getCharMap() const { return char_map_; }
+
   inline void setCost(const unsigned int x, const unsigned int y, const unsigned char cost)
   {
     setValue(x, y, cost);
@@ -100,6 +131,11 @@ public:
    */
   virtual void update() {}
 
+  /**
+   * @brief The getChangeBounds namespace reserved for recording the changes between snapshots
+   */
+  static constexpr const char* SNAPSHOT_NAMESPACE = "__snapshot__";
+
   using mutex_t = boost::recursive_mutex;
   /**
    * @brief Accessor for boost mutex
@@ -149,6 +185,126 @@ public:
     }
     return UIntBounds();
   }
+
+  /**
+   * @brief Immutable copy of the costmap's contents at a point in time
+   *
+   * Each snapshot also records what changed between it and the last few snapshots before it, so that readers
+   * (i.e. SnapshotCostmap) can track the changes in what they read without consuming the costmap's change bounds.
+   */
+  class Snapshot : public nav_grid::VectorNavGrid<unsigned char>
+  {
+  public:
+    using nav_grid::VectorNavGrid<unsigned char>::VectorNavGrid;
+
+    /**
+     * @brief Number of snapshots the costmap published before this one
+     */
+    unsigned int sequence { 0 };
+
+    /**
+     * @brief changes[i] is the region that changed between snapshots (sequence - i - 1) and (sequence - i)
+     */
+    std::vector<UIntBounds> changes;
+  };
+  using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+  /**
+   * @brief Get the most recently published snapshot, without locking the mutex
+   *
+   * The snapshot is unaffected by any later changes to the costmap, so it can be read for as long as needed
+   * while the costmap continues to be updated.
+   *
+   * @return The snapshot, or nullptr if publishSnapshot has never been called
+   */
+  SnapshotPtr getSnapshot() const
+  {
+    return std::atomic_load(&snapshot_);
+  }
+
+  /**
+   * @brief Copy the current contents of the costmap into a new snapshot for getSnapshot to return
+   *
+   * Should be called with the mutex locked, i.e. by whatever is updating the costmap, once the update is complete.
+   * The buffer of an older snapshot is reused if no one is still holding on to it. If canTrackChanges, the changes
+   * since the previous snapshot are read with the SNAPSHOT_NAMESPACE namespace, which does not affect any other.
+   */
+  void publishSnapshot()
+  {
+    // How many snapshots back the changes are recorded for
+    const unsigned int CHANGE_HISTORY = 16;
+
+    SnapshotPtr previous = getSnapshot();
+    UIntBounds changed;
+    if (canTrackChanges())
+    {
+      changed = getChangeBounds(SNAPSHOT_NAMESPACE);
+    }
+    else if (info_.width > 0 && info_.height > 0)
+    {
+      changed = UIntBounds(0, 0, info_.width - 1, info_.height - 1);
+    }
+
+    std::shared_ptr<Snapshot> snapshot;
+    if (spare_snapshot_ && spare_snapshot_.use_count() == 1)
+    {
+      // Make sure the last reader is done with the buffer before we overwrite it
+      std::atomic_thread_fence(std::memory_order_acquire);
+      snapshot = spare_snapshot_;
+    }
+    else
+    {
+      snapshot = std::make_shared<Snapshot>();
+    }
+    copyTo(*snapshot);
+    snapshot->sequence = previous ? previous->sequence + 1 : 0;
+    snapshot->changes.clear();
+    snapshot->changes.push_back(changed);
+    if (previous)
+    {
+      unsigned int kept = std::min(static_cast<unsigned int>(previous->changes.size()), CHANGE_HISTORY - 1);
+      snapshot->changes.insert(snapshot->changes.end(), previous->changes.begin(), previous->changes.begin() + kept);
+    }
+    spare_snapshot_ = std::const_pointer_cast<Snapshot>(std::atomic_exchange(&snapshot_, SnapshotPtr(snapshot)));
+  }
+
+protected:
+  /**
+   * @brief Copy the contents of the costmap into the given grid, resizing it as needed
+   *
+   * Derived classes without a char map can override this with something faster than calling getValue for each cell.
+   */
+  virtual void copyTo(nav_grid::VectorNavGrid<unsigned char>& destination) const
+  {
+    destination.setInfo(info_);
+    if (char_map_)
+    {
+      unsigned int size = info_.width * info_.height;
+      for (unsigned int i = 0; i < size; i++)
+      {
+        destination[i] = char_map_[i];
+      }
+      return;
+    }
+    unsigned int i = 0;
+    for (unsigned int y = 0; y < info_.height; y++)
+    {
+      for (unsigned int x = 0; x < info_.width; x++)
+      {
+        destination[i++] = getValue(x, y);
+      }
+    }
+  }
+
+  /**
+   * @brief Derived classes that store their costs contiguously in row-major order should point this at them,
+   * and keep it up to date whenever the storage changes. Otherwise, the costs are read with getValue.
+   */
+  const unsigned char* char_map_ { nullptr };
+
+private:
+  SnapshotPtr snapshot_;
+  std::shared_ptr<Snapshot> spare_snapshot_;
 };
 }  // namespace nav_core2
 
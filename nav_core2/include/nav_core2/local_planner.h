@@ -36,6 +36,7 @@
 
 #include <nav_core2/common.h>
 #include <nav_core2/costmap.h>
+#include <nav_core2/transform_cache.h>
 #include <nav_2d_msgs/Path2D.h>
 #include <nav_2d_msgs/Pose2DStamped.h>
 #include <nav_2d_msgs/Twist2D.h>
@@ -71,6 +72,16 @@ public:
   virtual void initialize(const ros::NodeHandle& parent, const std::string& name,
                           TFListenerPtr tf, Costmap::Ptr costmap) = 0;
 
+  /**
+   * @brief Share a TransformCache with the local planner, to use instead of looking up transforms with TF directly
+   *
+   * The caller clears the cache before each call to computeVelocityCommands/isGoalReached, so it is safe to
+   * keep using the transforms from it for the rest of that call. Planners that don't use the cache can ignore this.
+   *
+   * @param cache The cache. Only called from the thread the planner is used from.
+   */
+  virtual void setTransformCache(TransformCache::Ptr cache) {}
+
   /**
    * @brief Sets the global goal for this local planner.
    * @param goal_pose The Goal Pose
@@ -97,6 +108,19 @@ public:
   virtual nav_2d_msgs::Twist2DStamped computeVelocityCommands(const nav_2d_msgs::Pose2DStamped& pose,
                                                               const nav_2d_msgs::Twist2D& velocity) = 0;
 
+  /**
+   * @brief Get ready to compute commands for the given pose and velocity, without computing one
+   *
+   * Called periodically on planners that are not currently in use, so that whatever they otherwise set up on the
+   * first call to computeVelocityCommands (e.g. grids sized to the costmap, caches, preallocated buffers) is ready
+   * when they are switched to. The caller holds the costmap's mutex (or the costmap does not change during the call).
+   * Optional. By default, nothing is done.
+   *
+   * @param pose      Current robot pose
+   * @param velocity  Current robot velocity
+   */
+  virtual void warmUp(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity) {}
+
   /**
    * @brief Check to see whether the robot has reached its goal
    *
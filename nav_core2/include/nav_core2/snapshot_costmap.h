@@ -0,0 +1,146 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAV_CORE2_SNAPSHOT_COSTMAP_H
+#define NAV_CORE2_SNAPSHOT_COSTMAP_H
+
+#include <nav_core2/costmap.h>
+#include <nav_core2/change_tracker.h>
+#include <stdexcept>
+#include <string>
+
+namespace nav_core2
+{
+/**
+ * @class SnapshotCostmap
+ * @brief Read-only Costmap that reads from a snapshot of another costmap
+ *
+ * This allows planners to read a consistent version of the costmap without holding the costmap's mutex
+ * (and thus blocking updates) for the duration of planning. Calling refresh switches to the most recently published
+ * snapshot in O(1). Only the thread calling refresh should be reading from this costmap at the time.
+ *
+ * The change bounds are tracked separately from the source costmap's: they cover what changed between the
+ * snapshots this costmap has read (as recorded in the snapshots themselves), and getChangeBounds does not consume
+ * any of the source costmap's change bounds.
+ */
+class SnapshotCostmap : public nav_core2::Costmap
+{
+public:
+  explicit SnapshotCostmap(Costmap::Ptr source) : source_(source)
+  {
+    refresh();
+  }
+
+  /**
+   * @brief Switch to the source costmap's latest snapshot, publishing one if it has never done so
+   */
+  void refresh()
+  {
+    SnapshotPtr snapshot = source_->getSnapshot();
+    if (!snapshot)
+    {
+      boost::unique_lock<mutex_t> lock(*(source_->getMutex()));
+      source_->publishSnapshot();
+      snapshot = source_->getSnapshot();
+    }
+    boost::unique_lock<mutex_t> lock(my_mutex_);
+    if (snapshot_)
+    {
+      recordChanges(*snapshot_, *snapshot);
+    }
+    snapshot_ = snapshot;
+    info_ = snapshot_->getInfo();
+    char_map_ = snapshot_->data();
+  }
+
+  Costmap::Ptr getSource() const { return source_; }
+
+  // Standard Costmap Interface
+  mutex_t* getMutex() override { return &my_mutex_; }
+  bool canTrackChanges() override { return source_->canTrackChanges(); }
+  UIntBounds getChangeBounds(const std::string& ns) override
+  {
+    boost::unique_lock<mutex_t> lock(my_mutex_);
+    return changes_.getChangeBounds(ns, info_.width, info_.height);
+  }
+
+  // NavGrid Interface
+  unsigned char getValue(const unsigned int x, const unsigned int y) const override
+  {
+    return (*snapshot_)[y * info_.width + x];
+  }
+
+  void reset() override
+  {
+    throw std::runtime_error("SnapshotCostmap is read-only.");
+  }
+
+  void setValue(const unsigned int x, const unsigned int y, const unsigned char& value) override
+  {
+    throw std::runtime_error("SnapshotCostmap is read-only.");
+  }
+
+  void setInfo(const nav_grid::NavGridInfo& new_info) override
+  {
+    throw std::runtime_error("SnapshotCostmap is read-only.");
+  }
+
+protected:
+  /**
+   * @brief Add everything that changed between the two snapshots to changes_
+   */
+  void recordChanges(const Snapshot& old_snapshot, const Snapshot& new_snapshot)
+  {
+    unsigned int count = new_snapshot.sequence - old_snapshot.sequence;
+    if (new_snapshot.getInfo() != old_snapshot.getInfo() || new_snapshot.sequence < old_snapshot.sequence ||
+        count > new_snapshot.changes.size())
+    {
+      // Too far back to know what changed
+      changes_.touchAll(new_snapshot.getWidth(), new_snapshot.getHeight());
+      return;
+    }
+    for (unsigned int i = 0; i < count; i++)
+    {
+      changes_.update(new_snapshot.changes[i]);
+    }
+  }
+
+  Costmap::Ptr source_;
+  SnapshotPtr snapshot_;
+  ChangeTracker changes_;
+  mutex_t my_mutex_;
+};
+}  // namespace nav_core2
+
+#endif  // NAV_CORE2_SNAPSHOT_COSTMAP_H
@@ -0,0 +1,186 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAV_CORE2_TRANSFORM_CACHE_H
+#define NAV_CORE2_TRANSFORM_CACHE_H
+
+#include <nav_core2/common.h>
+#include <nav_2d_msgs/Pose2DStamped.h>
+#include <geometry_msgs/PoseStamped.h>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace nav_core2
+{
+/**
+ * @class TransformCache
+ * @brief Caches the 2D transforms between frames so that each one is looked up from TF at most once per cycle
+ *
+ * The first time a pose is transformed from frame A to frame B at time t, the 2D transform from A to B at t is
+ * looked up with the TransformListener. Until clear is called, transforming any other pose from A to B at t is then
+ * just an SE(2) multiplication. The owner of the cache should call clear at the start of each cycle (i.e. control
+ * loop), since transforms at time zero (i.e. the latest transform) change between cycles.
+ *
+ * Like nav_2d_utils::transformPose, poses already in the target frame are returned immediately, and if the
+ * transform at time t would require extrapolation, the latest transform is used instead.
+ *
+ * Not thread-safe. Each cache should be used by one thread at a time.
+ */
+class TransformCache
+{
+public:
+  using Ptr = std::shared_ptr<TransformCache>;
+
+  explicit TransformCache(TFListenerPtr tf) : tf_(tf) {}
+
+  /**
+   * @brief Forget all the cached transforms
+   */
+  void clear() { transforms_.clear(); }
+
+  /**
+   * @brief Transform a Pose2DStamped from one frame to another
+   * @param frame Frame to transform the pose into
+   * @param in_pose Pose to transform
+   * @param out_pose Place to store the resulting transformed pose
+   * @return True if successful transform
+   */
+  bool transformPose(const std::string& frame, const nav_2d_msgs::Pose2DStamped& in_pose,
+                     nav_2d_msgs::Pose2DStamped& out_pose)
+  {
+    if (in_pose.header.frame_id == frame)
+    {
+      out_pose = in_pose;
+      return true;
+    }
+
+    const Transform2D* transform = getTransform(in_pose.header.frame_id, frame, in_pose.header.stamp);
+    if (!transform)
+    {
+      return false;
+    }
+    out_pose.header.frame_id = frame;
+    out_pose.header.stamp = transform->stamp;
+    out_pose.pose = transform->apply(in_pose.pose);
+    return true;
+  }
+
+  /**
+   * @brief Transform a Pose2DStamped into the given frame, returning just the pose (which is zero if it fails)
+   */
+  geometry_msgs::Pose2D transformStampedPose(const nav_2d_msgs::Pose2DStamped& pose, const std::string& frame)
+  {
+    nav_2d_msgs::Pose2DStamped out_pose;
+    transformPose(frame, pose, out_pose);
+    return out_pose.pose;
+  }
+
+  unsigned int getNumLookups() const { return num_lookups_; }
+
+protected:
+  struct Transform2D
+  {
+    double x, y, theta, cos_theta, sin_theta;
+    ros::Time stamp;
+
+    geometry_msgs::Pose2D apply(const geometry_msgs::Pose2D& pose) const
+    {
+      geometry_msgs::Pose2D out;
+      out.x = x + cos_theta * pose.x - sin_theta * pose.y;
+      out.y = y + sin_theta * pose.x + cos_theta * pose.y;
+      out.theta = remainder(theta + pose.theta, 2.0 * M_PI);
+      return out;
+    }
+  };
+
+  using Key = std::tuple<std::string, std::string, ros::Time>;
+
+  /**
+   * @brief Get the transform from source_frame to target_frame at the given time, looking it up if needed
+   * @return nullptr if the transform could not be looked up
+   */
+  const Transform2D* getTransform(const std::string& source_frame, const std::string& target_frame,
+                                  const ros::Time& stamp)
+  {
+    Key key(source_frame, target_frame, stamp);
+    auto it = transforms_.find(key);
+    if (it != transforms_.end())
+    {
+      return &it->second;
+    }
+
+    // Transform the origin of the source frame, which gives the transform between the frames
+    geometry_msgs::PoseStamped origin, transformed;
+    origin.header.frame_id = source_frame;
+    origin.header.stamp = stamp;
+    origin.pose.orientation.w = 1.0;
+    num_lookups_++;
+    try
+    {
+      try
+      {
+        tf_->transformPose(target_frame, origin, transformed);
+      }
+      catch (tf::ExtrapolationException& ex)
+      {
+        origin.header.stamp = ros::Time();
+        tf_->transformPose(target_frame, origin, transformed);
+      }
+    }
+    catch (tf::TransformException& ex)
+    {
+      ROS_ERROR("Exception in transformPose: %s", ex.what());
+      return nullptr;
+    }
+
+    Transform2D& transform = transforms_[key];
+    transform.x = transformed.pose.position.x;
+    transform.y = transformed.pose.position.y;
+    transform.theta = tf::getYaw(transformed.pose.orientation);
+    transform.cos_theta = cos(transform.theta);
+    transform.sin_theta = sin(transform.theta);
+    transform.stamp = transformed.header.stamp;
+    return &transform;
+  }
+
+  TFListenerPtr tf_;
+  std::map<Key, Transform2D> transforms_;
+  unsigned int num_lookups_ { 0 };
+};
+}  // namespace nav_core2
+
+#endif  // NAV_CORE2_TRANSFORM_CACHE_H
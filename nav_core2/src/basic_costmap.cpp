@@ -40,6 +40,8 @@ namespace nav_core2
 void BasicCostmap::reset()
 {
   data_.assign(info_.width * info_.height, this->default_value_);
+  char_map_ = data_.data();
+  changes_.touchAll(info_.width, info_.height);
 }
 
 unsigned int BasicCostmap::getIndex(const unsigned int x, const unsigned int y) const
@@ -55,6 +57,7 @@ unsigned char BasicCostmap::getValue(const unsigned int x, const unsigned int y)
 void BasicCostmap::setValue(const unsigned int x, const unsigned int y, const unsigned char& value)
 {
   data_[getIndex(x, y)] = value;
+  changes_.touch(x, y);
 }
 
 }  // namespace nav_core2
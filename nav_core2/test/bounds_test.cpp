@@ -63,6 +63,21 @@ TEST(Bounds, test_bounds_simple)
   EXPECT_TRUE(b.isEmpty());
 }
 
+TEST(Bounds, test_bounds_overlap)
+{
+  Bounds a(0.0, 0.0, 2.0, 2.0);
+  Bounds b(1.0, 1.0, 3.0, 3.0);
+  Bounds c(2.5, 0.0, 4.0, 0.5);
+  Bounds empty;
+  EXPECT_TRUE(a.overlaps(b));
+  EXPECT_TRUE(b.overlaps(a));
+  EXPECT_FALSE(a.overlaps(c));
+  EXPECT_TRUE(b.overlaps(Bounds(3.0, 3.0, 5.0, 5.0)));
+  EXPECT_FALSE(b.overlaps(c));
+  EXPECT_FALSE(a.overlaps(empty));
+  EXPECT_FALSE(empty.overlaps(empty));
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
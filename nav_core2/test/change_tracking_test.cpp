@@ -0,0 +1,92 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <nav_core2/basic_costmap.h>
+#include <string>
+
+using nav_core2::BasicCostmap;
+using nav_core2::UIntBounds;
+
+void expectBounds(const UIntBounds& b, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1)
+{
+  ASSERT_FALSE(b.isEmpty());
+  EXPECT_EQ(x0, b.getMinX());
+  EXPECT_EQ(y0, b.getMinY());
+  EXPECT_EQ(x1, b.getMaxX());
+  EXPECT_EQ(y1, b.getMaxY());
+}
+
+TEST(ChangeTracking, documented_sequence)
+{
+  BasicCostmap costmap;
+  nav_grid::NavGridInfo info;
+  info.width = 5;
+  info.height = 5;
+  costmap.setInfo(info);
+  ASSERT_TRUE(costmap.canTrackChanges());
+
+  expectBounds(costmap.getChangeBounds("A"), 0, 0, 4, 4);
+  expectBounds(costmap.getChangeBounds("B"), 0, 0, 4, 4);
+  costmap.setCost(1, 1, 100);
+  expectBounds(costmap.getChangeBounds("C"), 0, 0, 4, 4);
+  expectBounds(costmap.getChangeBounds("A"), 1, 1, 1, 1);
+  EXPECT_TRUE(costmap.getChangeBounds("A").isEmpty());
+  costmap.setCost(2, 4, 100);
+  expectBounds(costmap.getChangeBounds("A"), 2, 4, 2, 4);
+  expectBounds(costmap.getChangeBounds("B"), 1, 1, 2, 4);
+}
+
+TEST(ChangeTracking, resize)
+{
+  BasicCostmap costmap;
+  nav_grid::NavGridInfo info;
+  info.width = 10;
+  info.height = 10;
+  costmap.setInfo(info);
+  costmap.getChangeBounds("A");
+  costmap.setCost(9, 9, 100);
+
+  // Everything changes when the info changes, and the bounds are clipped to the new size
+  info.width = 3;
+  info.height = 4;
+  costmap.setInfo(info);
+  expectBounds(costmap.getChangeBounds("A"), 0, 0, 2, 3);
+  EXPECT_TRUE(costmap.getChangeBounds("A").isEmpty());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
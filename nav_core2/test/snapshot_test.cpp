@@ -0,0 +1,194 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <nav_core2/basic_costmap.h>
+#include <nav_core2/snapshot_costmap.h>
+#include <memory>
+#include <stdexcept>
+
+using nav_core2::BasicCostmap;
+using nav_core2::Costmap;
+using nav_core2::SnapshotCostmap;
+using nav_core2::UIntBounds;
+
+std::shared_ptr<BasicCostmap> makeCostmap()
+{
+  auto costmap = std::make_shared<BasicCostmap>();
+  nav_grid::NavGridInfo info;
+  info.width = 4;
+  info.height = 3;
+  costmap->setInfo(info);
+  return costmap;
+}
+
+void expectBounds(const UIntBounds& b, unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1)
+{
+  ASSERT_FALSE(b.isEmpty());
+  EXPECT_EQ(x0, b.getMinX());
+  EXPECT_EQ(y0, b.getMinY());
+  EXPECT_EQ(x1, b.getMaxX());
+  EXPECT_EQ(y1, b.getMaxY());
+}
+
+TEST(Snapshot, publish)
+{
+  auto costmap = makeCostmap();
+  EXPECT_FALSE(costmap->getSnapshot());
+
+  costmap->setCost(3, 2, 100);
+  costmap->publishSnapshot();
+  Costmap::SnapshotPtr snapshot = costmap->getSnapshot();
+  ASSERT_TRUE(snapshot.get());
+  EXPECT_EQ(costmap->getInfo(), snapshot->getInfo());
+  EXPECT_EQ(100, (*snapshot)(3, 2));
+
+  // Later changes are not visible in the snapshot
+  costmap->setCost(3, 2, 200);
+  costmap->publishSnapshot();
+  costmap->setCost(0, 0, 50);
+  costmap->publishSnapshot();
+  EXPECT_EQ(100, (*snapshot)(3, 2));
+  EXPECT_EQ(0, (*snapshot)(0, 0));
+  EXPECT_EQ(200, (*costmap->getSnapshot())(3, 2));
+  EXPECT_EQ(50, (*costmap->getSnapshot())(0, 0));
+}
+
+TEST(Snapshot, snapshot_costmap)
+{
+  auto costmap = makeCostmap();
+  costmap->setCost(1, 1, 10);
+
+  // Publishes the first snapshot if needed
+  SnapshotCostmap view(costmap);
+  EXPECT_EQ(10, view.getCost(1, 1));
+  EXPECT_EQ(4u, view.getWidth());
+
+  costmap->setCost(1, 1, 20);
+  costmap->publishSnapshot();
+  EXPECT_EQ(10, view.getCost(1, 1));
+  view.refresh();
+  EXPECT_EQ(20, view.getCost(1, 1));
+
+  EXPECT_THROW(view.setCost(1, 1, 0), std::runtime_error);
+  EXPECT_NE(costmap->getMutex(), view.getMutex());
+}
+
+TEST(Snapshot, char_map)
+{
+  auto costmap = makeCostmap();
+  costmap->setCost(2, 1, 30);
+  const unsigned char* char_map = costmap->getCharMap();
+  ASSERT_TRUE(char_map);
+  EXPECT_EQ(30, char_map[1 * 4 + 2]);
+  EXPECT_EQ(30, (*costmap)(2, 1));
+
+  // The char map is reallocated when the costmap is resized
+  nav_grid::NavGridInfo info = costmap->getInfo();
+  info.width = 100;
+  costmap->setInfo(info);
+  costmap->setCost(99, 2, 40);
+  EXPECT_EQ(40, costmap->getCharMap()[2 * 100 + 99]);
+  EXPECT_EQ(40, (*costmap)(99, 2));
+
+  SnapshotCostmap view(costmap);
+  ASSERT_TRUE(view.getCharMap());
+  EXPECT_EQ(40, view(99, 2));
+  EXPECT_EQ(40, view.getValue(99, 2));
+}
+
+TEST(Snapshot, change_bounds)
+{
+  auto costmap = makeCostmap();
+  expectBounds(costmap->getChangeBounds("live"), 0, 0, 3, 2);
+
+  SnapshotCostmap view(costmap);
+  ASSERT_TRUE(view.canTrackChanges());
+  expectBounds(view.getChangeBounds("planner"), 0, 0, 3, 2);
+  EXPECT_TRUE(view.getChangeBounds("planner").isEmpty());
+
+  // Two snapshots, with an update between them
+  costmap->setCost(1, 1, 10);
+  costmap->publishSnapshot();
+  costmap->setCost(3, 2, 20);
+  costmap->publishSnapshot();
+
+  // The view has not switched to the new snapshots yet, so nothing it reads has changed
+  EXPECT_TRUE(view.getChangeBounds("planner").isEmpty());
+  view.refresh();
+  expectBounds(view.getChangeBounds("planner"), 1, 1, 3, 2);
+  EXPECT_TRUE(view.getChangeBounds("planner").isEmpty());
+
+  // The view does not consume the live costmap's change bounds
+  expectBounds(costmap->getChangeBounds("live"), 1, 1, 3, 2);
+
+  // Changes that are not in a snapshot yet are reported by the costmap but not the view
+  costmap->setCost(0, 0, 5);
+  expectBounds(costmap->getChangeBounds("live"), 0, 0, 0, 0);
+  view.refresh();
+  EXPECT_TRUE(view.getChangeBounds("planner").isEmpty());
+  costmap->publishSnapshot();
+  view.refresh();
+  expectBounds(view.getChangeBounds("planner"), 0, 0, 0, 0);
+}
+
+TEST(Snapshot, change_bounds_history)
+{
+  auto costmap = makeCostmap();
+  SnapshotCostmap view(costmap);
+  view.getChangeBounds("planner");
+
+  // If the view falls too far behind, everything is reported as changed
+  for (unsigned int i = 0; i < 100; i++)
+  {
+    costmap->publishSnapshot();
+  }
+  costmap->setCost(2, 2, 1);
+  costmap->publishSnapshot();
+  view.refresh();
+  expectBounds(view.getChangeBounds("planner"), 0, 0, 3, 2);
+
+  // Resizing the costmap also changes everything
+  nav_grid::NavGridInfo info = costmap->getInfo();
+  info.width = 6;
+  costmap->setInfo(info);
+  costmap->publishSnapshot();
+  view.refresh();
+  expectBounds(view.getChangeBounds("planner"), 0, 0, 5, 2);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <nav_core2/transform_cache.h>
+#include <tf/transform_listener.h>
+#include <memory>
+
+using nav_core2::TransformCache;
+
+const double EPSILON = 1e-6;
+
+void setTransform(tf::TransformListener& tf, double x, double y, double yaw, const ros::Time& stamp)
+{
+  tf::StampedTransform transform(tf::Transform(tf::createQuaternionFromYaw(yaw), tf::Vector3(x, y, 0.0)),
+                                 stamp, "map", "odom");
+  tf.setTransform(transform);
+}
+
+nav_2d_msgs::Pose2DStamped makePose(double x, double y, double theta, const std::string& frame = "odom",
+                                    const ros::Time& stamp = ros::Time())
+{
+  nav_2d_msgs::Pose2DStamped pose;
+  pose.header.frame_id = frame;
+  pose.header.stamp = stamp;
+  pose.pose.x = x;
+  pose.pose.y = y;
+  pose.pose.theta = theta;
+  return pose;
+}
+
+void expectPose(const nav_2d_msgs::Pose2DStamped& pose, double x, double y, double theta)
+{
+  EXPECT_EQ("map", pose.header.frame_id);
+  EXPECT_NEAR(x, pose.pose.x, EPSILON);
+  EXPECT_NEAR(y, pose.pose.y, EPSILON);
+  EXPECT_NEAR(theta, pose.pose.theta, EPSILON);
+}
+
+TEST(TransformCache, cache_hit)
+{
+  auto tf = std::make_shared<tf::TransformListener>(ros::Duration(10));
+  ros::Time stamp = ros::Time::now();
+  setTransform(*tf, 1.0, 2.0, M_PI / 2, stamp);
+
+  TransformCache cache(tf);
+  nav_2d_msgs::Pose2DStamped out;
+  ASSERT_TRUE(cache.transformPose("map", makePose(1.0, 0.0, 0.0), out));
+  expectPose(out, 1.0, 3.0, M_PI / 2);
+  EXPECT_EQ(stamp, out.header.stamp);
+  EXPECT_EQ(1u, cache.getNumLookups());
+
+  // The same frames and time reuse the transform
+  ASSERT_TRUE(cache.transformPose("map", makePose(0.0, 1.0, 0.5), out));
+  expectPose(out, 0.0, 2.0, M_PI / 2 + 0.5);
+  EXPECT_EQ(1u, cache.getNumLookups());
+
+  // Poses already in the target frame are not transformed at all
+  ASSERT_TRUE(cache.transformPose("map", makePose(4.0, 5.0, 0.25, "map"), out));
+  expectPose(out, 4.0, 5.0, 0.25);
+  EXPECT_EQ(1u, cache.getNumLookups());
+
+  // The theta is normalized
+  ASSERT_TRUE(cache.transformPose("map", makePose(0.0, 0.0, 3.0), out));
+  expectPose(out, 1.0, 2.0, M_PI / 2 + 3.0 - 2 * M_PI);
+  EXPECT_EQ(1u, cache.getNumLookups());
+}
+
+TEST(TransformCache, clear_each_cycle)
+{
+  auto tf = std::make_shared<tf::TransformListener>(ros::Duration(10));
+  ros::Time stamp = ros::Time::now();
+  setTransform(*tf, 1.0, 0.0, 0.0, stamp);
+
+  TransformCache cache(tf);
+  nav_2d_msgs::Pose2DStamped out;
+  ASSERT_TRUE(cache.transformPose("map", makePose(1.0, 0.0, 0.0), out));
+  expectPose(out, 2.0, 0.0, 0.0);
+
+  // Within a cycle, the latest transform does not change, even if TF does
+  setTransform(*tf, 5.0, 0.0, 0.0, stamp + ros::Duration(1.0));
+  ASSERT_TRUE(cache.transformPose("map", makePose(1.0, 0.0, 0.0), out));
+  expectPose(out, 2.0, 0.0, 0.0);
+  EXPECT_EQ(1u, cache.getNumLookups());
+
+  // The next cycle looks it up again
+  cache.clear();
+  ASSERT_TRUE(cache.transformPose("map", makePose(1.0, 0.0, 0.0), out));
+  expectPose(out, 6.0, 0.0, 0.0);
+  EXPECT_EQ(2u, cache.getNumLookups());
+
+  // A pose at a specific time is a separate entry. One after the latest transform uses the latest transform instead.
+  ASSERT_TRUE(cache.transformPose("map", makePose(1.0, 0.0, 0.0, "odom", stamp + ros::Duration(10.0)), out));
+  expectPose(out, 6.0, 0.0, 0.0);
+  EXPECT_EQ(3u, cache.getNumLookups());
+}
+
+TEST(TransformCache, lookup_failure)
+{
+  auto tf = std::make_shared<tf::TransformListener>(ros::Duration(10));
+  TransformCache cache(tf);
+  nav_2d_msgs::Pose2DStamped out;
+  EXPECT_FALSE(cache.transformPose("map", makePose(1.0, 0.0, 0.0, "unknown"), out));
+
+  // Failures are not cached
+  EXPECT_FALSE(cache.transformPose("map", makePose(1.0, 0.0, 0.0, "unknown"), out));
+  EXPECT_EQ(2u, cache.getNumLookups());
+}
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "transform_cache_test");
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
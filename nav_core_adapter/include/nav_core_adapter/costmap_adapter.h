@@ -37,7 +37,9 @@
 
 #include <nav_core2/common.h>
 #include <nav_core2/costmap.h>
+#include <nav_core2/change_tracker.h>
 #include <costmap_2d/costmap_2d_ros.h>
+#include <memory>
 #include <string>
 
 namespace nav_core_adapter
@@ -62,6 +64,8 @@ public:
   // Standard Costmap Interface
   void initialize(const ros::NodeHandle& parent, const std::string& name, TFListenerPtr tf) override;
   nav_core2::Costmap::mutex_t* getMutex() override;
+  bool canTrackChanges() override { return true; }
+  nav_core2::UIntBounds getChangeBounds(const std::string& ns) override;
 
   // NavGrid Interface
   void reset() override;
@@ -71,6 +75,13 @@ public:
   void setInfo(const nav_grid::NavGridInfo& new_info) override;
   void updateInfo(const nav_grid::NavGridInfo& new_info) override;
 
+  /**
+   * @brief Reread the info and the char map from the Costmap2D, which may have been resized since the last call
+   *
+   * Called by update. Should be called with the mutex locked, before planning with this costmap.
+   */
+  void refresh();
+
   // Get Costmap Pointer for Backwards Compatibility
   costmap_2d::Costmap2DROS* getCostmap2DROS() const { return costmap_ros_; }
 
@@ -78,6 +89,10 @@ protected:
   costmap_2d::Costmap2DROS* costmap_ros_;
   costmap_2d::Costmap2D* costmap_;
   bool needs_destruction_;
+
+  // Fed by the changes made through this class, and by a layer added to the Costmap2DROS that records the
+  // bounds of each costmap_2d update
+  std::shared_ptr<nav_core2::ChangeTracker> changes_;
 };
 
 }  // namespace nav_core_adapter
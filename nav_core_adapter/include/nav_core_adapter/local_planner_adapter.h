@@ -40,6 +40,7 @@
 #include <nav_core_adapter/costmap_adapter.h>
 #include <nav_2d_utils/odom_subscriber.h>
 #include <pluginlib/class_loader.h>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -77,6 +78,9 @@ protected:
   nav_2d_msgs::Pose2DStamped last_goal_;
   bool has_active_goal_;
 
+  // Hash of the most recent plan passed to the planner, so unchanged plans can be skipped
+  uint64_t last_plan_hash_;
+
   /**
    * @brief helper class for subscribing to odometry
    */
@@ -34,7 +34,11 @@
 
 #include <nav_core_adapter/costmap_adapter.h>
 #include <nav_core2/exceptions.h>
+#include <costmap_2d/layer.h>
+#include <costmap_2d/layered_costmap.h>
 #include <pluginlib/class_list_macros.h>
+#include <boost/make_shared.hpp>
+#include <memory>
 #include <string>
 
 PLUGINLIB_EXPORT_CLASS(nav_core_adapter::CostmapAdapter, nav_core2::Costmap)
@@ -55,6 +59,55 @@ nav_grid::NavGridInfo infoFromCostmap(costmap_2d::Costmap2DROS* costmap_ros)
   return info;
 }
 
+/**
+ * @class ChangeTrackingLayer
+ * @brief costmap_2d Layer that records which cells of the master grid each update changes
+ *
+ * It is added last, so it sees the final bounds of each update. It runs in costmap_2d's update thread,
+ * with the costmap's mutex locked.
+ */
+class ChangeTrackingLayer : public costmap_2d::Layer
+{
+public:
+  explicit ChangeTrackingLayer(std::shared_ptr<nav_core2::ChangeTracker> changes) : changes_(changes) {}
+
+  void updateBounds(double robot_x, double robot_y, double robot_yaw,
+                    double* min_x, double* min_y, double* max_x, double* max_y) override
+  {
+    // Rolling windows move the origin before updating the bounds, which shifts every cell
+    costmap_2d::Costmap2D* master = layered_costmap_->getCostmap();
+    if (master->getOriginX() != origin_x_ || master->getOriginY() != origin_y_)
+    {
+      origin_x_ = master->getOriginX();
+      origin_y_ = master->getOriginY();
+      changes_->touchAll(master->getSizeInCellsX(), master->getSizeInCellsY());
+    }
+  }
+
+  void updateCosts(costmap_2d::Costmap2D& master_grid, int min_i, int min_j, int max_i, int max_j) override
+  {
+    // The max values are exclusive
+    if (max_i <= min_i || max_j <= min_j) return;
+    changes_->update(min_i, min_j, max_i - 1, max_j - 1);
+  }
+
+  void matchSize() override
+  {
+    costmap_2d::Costmap2D* master = layered_costmap_->getCostmap();
+    changes_->touchAll(master->getSizeInCellsX(), master->getSizeInCellsY());
+  }
+
+protected:
+  void onInitialize() override
+  {
+    current_ = true;
+    enabled_ = true;
+  }
+
+  std::shared_ptr<nav_core2::ChangeTracker> changes_;
+  double origin_x_ { 0.0 }, origin_y_ { 0.0 };
+};
+
 CostmapAdapter::~CostmapAdapter()
 {
   if (needs_destruction_)
@@ -67,8 +120,15 @@ void CostmapAdapter::initialize(costmap_2d::Costmap2DROS* costmap_ros, bool need
 {
   costmap_ros_ = costmap_ros;
   needs_destruction_ = needs_destruction;
-  info_ = infoFromCostmap(costmap_ros_);
   costmap_ = costmap_ros_->getCostmap();
+  refresh();
+
+  changes_ = std::make_shared<nav_core2::ChangeTracker>();
+  boost::shared_ptr<ChangeTrackingLayer> layer = boost::make_shared<ChangeTrackingLayer>(changes_);
+  costmap_2d::LayeredCostmap* layered_costmap = costmap_ros_->getLayeredCostmap();
+  boost::unique_lock<mutex_t> lock(*getMutex());
+  layered_costmap->addPlugin(layer);
+  layer->initialize(layered_costmap, "change_tracking", nullptr);
 }
 
 void CostmapAdapter::initialize(const ros::NodeHandle& parent, const std::string& name, TFListenerPtr tf)
@@ -81,14 +141,28 @@ nav_core2::Costmap::mutex_t* CostmapAdapter::getMutex()
   return costmap_->getMutex();
 }
 
+nav_core2::UIntBounds CostmapAdapter::getChangeBounds(const std::string& ns)
+{
+  boost::unique_lock<mutex_t> lock(*getMutex());
+  return changes_->getChangeBounds(ns, costmap_->getSizeInCellsX(), costmap_->getSizeInCellsY());
+}
+
 void CostmapAdapter::reset()
 {
   costmap_->resetMap(0, 0, costmap_->getSizeInCellsX(), costmap_->getSizeInCellsY());
+  changes_->touchAll(costmap_->getSizeInCellsX(), costmap_->getSizeInCellsY());
 }
 
-void CostmapAdapter::update()
+void CostmapAdapter::refresh()
 {
   info_ = infoFromCostmap(costmap_ros_);
+  // The char map is reallocated when costmap_2d resizes the map
+  char_map_ = costmap_->getCharMap();
+}
+
+void CostmapAdapter::update()
+{
+  refresh();
   if (!costmap_ros_->isCurrent())
     throw nav_core2::CostmapDataLagException("Costmap2DROS is out of date somehow.");
 }
@@ -96,6 +170,7 @@ void CostmapAdapter::update()
 void CostmapAdapter::setValue(const unsigned int x, const unsigned int y, const unsigned char& value)
 {
   costmap_->setCost(x, y, value);
+  changes_->touch(x, y);
 }
 
 unsigned char CostmapAdapter::getValue(const unsigned int x, const unsigned int y) const
@@ -112,6 +187,7 @@ void CostmapAdapter::setInfo(const nav_grid::NavGridInfo& new_info)
 void CostmapAdapter::updateInfo(const nav_grid::NavGridInfo& new_info)
 {
   costmap_->updateOrigin(new_info.origin_x, new_info.origin_y);
+  changes_->touchAll(costmap_->getSizeInCellsX(), costmap_->getSizeInCellsY());
 }
 
 }  // namespace nav_core_adapter
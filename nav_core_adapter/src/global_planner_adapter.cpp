@@ -76,10 +76,25 @@ bool GlobalPlannerAdapter::makePlan(const geometry_msgs::PoseStamped& start,
                              goal2d = nav_2d_utils::poseStampedToPose2D(goal);
   try
   {
+    // move_base holds the costmap's lock while planning
+    costmap_adapter_->refresh();
     nav_2d_msgs::Path2D path2d = planner_->makePlan(start2d, goal2d);
-    nav_msgs::Path path = nav_2d_utils::pathToPath(path2d);
-    plan = path.poses;
-    path_pub_.publish(path);
+
+    // Convert straight into the output instead of into a nav_msgs::Path that would then be copied
+    plan.resize(path2d.poses.size());
+    for (unsigned int i = 0; i < plan.size(); i++)
+    {
+      plan[i].header = path2d.header;
+      plan[i].pose = nav_2d_utils::pose2DToPose(path2d.poses[i]);
+    }
+
+    if (path_pub_.getNumSubscribers() > 0)
+    {
+      nav_msgs::Path path;
+      path.header = path2d.header;
+      path.poses = plan;
+      path_pub_.publish(path);
+    }
     return true;
   }
   catch (nav_core2::PlannerException& e)
@@ -44,9 +44,41 @@
 
 namespace nav_core_adapter
 {
+namespace
+{
+/**
+ * @brief FNV-1a hash of the frame and poses of a plan (ignoring the time stamps)
+ */
+uint64_t hashPlan(const std::vector<geometry_msgs::PoseStamped>& plan)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](const void* data, size_t size)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+      hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+  };
+
+  if (!plan.empty())
+  {
+    const std::string& frame_id = plan[0].header.frame_id;
+    add(frame_id.data(), frame_id.size());
+  }
+  for (const geometry_msgs::PoseStamped& pose : plan)
+  {
+    const double values[] = {pose.pose.position.x, pose.pose.position.y, pose.pose.position.z,
+                             pose.pose.orientation.x, pose.pose.orientation.y, pose.pose.orientation.z,
+                             pose.pose.orientation.w};
+    add(values, sizeof(values));
+  }
+  return hash;
+}
+}  // namespace
 
 LocalPlannerAdapter::LocalPlannerAdapter() :
-  planner_loader_("nav_core2", "nav_core2::LocalPlanner")
+  has_active_goal_(false), last_plan_hash_(0), planner_loader_("nav_core2", "nav_core2::LocalPlanner")
 {
 }
 
@@ -96,6 +128,8 @@ bool LocalPlannerAdapter::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
   nav_2d_msgs::Twist2DStamped cmd_vel_2d;
   try
   {
+    // move_base holds the costmap's lock while computing the command
+    costmap_adapter_->refresh();
     cmd_vel_2d = planner_->computeVelocityCommands(pose2d, velocity);
   }
   catch (const nav_core2::PlannerException& e)
@@ -131,6 +165,14 @@ bool LocalPlannerAdapter::isGoalReached()
  */
 bool LocalPlannerAdapter::setPlan(const std::vector<geometry_msgs::PoseStamped>& orig_global_plan)
 {
+  // move_base passes in the plan every planning cycle, even if it has not changed. Skip the conversion and the
+  // planner's setPlan in that case, so the planner keeps its progress along the plan.
+  uint64_t plan_hash = hashPlan(orig_global_plan);
+  if (has_active_goal_ && plan_hash == last_plan_hash_)
+  {
+    return true;
+  }
+
   nav_2d_msgs::Path2D path = nav_2d_utils::posesToPath2D(orig_global_plan);
   try
   {
@@ -149,6 +191,7 @@ bool LocalPlannerAdapter::setPlan(const std::vector<geometry_msgs::PoseStamped>&
     }
 
     planner_->setPlan(path);
+    last_plan_hash_ = plan_hash;
     return true;
   }
   catch (const nav_core2::PlannerException& e)
@@ -0,0 +1,140 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <nav_core_adapter/local_planner_adapter.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Local planner that only counts the calls to setGoalPose and setPlan
+ */
+class CountingPlanner : public nav_core2::LocalPlanner
+{
+public:
+  void initialize(const ros::NodeHandle& parent, const std::string& name,
+                  TFListenerPtr tf, nav_core2::Costmap::Ptr costmap) override {}
+  void setGoalPose(const nav_2d_msgs::Pose2DStamped& goal_pose) override { num_goals_++; }
+  void setPlan(const nav_2d_msgs::Path2D& path) override { num_plans_++; }
+  nav_2d_msgs::Twist2DStamped computeVelocityCommands(const nav_2d_msgs::Pose2DStamped& pose,
+                                                      const nav_2d_msgs::Twist2D& velocity) override
+  {
+    return nav_2d_msgs::Twist2DStamped();
+  }
+  bool isGoalReached(const nav_2d_msgs::Pose2DStamped& pose, const nav_2d_msgs::Twist2D& velocity) override
+  {
+    return false;
+  }
+
+  int num_goals_ = 0;
+  int num_plans_ = 0;
+};
+
+/**
+ * @brief Adapter that wraps a CountingPlanner instead of loading a plugin
+ */
+class TestAdapter : public nav_core_adapter::LocalPlannerAdapter
+{
+public:
+  TestAdapter()
+  {
+    counter_ = boost::make_shared<CountingPlanner>();
+    planner_ = counter_;
+  }
+
+  boost::shared_ptr<CountingPlanner> counter_;
+};
+
+std::vector<geometry_msgs::PoseStamped> makePlan(double goal_x)
+{
+  std::vector<geometry_msgs::PoseStamped> plan(3);
+  for (unsigned int i = 0; i < plan.size(); i++)
+  {
+    plan[i].header.frame_id = "map";
+    plan[i].pose.position.x = goal_x * i / (plan.size() - 1);
+    plan[i].pose.orientation.w = 1.0;
+  }
+  return plan;
+}
+
+TEST(LocalPlannerAdapter, unchanged_plan_skipped)
+{
+  TestAdapter adapter;
+  std::vector<geometry_msgs::PoseStamped> plan = makePlan(1.0);
+  EXPECT_TRUE(adapter.setPlan(plan));
+  EXPECT_EQ(1, adapter.counter_->num_plans_);
+  EXPECT_EQ(1, adapter.counter_->num_goals_);
+
+  // Same poses with a new time stamp
+  for (geometry_msgs::PoseStamped& pose : plan)
+  {
+    pose.header.stamp = ros::Time(5.0);
+  }
+  EXPECT_TRUE(adapter.setPlan(plan));
+  EXPECT_TRUE(adapter.setPlan(plan));
+  EXPECT_EQ(1, adapter.counter_->num_plans_);
+  EXPECT_EQ(1, adapter.counter_->num_goals_);
+}
+
+TEST(LocalPlannerAdapter, changed_plan_passed_on)
+{
+  TestAdapter adapter;
+  std::vector<geometry_msgs::PoseStamped> plan = makePlan(1.0);
+  EXPECT_TRUE(adapter.setPlan(plan));
+
+  // Same goal, different intermediate pose
+  plan[1].pose.position.y = 0.1;
+  EXPECT_TRUE(adapter.setPlan(plan));
+  EXPECT_EQ(2, adapter.counter_->num_plans_);
+  EXPECT_EQ(1, adapter.counter_->num_goals_);
+
+  // New goal
+  EXPECT_TRUE(adapter.setPlan(makePlan(2.0)));
+  EXPECT_EQ(3, adapter.counter_->num_plans_);
+  EXPECT_EQ(2, adapter.counter_->num_goals_);
+
+  // Different frame
+  plan = makePlan(2.0);
+  for (geometry_msgs::PoseStamped& pose : plan)
+  {
+    pose.header.frame_id = "odom";
+  }
+  EXPECT_TRUE(adapter.setPlan(plan));
+  EXPECT_EQ(4, adapter.counter_->num_plans_);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
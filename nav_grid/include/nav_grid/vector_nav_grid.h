@@ -188,6 +188,11 @@ public:
   T  operator[] (unsigned int i) const    {return data_[i];}
   T& operator[] (unsigned int i) {return data_[i];}
 
+  /**
+   * @brief Direct access to the underlying data, in row-major order
+   */
+  const T* data() const { return data_.data(); }
+
   /**
    * @brief Return the size of the vector. Equivalent to width * height.
    * @return size of the vector
@@ -0,0 +1,208 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAV_GRID_PUB_SUB_DISJOINT_BOUNDS_H
+#define NAV_GRID_PUB_SUB_DISJOINT_BOUNDS_H
+
+#include <nav_core2/bounds.h>
+#include <stdint.h>
+#include <limits>
+#include <vector>
+
+namespace nav_grid_pub_sub
+{
+/**
+ * @class DisjointBounds
+ * @brief A collection of non-overlapping UIntBounds that covers every cell that has been added to it.
+ *
+ * Merging all of the changed bounds into a single UIntBounds means that two small changes in opposite corners
+ * of the grid result in an update covering nearly the whole grid. This class instead keeps up to max_regions
+ * separate rectangles. A new rectangle is merged into an existing one if they overlap or if the merged rectangle
+ * is not much larger (i.e. merge_overhead cells) than the two separate rectangles. If there are more than
+ * max_regions rectangles, the pair whose merge adds the fewest cells is merged.
+ *
+ * With max_regions = 1, this is equivalent to merging everything into a single UIntBounds.
+ */
+class DisjointBounds
+{
+public:
+  /**
+   * @brief Constructor
+   * @param max_regions Maximum number of separate rectangles to track (minimum 1)
+   * @param merge_overhead Number of extra cells we are willing to include to avoid an additional rectangle
+   */
+  explicit DisjointBounds(unsigned int max_regions = 1, unsigned int merge_overhead = 64)
+    : max_regions_(max_regions < 1 ? 1 : max_regions), merge_overhead_(merge_overhead) {}
+
+  /**
+   * @brief Change the maximum number of rectangles. Existing rectangles are merged if needed.
+   */
+  void setMaxRegions(unsigned int max_regions)
+  {
+    max_regions_ = max_regions < 1 ? 1 : max_regions;
+    reduceRegions();
+  }
+
+  unsigned int getMaxRegions() const { return max_regions_; }
+
+  /**
+   * @brief Include the cells in the given bounds
+   */
+  void add(const nav_core2::UIntBounds& bounds)
+  {
+    if (bounds.isEmpty()) return;
+    addRegion(bounds);
+    reduceRegions();
+  }
+
+  /**
+   * @brief Include all the cells from another DisjointBounds
+   */
+  void add(const DisjointBounds& other)
+  {
+    for (const nav_core2::UIntBounds& region : other.regions_)
+    {
+      add(region);
+    }
+  }
+
+  void reset() { regions_.clear(); }
+  bool isEmpty() const { return regions_.empty(); }
+
+  /**
+   * @brief Get the non-overlapping rectangles
+   */
+  const std::vector<nav_core2::UIntBounds>& getRegions() const { return regions_; }
+
+  /**
+   * @brief Get a single bounds that covers all the rectangles
+   */
+  nav_core2::UIntBounds getTotalBounds() const
+  {
+    nav_core2::UIntBounds total;
+    for (const nav_core2::UIntBounds& region : regions_)
+    {
+      total.merge(region);
+    }
+    return total;
+  }
+
+  /**
+   * @brief Get the number of cells within the rectangles
+   */
+  uint64_t getArea() const
+  {
+    uint64_t area = 0;
+    for (const nav_core2::UIntBounds& region : regions_)
+    {
+      area += getArea(region);
+    }
+    return area;
+  }
+
+protected:
+  static uint64_t getArea(const nav_core2::UIntBounds& bounds)
+  {
+    return static_cast<uint64_t>(bounds.getWidth()) * bounds.getHeight();
+  }
+
+  static nav_core2::UIntBounds getUnion(const nav_core2::UIntBounds& a, const nav_core2::UIntBounds& b)
+  {
+    nav_core2::UIntBounds merged = a;
+    merged.merge(b);
+    return merged;
+  }
+
+  /**
+   * @brief Add a rectangle, absorbing any existing rectangles that overlap or are cheap to combine with it
+   */
+  void addRegion(nav_core2::UIntBounds bounds)
+  {
+    bool absorbed = true;
+    while (absorbed)
+    {
+      absorbed = false;
+      for (unsigned int i = 0; i < regions_.size(); i++)
+      {
+        const nav_core2::UIntBounds& region = regions_[i];
+        if (bounds.overlaps(region) ||
+            getArea(getUnion(bounds, region)) <= getArea(bounds) + getArea(region) + merge_overhead_)
+        {
+          bounds.merge(region);
+          regions_.erase(regions_.begin() + i);
+          absorbed = true;
+          break;
+        }
+      }
+    }
+    regions_.push_back(bounds);
+  }
+
+  /**
+   * @brief While there are too many rectangles, merge the pair that adds the fewest extra cells
+   */
+  void reduceRegions()
+  {
+    while (regions_.size() > max_regions_)
+    {
+      unsigned int best_i = 0, best_j = 1;
+      uint64_t best_cost = std::numeric_limits<uint64_t>::max();
+      for (unsigned int i = 0; i < regions_.size(); i++)
+      {
+        for (unsigned int j = i + 1; j < regions_.size(); j++)
+        {
+          uint64_t cost = getArea(getUnion(regions_[i], regions_[j]))
+                        - getArea(regions_[i]) - getArea(regions_[j]);
+          if (cost < best_cost)
+          {
+            best_cost = cost;
+            best_i = i;
+            best_j = j;
+          }
+        }
+      }
+      nav_core2::UIntBounds merged = getUnion(regions_[best_i], regions_[best_j]);
+      regions_.erase(regions_.begin() + best_j);
+      regions_.erase(regions_.begin() + best_i);
+      addRegion(merged);
+    }
+  }
+
+  std::vector<nav_core2::UIntBounds> regions_;
+  unsigned int max_regions_;
+  unsigned int merge_overhead_;
+};
+}  // namespace nav_grid_pub_sub
+
+#endif  // NAV_GRID_PUB_SUB_DISJOINT_BOUNDS_H
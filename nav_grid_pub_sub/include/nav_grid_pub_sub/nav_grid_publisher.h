@@ -39,13 +39,23 @@
 #include <nav_grid_pub_sub/occ_grid_message_utils.h>
 #include <nav_grid_pub_sub/cost_interpretation.h>
 #include <nav_grid_pub_sub/cost_interpretation_tables.h>
+#include <nav_grid_pub_sub/disjoint_bounds.h>
+#include <nav_grid_pub_sub/shared_nav_grid.h>
+#include <nav_2d_msgs/NavGridSharedUpdate.h>
 #include <ros/ros.h>
 #include <nav_grid/nav_grid.h>
+#include <nav_grid/vector_nav_grid.h>
 #include <nav_grid/coordinate_conversion.h>
 #include <nav_core2/bounds.h>
+#include <nav_core2/costmap.h>
 #include <geometry_msgs/PolygonStamped.h>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <deque>
 #include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace nav_grid_pub_sub
@@ -101,6 +111,29 @@ inline geometry_msgs::Point32 makePoint(const nav_grid::NavGridInfo& info, int x
  * You can control how often updates are published with similar logic and the update_publish_cycle argument. If the
  * update_publish_cycle is positive, the Bounds from successive calls will be merged so the resulting update will
  * cover the superset of all the bounds.
+ *
+ * By default, all the changed bounds are merged into a single update. If setMaxUpdateRegions is called with a value
+ * greater than one, changes that are far apart are kept in separate (non-overlapping) rectangles, and one update
+ * message is published for each, so that small changes in distant parts of the grid don't result in an update
+ * covering most of the grid. The update_area polygon still covers all of the rectangles.
+ *
+ * Downsampled Publishing: addDownsampledOutput creates an additional set of topics (the same topic names as in init,
+ * with "_Nx" appended, e.g. costmap_4x) on which a copy of the grid with N times coarser resolution is published.
+ * Each cell of the downsampled grid is the maximum of the corresponding NxN known cells (see poolValues). The
+ * downsampled grids are kept up to date incrementally using the bounds passed to publish, and each has its own
+ * full_publish_cycle/update_publish_cycle so that they can be published at a lower rate.
+ *
+ * Asynchronous Publishing: By default, the messages are converted and published on the thread that calls publish.
+ * If setAsynchronous(true) is called, the publish methods only copy the portion of the grid that needs to be
+ * published (the whole grid, or just the update bounds) and hand it off to a background thread, which converts
+ * and publishes the messages. If the background thread falls behind, pending updates are merged and a pending
+ * full grid supersedes everything queued before it. Derived classes that override the conversion methods must
+ * call stopAsyncThread() in their destructors.
+ *
+ * Shared Memory: initSharedMemory makes every call to publish also copy the changed portion of the grid into a
+ * SharedNavGrid, regardless of the publish cycles or number of subscribers, and publish a small NavGridSharedUpdate
+ * message describing what changed. Processes on the same machine can then read the grid directly from shared memory
+ * (see SharedNavGridSubscriber) instead of receiving the data in messages.
  */
 template<typename NumericType, typename NavGridOfX, typename NavGridOfXUpdate>
 class GenericGridPublisher
@@ -108,6 +141,11 @@ class GenericGridPublisher
 public:
   explicit GenericGridPublisher(nav_grid::NavGrid<NumericType>& data) : data_(data) {}
 
+  virtual ~GenericGridPublisher()
+  {
+    stopAsyncThread();
+  }
+
   /**
    * @brief Initialize method for determining what gets published when
    * @param nh NodeHandle used for creating publishers
@@ -134,6 +172,8 @@ public:
   {
     full_publish_cycle_ = full_publish_cycle;
     update_publish_cycle_ = update_publish_cycle;
+    nav_grid_topic_ = nav_grid_topic;
+    occupancy_grid_topic_ = occupancy_grid_topic;
     last_full_publish_ = ros::Time(0);
     last_update_publish_ = ros::Time(0);
     publish_updates_ = publish_updates;
@@ -152,16 +192,95 @@ public:
     }
   }
 
+  /**
+   * @brief Publish an additional copy of the grid, downsampled by the given factor. Must be called after init.
+   * @param nh NodeHandle used for creating publishers
+   * @param factor Number of cells in each direction that are combined into a single cell
+   * @param full_publish_cycle If positive, limits how often the full grid is published. If negative, never publishes.
+   * @param update_publish_cycle If positive, limits how often the update is published. If negative, never publishes.
+   */
+  void addDownsampledOutput(ros::NodeHandle& nh, unsigned int factor,
+                            ros::Duration full_publish_cycle = ros::Duration(0),
+                            ros::Duration update_publish_cycle = ros::Duration(0))
+  {
+    DownsampledOutput output;
+    output.factor = std::max(factor, 1u);
+    output.grid = std::make_shared<nav_grid::VectorNavGrid<NumericType>>();
+    output.publisher = createDownsampledPublisher(*output.grid);
+    if (!output.publisher)
+    {
+      ROS_ERROR_NAMED("GenericGridPublisher", "This grid publisher does not support downsampled outputs.");
+      return;
+    }
+    output.dirty.setMaxRegions(update_bounds_.getMaxRegions());
+
+    std::string suffix = "_" + std::to_string(output.factor) + "x";
+    output.publisher->init(nh, nav_grid_topic_.empty() ? "" : nav_grid_topic_ + suffix,
+                           occupancy_grid_topic_.empty() ? "" : occupancy_grid_topic_ + suffix, "",
+                           publish_updates_, full_publish_cycle, update_publish_cycle);
+    output.publisher->setMaxUpdateRegions(update_bounds_.getMaxRegions());
+    output.publisher->setAsynchronous(async_);
+    downsampled_outputs_.push_back(output);
+  }
+
+  /**
+   * @brief Switch between publishing on the calling thread (false) and publishing on a background thread (true)
+   */
+  void setAsynchronous(bool async)
+  {
+    for (DownsampledOutput& output : downsampled_outputs_)
+    {
+      output.publisher->setAsynchronous(async);
+    }
+    if (async == async_) return;
+    if (async)
+    {
+      // Force the next update to include the full grid, so the background thread gets its own copy
+      saved_info_ = nav_grid::NavGridInfo();
+      async_ = true;
+      async_thread_ = boost::thread(&GenericGridPublisher::asyncPublishLoop, this);
+    }
+    else
+    {
+      stopAsyncThread();
+    }
+  }
+
+  /**
+   * @brief Set the maximum number of separate update messages that may be published for a single call to publish
+   */
+  void setMaxUpdateRegions(unsigned int max_regions)
+  {
+    update_bounds_.setMaxRegions(max_regions);
+    for (DownsampledOutput& output : downsampled_outputs_)
+    {
+      output.dirty.setMaxRegions(max_regions);
+      output.publisher->setMaxUpdateRegions(max_regions);
+    }
+  }
+
+  /**
+   * @brief Mirror the grid into the named shared memory segment and publish notifications of the changes
+   * @param nh NodeHandle used for creating the publisher
+   * @param segment_name Name of the shared memory segment
+   * @param topic Topic to publish the NavGridSharedUpdate on
+   */
+  void initSharedMemory(ros::NodeHandle& nh, const std::string& segment_name,
+                        const std::string& topic = "shared_grid_update")
+  {
+    shared_grid_ = std::make_shared<SharedNavGrid<NumericType>>();
+    shared_grid_->create(segment_name);
+    // Latched so that new subscribers can find the segment
+    shared_update_pub_ = nh.advertise<nav_2d_msgs::NavGridSharedUpdate>(topic, 10, true);
+  }
+
   /**
    * @brief Publish the full grid if the full_publish_cycle allows
    */
   void publish()
   {
-    if (!shouldPublishFull()) return;
-    last_full_publish_ = ros::Time::now();
-    synced_time_stamp_ = last_full_publish_;
-    publishNav();
-    publishOcc();
+    writeSharedMemory(nav_core2::UIntBounds(), true);
+    publishFull();
   }
 
   /**
@@ -173,14 +292,16 @@ public:
    */
   void publish(const nav_core2::UIntBounds& bounds)
   {
+    writeSharedMemory(bounds, false);
     if (!publish_updates_)
     {
       // Don't publish an update, publish the full grid if enough time has passed
-      publish();
+      publishFull();
       return;
     }
 
-    update_bounds_.merge(bounds);
+    publishDownsampled(bounds, false);
+    update_bounds_.add(bounds);
 
     if (!shouldPublishUpdate()) return;
 
@@ -188,28 +309,378 @@ public:
     last_update_publish_ = ros::Time::now();
     synced_time_stamp_ = last_update_publish_;
 
+    if (async_)
+    {
+      AsyncJob job;
+      job.update_area = true;
+      job.update_bounds = update_bounds_;
+      if (saved_info_ != info)
+      {
+        // The background thread's copy of the grid needs the new info, even if no one is listening yet
+        saved_info_ = info;
+        job.full = true;
+      }
+      enqueueAsyncJob(job);
+      update_bounds_.reset();
+      return;
+    }
+
     if (saved_info_ != info)
     {
       // If the info has changed, force publish the whole grid
       saved_info_ = info;
-      publishNav();
-      publishOcc();
+      publishNav(data_, synced_time_stamp_);
+      publishOcc(data_, synced_time_stamp_);
     }
-    else if (!update_bounds_.isEmpty())
+    else
     {
       // If actual data was updated, publish the updates
-      publishNavUpdate(update_bounds_);
-      publishOccUpdate(update_bounds_);
+      for (const nav_core2::UIntBounds& region : update_bounds_.getRegions())
+      {
+        publishNavUpdate(data_, region, synced_time_stamp_);
+        publishOccUpdate(data_, region, synced_time_stamp_);
+      }
     }
 
     // Publish the update area (or an empty polygon message if there was no update)
-    publishUpdateArea(info, update_bounds_);
+    publishUpdateArea(info, update_bounds_.getTotalBounds(), synced_time_stamp_);
 
     update_bounds_.reset();
   }
 
-
 protected:
+  /**
+   * @brief Publish the full grid messages if the full_publish_cycle allows
+   */
+  void publishFull()
+  {
+    publishDownsampled(nav_core2::UIntBounds(), true);
+    if (!shouldPublishFull()) return;
+    last_full_publish_ = ros::Time::now();
+    synced_time_stamp_ = last_full_publish_;
+    if (async_)
+    {
+      if (nav_pub_.getNumSubscribers() == 0 && occ_pub_.getNumSubscribers() == 0)
+      {
+        // Skip the copy, but the background thread's grid is now out of date, so the next update includes everything
+        saved_info_ = nav_grid::NavGridInfo();
+        return;
+      }
+      AsyncJob job;
+      job.full = true;
+      enqueueAsyncJob(job);
+      saved_info_ = data_.getInfo();
+      return;
+    }
+    publishNav(data_, synced_time_stamp_);
+    publishOcc(data_, synced_time_stamp_);
+  }
+
+  /**
+   * @brief Copy the changed portion of the grid into shared memory and publish the notification
+   * @param bounds The portion of the grid that changed
+   * @param full If true, the entire grid may have changed
+   */
+  void writeSharedMemory(const nav_core2::UIntBounds& bounds, bool full)
+  {
+    if (!shared_grid_) return;
+    const nav_grid::NavGridInfo info = data_.getInfo();
+    nav_core2::UIntBounds changed = bounds;
+    shared_grid_->beginWrite();
+    if (shared_grid_->getInfo() != info)
+    {
+      shared_grid_->setInfo(info);
+      full = true;
+    }
+    if (full)
+    {
+      changed = nav_core2::UIntBounds();
+      if (info.width > 0 && info.height > 0)
+      {
+        changed = nav_core2::UIntBounds(0, 0, info.width - 1, info.height - 1);
+      }
+    }
+    if (!changed.isEmpty())
+    {
+      for (const nav_grid::Index& index : nav_grid_iterators::SubGrid(&info, changed))
+      {
+        shared_grid_->setValue(index, data_(index));
+      }
+    }
+    shared_grid_->endWrite();
+
+    if (!full && changed.isEmpty()) return;
+    nav_2d_msgs::NavGridSharedUpdate msg;
+    msg.stamp = ros::Time::now();
+    msg.segment = shared_grid_->getSegmentName();
+    msg.info = nav_2d_utils::toMsg(info);
+    msg.bounds = nav_2d_utils::toMsg(changed);
+    shared_update_pub_.publish(msg);
+  }
+
+  /**
+   * @brief A downsampled copy of the grid, along with its publisher and the portion of it that needs recalculating
+   */
+  struct DownsampledOutput
+  {
+    unsigned int factor;
+    std::shared_ptr<nav_grid::VectorNavGrid<NumericType>> grid;
+    std::shared_ptr<GenericGridPublisher> publisher;
+    DisjointBounds dirty;
+  };
+
+  /**
+   * @brief Create a publisher of the same type as this one (with the same conversion settings) for the given grid
+   *
+   * Used for downsampled outputs. Returns nullptr if not supported.
+   */
+  virtual std::shared_ptr<GenericGridPublisher> createDownsampledPublisher(nav_grid::NavGrid<NumericType>& grid)
+  {
+    return nullptr;
+  }
+
+  /**
+   * @brief Combine two values when downsampling. Uses the maximum by default.
+   */
+  virtual NumericType poolValues(const NumericType a, const NumericType b) const
+  {
+    return std::max(a, b);
+  }
+
+  /**
+   * @brief Update each of the downsampled grids and publish them if their publish cycles allow
+   * @param bounds The portion of the full resolution grid that changed
+   * @param full If true, the entire grid may have changed, and the full grids should be published
+   */
+  void publishDownsampled(const nav_core2::UIntBounds& bounds, bool full)
+  {
+    const nav_grid::NavGridInfo& info = data_.getInfo();
+    for (DownsampledOutput& output : downsampled_outputs_)
+    {
+      GenericGridPublisher& publisher = *output.publisher;
+      nav_grid::NavGridInfo coarse_info = info;
+      coarse_info.width = (info.width + output.factor - 1) / output.factor;
+      coarse_info.height = (info.height + output.factor - 1) / output.factor;
+      coarse_info.resolution = info.resolution * output.factor;
+      if (coarse_info.width == 0 || coarse_info.height == 0) continue;
+
+      if (full || output.grid->getInfo() != coarse_info)
+      {
+        output.grid->setInfo(coarse_info);
+        output.dirty.reset();
+        output.dirty.add(nav_core2::UIntBounds(0, 0, coarse_info.width - 1, coarse_info.height - 1));
+      }
+      else if (!bounds.isEmpty())
+      {
+        output.dirty.add(nav_core2::UIntBounds(bounds.getMinX() / output.factor, bounds.getMinY() / output.factor,
+                                               bounds.getMaxX() / output.factor, bounds.getMaxY() / output.factor));
+      }
+
+      // Only do the downsampling when the results are going to be published
+      if (full || !publisher.publish_updates_)
+      {
+        if (!publisher.shouldPublishFull()) continue;
+      }
+      else if (!publisher.shouldPublishUpdate())
+      {
+        continue;
+      }
+
+      for (const nav_core2::UIntBounds& region : output.dirty.getRegions())
+      {
+        downsample(output, region);
+        if (!full)
+        {
+          publisher.update_bounds_.add(region);
+        }
+      }
+      output.dirty.reset();
+
+      if (full)
+      {
+        publisher.publish();
+      }
+      else
+      {
+        publisher.publish(nav_core2::UIntBounds());
+      }
+    }
+  }
+
+  /**
+   * @brief Recalculate the given region of the downsampled grid from the full resolution grid
+   */
+  void downsample(DownsampledOutput& output, const nav_core2::UIntBounds& region)
+  {
+    const nav_grid::NavGridInfo& info = data_.getInfo();
+    const nav_grid::NavGridInfo coarse_info = output.grid->getInfo();
+    const unsigned int factor = output.factor;
+    for (const nav_grid::Index& coarse_index : nav_grid_iterators::SubGrid(&coarse_info, region))
+    {
+      unsigned int min_x = coarse_index.x * factor, min_y = coarse_index.y * factor;
+      unsigned int max_x = std::min(min_x + factor, info.width), max_y = std::min(min_y + factor, info.height);
+      NumericType value = data_(min_x, min_y);
+      for (unsigned int y = min_y; y < max_y; y++)
+      {
+        for (unsigned int x = min_x; x < max_x; x++)
+        {
+          value = poolValues(value, data_(x, y));
+        }
+      }
+      output.grid->setValue(coarse_index, value);
+    }
+  }
+
+  /**
+   * @brief A snapshot of the data to be published by the background thread
+   *
+   * If full is true, grid contains a copy of the entire grid. Otherwise, if update_bounds is not empty,
+   * values contains a copy of the cells within each of the update_bounds' regions, each in row major order.
+   */
+  struct AsyncJob
+  {
+    bool full = false;
+    bool update_area = false;
+    nav_grid::NavGridInfo info;
+    DisjointBounds update_bounds;
+    nav_grid::VectorNavGrid<NumericType> grid;
+    std::vector<NumericType> values;
+    ros::Time stamp;
+  };
+
+  /**
+   * @brief Copy the needed data out of the grid (on the calling thread) and queue it for the background thread
+   */
+  void enqueueAsyncJob(AsyncJob& job)
+  {
+    job.stamp = synced_time_stamp_;
+    job.info = data_.getInfo();
+    if (job.full)
+    {
+      {
+        // Reuse the memory from a previously published snapshot
+        boost::mutex::scoped_lock lock(async_mutex_);
+        std::swap(job.grid, spare_grid_);
+      }
+      const nav_grid::NavGridInfo& info = data_.getInfo();
+      job.grid.setInfo(info);
+      for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(info))
+      {
+        job.grid.setValue(index, data_(index));
+      }
+    }
+    else
+    {
+      // Always copy the updated cells (even with no subscribers) so the background thread's copy never goes stale
+      const nav_grid::NavGridInfo& info = data_.getInfo();
+      job.values.reserve(job.update_bounds.getArea());
+      for (const nav_core2::UIntBounds& region : job.update_bounds.getRegions())
+      {
+        for (const nav_grid::Index& index : nav_grid_iterators::SubGrid(&info, region))
+        {
+          job.values.push_back(data_(index));
+        }
+      }
+    }
+
+    boost::mutex::scoped_lock lock(async_mutex_);
+    if (job.full)
+    {
+      // A full grid supersedes anything that has not been published yet
+      async_queue_.clear();
+    }
+    async_queue_.push_back(std::move(job));
+    async_condition_.notify_one();
+  }
+
+  /**
+   * @brief Main loop of the background thread. Converts and publishes whatever has been queued.
+   */
+  void asyncPublishLoop()
+  {
+    while (true)
+    {
+      std::deque<AsyncJob> jobs;
+      {
+        boost::mutex::scoped_lock lock(async_mutex_);
+        while (async_ && async_queue_.empty())
+        {
+          async_condition_.wait(lock);
+        }
+        if (!async_) return;
+        jobs.swap(async_queue_);
+      }
+
+      // Apply all the pending jobs to our copy of the grid, and merge what needs to be published
+      bool publish_full = false, publish_area = false;
+      DisjointBounds bounds(jobs.back().update_bounds.getMaxRegions());
+      nav_core2::UIntBounds area_bounds;
+      ros::Time stamp;
+      for (AsyncJob& job : jobs)
+      {
+        stamp = job.stamp;
+        publish_area |= job.update_area;
+        if (job.full)
+        {
+          publish_full = true;
+          std::swap(async_grid_, job.grid);
+          boost::mutex::scoped_lock lock(async_mutex_);
+          std::swap(spare_grid_, job.grid);
+        }
+        else if (!job.values.empty() && async_grid_.getInfo() == job.info)
+        {
+          const nav_grid::NavGridInfo& info = async_grid_.getInfo();
+          unsigned int data_index = 0;
+          for (const nav_core2::UIntBounds& region : job.update_bounds.getRegions())
+          {
+            for (const nav_grid::Index& index : nav_grid_iterators::SubGrid(&info, region))
+            {
+              async_grid_.setValue(index, job.values[data_index++]);
+            }
+          }
+          bounds.add(job.update_bounds);
+        }
+        if (job.update_area)
+        {
+          area_bounds.merge(job.update_bounds.getTotalBounds());
+        }
+      }
+
+      if (publish_full)
+      {
+        publishNav(async_grid_, stamp);
+        publishOcc(async_grid_, stamp);
+      }
+      else
+      {
+        for (const nav_core2::UIntBounds& region : bounds.getRegions())
+        {
+          publishNavUpdate(async_grid_, region, stamp);
+          publishOccUpdate(async_grid_, region, stamp);
+        }
+      }
+      if (publish_area)
+      {
+        publishUpdateArea(async_grid_.getInfo(), area_bounds, stamp);
+      }
+    }
+  }
+
+  /**
+   * @brief Stop the background thread (if running) and return to synchronous publishing
+   */
+  void stopAsyncThread()
+  {
+    {
+      boost::mutex::scoped_lock lock(async_mutex_);
+      if (!async_) return;
+      async_ = false;
+      async_queue_.clear();
+      async_condition_.notify_one();
+    }
+    async_thread_.join();
+  }
+
   template<class FullGridType, class UpdateType, class Callback>
   void createPublishers(ros::NodeHandle& nh, const std::string& topic, Callback new_subscription_callback,
                         ros::Publisher& full_grid_pub, ros::Publisher& update_pub, bool publish_updates)
@@ -224,8 +695,10 @@ protected:
     }
   }
 
-  virtual nav_msgs::OccupancyGrid toOccupancyGrid(const ros::Time& timestamp) = 0;
-  virtual map_msgs::OccupancyGridUpdate toOccupancyGridUpdate(const nav_core2::UIntBounds& bounds,
+  virtual nav_msgs::OccupancyGrid toOccupancyGrid(const nav_grid::NavGrid<NumericType>& grid,
+                                                  const ros::Time& timestamp) = 0;
+  virtual map_msgs::OccupancyGridUpdate toOccupancyGridUpdate(const nav_grid::NavGrid<NumericType>& grid,
+                                                              const nav_core2::UIntBounds& bounds,
                                                               const ros::Time& timestamp) = 0;
 
   bool shouldPublishHelper(const ros::Time& last_publish, const ros::Duration& cycle) const
@@ -255,13 +728,14 @@ protected:
     return shouldPublishHelper(last_update_publish_, update_publish_cycle_);
   }
 
-  void publishUpdateArea(const nav_grid::NavGridInfo& info, const nav_core2::UIntBounds& bounds)
+  void publishUpdateArea(const nav_grid::NavGridInfo& info, const nav_core2::UIntBounds& bounds,
+                         const ros::Time& stamp)
   {
     if (update_area_pub_.getNumSubscribers() == 0) return;
 
     geometry_msgs::PolygonStamped polygon;
     polygon.header.frame_id = info.frame_id;
-    polygon.header.stamp = synced_time_stamp_;
+    polygon.header.stamp = stamp;
 
     if (!bounds.isEmpty())
     {
@@ -280,31 +754,33 @@ protected:
 
   void onNewSubscriptionOcc(const ros::SingleSubscriberPublisher& pub)
   {
-    pub.publish(toOccupancyGrid(ros::Time::now()));
+    pub.publish(toOccupancyGrid(data_, ros::Time::now()));
   }
 
-  void publishNav()
+  void publishNav(const nav_grid::NavGrid<NumericType>& grid, const ros::Time& stamp)
   {
     if (nav_pub_.getNumSubscribers() == 0) return;
-    nav_pub_.publish(toMsg(data_, synced_time_stamp_));
+    nav_pub_.publish(toMsg(grid, stamp));
   }
 
-  void publishOcc()
+  void publishOcc(const nav_grid::NavGrid<NumericType>& grid, const ros::Time& stamp)
   {
     if (occ_pub_.getNumSubscribers() == 0) return;
-    occ_pub_.publish(toOccupancyGrid(synced_time_stamp_));
+    occ_pub_.publish(toOccupancyGrid(grid, stamp));
   }
 
-  void publishNavUpdate(const nav_core2::UIntBounds& bounds)
+  void publishNavUpdate(const nav_grid::NavGrid<NumericType>& grid, const nav_core2::UIntBounds& bounds,
+                        const ros::Time& stamp)
   {
     if (nav_update_pub_.getNumSubscribers() == 0) return;
-    nav_update_pub_.publish(nav_grid_pub_sub::toUpdate(data_, bounds, synced_time_stamp_));
+    nav_update_pub_.publish(nav_grid_pub_sub::toUpdate(grid, bounds, stamp));
   }
 
-  void publishOccUpdate(const nav_core2::UIntBounds& bounds)
+  void publishOccUpdate(const nav_grid::NavGrid<NumericType>& grid, const nav_core2::UIntBounds& bounds,
+                        const ros::Time& stamp)
   {
     if (occ_update_pub_.getNumSubscribers() == 0) return;
-    occ_update_pub_.publish(toOccupancyGridUpdate(bounds, synced_time_stamp_));
+    occ_update_pub_.publish(toOccupancyGridUpdate(grid, bounds, stamp));
   }
 
   // Data
@@ -317,12 +793,29 @@ protected:
   ros::Time last_full_publish_, last_update_publish_, synced_time_stamp_;
 
   // Track Update Bounds
-  nav_core2::UIntBounds update_bounds_;
+  DisjointBounds update_bounds_;
 
   // Publishers
   ros::Publisher nav_pub_, nav_update_pub_,
                  occ_pub_, occ_update_pub_,
                  update_area_pub_;
+  std::string nav_grid_topic_, occupancy_grid_topic_;
+
+  // Downsampled Publishing
+  std::vector<DownsampledOutput> downsampled_outputs_;
+
+  // Asynchronous Publishing
+  bool async_ { false };
+  boost::thread async_thread_;
+  boost::mutex async_mutex_;
+  boost::condition_variable async_condition_;
+  std::deque<AsyncJob> async_queue_;
+  nav_grid::VectorNavGrid<NumericType> async_grid_;  // Only accessed by the background thread
+  nav_grid::VectorNavGrid<NumericType> spare_grid_;
+
+  // Shared Memory
+  std::shared_ptr<SharedNavGrid<NumericType>> shared_grid_;
+  ros::Publisher shared_update_pub_;
 };
 
 /**
@@ -338,21 +831,53 @@ public:
   using GenericGridPublisher<unsigned char, nav_2d_msgs::NavGridOfChars, nav_2d_msgs::NavGridOfCharsUpdate>
         ::GenericGridPublisher;
 
+  ~NavGridPublisher()
+  {
+    stopAsyncThread();
+  }
+
   void setCostInterpretation(const std::vector<unsigned char>& cost_interpretation_table)
   {
     cost_interpretation_table_ = cost_interpretation_table;
+    for (DownsampledOutput& output : downsampled_outputs_)
+    {
+      std::shared_ptr<NavGridPublisher> publisher = std::dynamic_pointer_cast<NavGridPublisher>(output.publisher);
+      if (publisher) publisher->setCostInterpretation(cost_interpretation_table);
+    }
   }
 protected:
-  nav_msgs::OccupancyGrid toOccupancyGrid(const ros::Time& timestamp) override
+  nav_msgs::OccupancyGrid toOccupancyGrid(const nav_grid::NavGrid<unsigned char>& grid,
+                                          const ros::Time& timestamp) override
   {
-    return nav_grid_pub_sub::toOccupancyGrid(data_, timestamp, cost_interpretation_table_);
+    return nav_grid_pub_sub::toOccupancyGrid(grid, timestamp, cost_interpretation_table_);
   }
 
-  map_msgs::OccupancyGridUpdate toOccupancyGridUpdate(const nav_core2::UIntBounds& bounds,
+  map_msgs::OccupancyGridUpdate toOccupancyGridUpdate(const nav_grid::NavGrid<unsigned char>& grid,
+                                                      const nav_core2::UIntBounds& bounds,
                                                       const ros::Time& timestamp) override
   {
-    return nav_grid_pub_sub::toOccupancyGridUpdate(data_, bounds, timestamp, cost_interpretation_table_);
+    return nav_grid_pub_sub::toOccupancyGridUpdate(grid, bounds, timestamp, cost_interpretation_table_);
+  }
+
+  std::shared_ptr<GenericGridPublisher> createDownsampledPublisher(nav_grid::NavGrid<unsigned char>& grid) override
+  {
+    std::shared_ptr<NavGridPublisher> publisher = std::make_shared<NavGridPublisher>(grid);
+    publisher->setCostInterpretation(cost_interpretation_table_);
+    return publisher;
+  }
+
+  /**
+   * @brief When downsampling, NO_INFORMATION is only used if all of the values are NO_INFORMATION
+   *
+   * Otherwise a single unknown cell would hide a LETHAL_OBSTACLE in the same downsampled cell.
+   */
+  unsigned char poolValues(const unsigned char a, const unsigned char b) const override
+  {
+    if (a == nav_core2::Costmap::NO_INFORMATION) return b;
+    if (b == nav_core2::Costmap::NO_INFORMATION) return a;
+    return std::max(a, b);
   }
+
   std::vector<unsigned char> cost_interpretation_table_ { OCC_GRID_PUBLISHING };
 };
 
@@ -368,23 +893,69 @@ public:
   using GenericGridPublisher<NumericType, nav_2d_msgs::NavGridOfDoubles, nav_2d_msgs::NavGridOfDoublesUpdate>
         ::GenericGridPublisher;
 
-  void setIgnoreValue(NumericType ignore_value) { ignore_value_ = ignore_value; }
+  ~ScaleGridPublisher()
+  {
+    this->stopAsyncThread();
+  }
+
+  void setIgnoreValue(NumericType ignore_value)
+  {
+    ignore_value_ = ignore_value;
+    for (typename ScaleGridPublisher::DownsampledOutput& output : this->downsampled_outputs_)
+    {
+      std::shared_ptr<ScaleGridPublisher> publisher = std::dynamic_pointer_cast<ScaleGridPublisher>(output.publisher);
+      if (publisher) publisher->setIgnoreValue(ignore_value);
+    }
+  }
+
+  NumericType getIgnoreValue() const { return ignore_value_; }
 
 protected:
-  nav_msgs::OccupancyGrid toOccupancyGrid(const ros::Time& timestamp) override
+  nav_msgs::OccupancyGrid toOccupancyGrid(const nav_grid::NavGrid<NumericType>& grid,
+                                          const ros::Time& timestamp) override
   {
-    nav_grid_pub_sub::getExtremeValues(this->data_, ignore_value_, min_val_, max_val_);
-    return nav_grid_pub_sub::toOccupancyGrid(this->data_, min_val_, max_val_, ignore_value_, timestamp);
+    // Called from the background thread in asynchronous mode, and from the new subscription callbacks
+    boost::mutex::scoped_lock lock(extremes_mutex_);
+    return nav_grid_pub_sub::toOccupancyGridWithExtremes(grid, ignore_value_, min_val_, max_val_, timestamp);
   }
 
-  map_msgs::OccupancyGridUpdate toOccupancyGridUpdate(const nav_core2::UIntBounds& bounds,
+  /**
+   * @brief Updates are scaled using the extremes from the last full grid, expanded to include any values in the update
+   *
+   * This avoids rescanning the whole grid for every update. Note that if the range is expanded, the values in the
+   * update will be scaled differently than the previously published values until the next full grid is published.
+   */
+  map_msgs::OccupancyGridUpdate toOccupancyGridUpdate(const nav_grid::NavGrid<NumericType>& grid,
+                                                      const nav_core2::UIntBounds& bounds,
                                                       const ros::Time& timestamp) override
   {
-    return nav_grid_pub_sub::toOccupancyGridUpdate(this->data_, bounds, min_val_, max_val_, ignore_value_, timestamp);
+    boost::mutex::scoped_lock lock(extremes_mutex_);
+    nav_grid_pub_sub::updateExtremeValues(grid, bounds, ignore_value_, min_val_, max_val_);
+    return nav_grid_pub_sub::toOccupancyGridUpdate(grid, bounds, min_val_, max_val_, ignore_value_, timestamp);
+  }
+
+  std::shared_ptr<typename ScaleGridPublisher::GenericGridPublisher>
+  createDownsampledPublisher(nav_grid::NavGrid<NumericType>& grid) override
+  {
+    std::shared_ptr<ScaleGridPublisher> publisher = std::make_shared<ScaleGridPublisher>(grid);
+    publisher->setIgnoreValue(ignore_value_);
+    return publisher;
+  }
+
+  /**
+   * @brief When downsampling, the ignore value is only used if all of the values are the ignore value
+   */
+  NumericType poolValues(const NumericType a, const NumericType b) const override
+  {
+    if (a == ignore_value_) return b;
+    if (b == ignore_value_) return a;
+    return std::max(a, b);
   }
 
   NumericType ignore_value_ { std::numeric_limits<NumericType>::max() };
-  NumericType min_val_, max_val_;
+  NumericType min_val_ { std::numeric_limits<NumericType>::max() };
+  NumericType max_val_ { std::numeric_limits<NumericType>::lowest() };
+  boost::mutex extremes_mutex_;  // Guards min_val_ and max_val_
 };
 
 
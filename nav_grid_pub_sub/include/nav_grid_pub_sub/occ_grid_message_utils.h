@@ -40,8 +40,10 @@
 #include <nav_msgs/OccupancyGrid.h>
 #include <map_msgs/OccupancyGridUpdate.h>
 #include <nav_core2/bounds.h>
+#include <nav_grid/vector_nav_grid.h>
 #include <nav_grid_iterators/whole_grid.h>
 #include <nav_grid_iterators/sub_grid.h>
+#include <stdint.h>
 #include <algorithm>
 #include <limits>
 #include <vector>
@@ -99,6 +101,21 @@ inline map_msgs::OccupancyGridUpdate toOccupancyGridUpdate(const nav_grid::NavGr
 
 
 
+/**
+ * @brief Scale all of the contiguous values into the OccupancyGrid data
+ * @param scale The result of getScaleFactor(min_value, max_value)
+ */
+template<typename NumericType>
+inline void interpretValues(const NumericType* values, const unsigned int size, const NumericType min_value,
+                            const double scale, const NumericType unknown_value, std::vector<int8_t>& data)
+{
+  data.resize(size);
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    data[i] = interpretScaledValue(values[i], min_value, scale, unknown_value);
+  }
+}
+
 /**
  * @brief generic NavGrid to OccupancyGrid using scaling. Min and max explicitly provided.
  *
@@ -115,22 +132,61 @@ nav_msgs::OccupancyGrid toOccupancyGrid(const nav_grid::NavGrid<NumericType>& gr
   ogrid.header.frame_id = info.frame_id;
   ogrid.header.stamp = stamp;
   ogrid.info = nav_2d_utils::infoToInfo(info);
-  ogrid.data.resize(info.width * info.height);
+  const unsigned int size = info.width * info.height;
+  const double scale = getScaleFactor(min_value, max_value);
 
-  NumericType denominator = max_value - min_value;
-  if (denominator == 0)
+  const nav_grid::VectorNavGrid<NumericType>* vector_grid =
+    dynamic_cast<const nav_grid::VectorNavGrid<NumericType>*>(&grid);
+  if (vector_grid && vector_grid->size() == size)
   {
-    denominator = 1;
+    interpretValues(vector_grid->data(), size, min_value, scale, unknown_value, ogrid.data);
+    return ogrid;
   }
 
+  ogrid.data.resize(size);
   unsigned int data_index = 0;
   for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(info))
   {
-    ogrid.data[data_index++] = interpretValue(grid(index), min_value, denominator, unknown_value);
+    ogrid.data[data_index++] = interpretScaledValue(grid(index), min_value, scale, unknown_value);
   }
   return ogrid;
 }
 
+/**
+ * @brief Expand the range [min_val, max_val] to include all of the contiguous values, ignoring the unknown_value
+ *
+ * Since there is no virtual function call per cell, the compiler is free to vectorize this loop.
+ */
+template<typename NumericType>
+inline void updateExtremeValues(const NumericType* values, const unsigned int size, const NumericType unknown_value,
+                                NumericType& min_val, NumericType& max_val)
+{
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    const NumericType value = values[i];
+    if (value == unknown_value) continue;
+    max_val = std::max(value, max_val);
+    min_val = std::min(value, min_val);
+  }
+}
+
+/**
+ * @brief Expand the range [min_val, max_val] to include all the values within the bounds, ignoring the unknown_value
+ */
+template<typename NumericType>
+inline void updateExtremeValues(const nav_grid::NavGrid<NumericType>& grid, const nav_core2::UIntBounds& bounds,
+                                const NumericType unknown_value, NumericType& min_val, NumericType& max_val)
+{
+  const nav_grid::NavGridInfo& info = grid.getInfo();
+  for (const nav_grid::Index& index : nav_grid_iterators::SubGrid(&info, bounds))
+  {
+    const NumericType value = grid(index);
+    if (value == unknown_value) continue;
+    max_val = std::max(value, max_val);
+    min_val = std::min(value, min_val);
+  }
+}
+
 /**
  * @brief Retrieve the minimum and maximum values from a grid, ignoring the unknown_value
  */
@@ -138,10 +194,19 @@ template<typename NumericType>
 inline void getExtremeValues(const nav_grid::NavGrid<NumericType>& grid, const NumericType unknown_value,
                              NumericType& min_val, NumericType& max_val)
 {
-  max_val = std::numeric_limits<NumericType>::min();
+  max_val = std::numeric_limits<NumericType>::lowest();
   min_val = std::numeric_limits<NumericType>::max();
 
-  for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(grid.getInfo()))
+  const nav_grid::VectorNavGrid<NumericType>* vector_grid =
+    dynamic_cast<const nav_grid::VectorNavGrid<NumericType>*>(&grid);
+  if (vector_grid)
+  {
+    updateExtremeValues(vector_grid->data(), vector_grid->size(), unknown_value, min_val, max_val);
+    return;
+  }
+
+  const nav_grid::NavGridInfo& info = grid.getInfo();
+  for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(info))
   {
     const NumericType& value = grid(index);
     if (value == unknown_value) continue;
@@ -150,6 +215,53 @@ inline void getExtremeValues(const nav_grid::NavGrid<NumericType>& grid, const N
   }
 }
 
+/**
+ * @brief generic NavGrid to OccupancyGrid using scaling. Min and max are determined from the grid and returned.
+ *
+ * The extremes have to be known before anything can be scaled, so this takes one pass to find the min/max and one
+ * pass to scale, both over contiguous memory: the storage of a VectorNavGrid, or otherwise a buffer that is filled
+ * (while finding the min/max) with the only read of the grid through its virtual accessors. The scale factor is
+ * calculated once, so scaling each value is a subtraction and a multiplication.
+ */
+template<typename NumericType>
+nav_msgs::OccupancyGrid toOccupancyGridWithExtremes(const nav_grid::NavGrid<NumericType>& grid,
+                                                    const NumericType unknown_value,
+                                                    NumericType& min_val, NumericType& max_val,
+                                                    const ros::Time& stamp = ros::Time(0))
+{
+  nav_msgs::OccupancyGrid ogrid;
+  const nav_grid::NavGridInfo& info = grid.getInfo();
+  ogrid.header.frame_id = info.frame_id;
+  ogrid.header.stamp = stamp;
+  ogrid.info = nav_2d_utils::infoToInfo(info);
+  const unsigned int size = info.width * info.height;
+
+  max_val = std::numeric_limits<NumericType>::lowest();
+  min_val = std::numeric_limits<NumericType>::max();
+
+  const nav_grid::VectorNavGrid<NumericType>* vector_grid =
+    dynamic_cast<const nav_grid::VectorNavGrid<NumericType>*>(&grid);
+  if (vector_grid && vector_grid->size() == size)
+  {
+    updateExtremeValues(vector_grid->data(), size, unknown_value, min_val, max_val);
+    interpretValues(vector_grid->data(), size, min_val, getScaleFactor(min_val, max_val), unknown_value, ogrid.data);
+    return ogrid;
+  }
+
+  std::vector<NumericType> values;
+  values.reserve(size);
+  for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(info))
+  {
+    const NumericType value = grid(index);
+    values.push_back(value);
+    if (value == unknown_value) continue;
+    max_val = std::max(value, max_val);
+    min_val = std::min(value, min_val);
+  }
+  interpretValues(values.data(), size, min_val, getScaleFactor(min_val, max_val), unknown_value, ogrid.data);
+  return ogrid;
+}
+
 /**
  * @brief generic NavGrid to OccupancyGrid using scaling. Min and max not provided, so they are determined first.
  *
@@ -161,8 +273,7 @@ nav_msgs::OccupancyGrid toOccupancyGrid(const nav_grid::NavGrid<NumericType>& gr
                                         const ros::Time& stamp = ros::Time(0))
 {
   NumericType min_val, max_val;
-  getExtremeValues(grid, unknown_value, min_val, max_val);
-  return toOccupancyGrid(grid, min_val, max_val, unknown_value, stamp);
+  return toOccupancyGridWithExtremes(grid, unknown_value, min_val, max_val, stamp);
 }
 
 /**
@@ -186,16 +297,12 @@ map_msgs::OccupancyGridUpdate toOccupancyGridUpdate(const nav_grid::NavGrid<Nume
   update.width = bounds.getWidth();
   update.height = bounds.getHeight();
   update.data.resize(update.width * update.height);
-  NumericType denominator = max_value - min_value;
-  if (denominator == 0)
-  {
-    denominator = 1;
-  }
+  const double scale = getScaleFactor(min_value, max_value);
 
   unsigned int data_index = 0;
   for (const nav_grid::Index& index : nav_grid_iterators::SubGrid(&info, bounds))
   {
-    update.data[data_index++] = interpretValue(grid(index), min_value, denominator, unknown_value);
+    update.data[data_index++] = interpretScaledValue(grid(index), min_value, scale, unknown_value);
   }
   return update;
 }
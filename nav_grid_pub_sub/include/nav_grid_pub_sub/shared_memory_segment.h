@@ -0,0 +1,111 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAV_GRID_PUB_SUB_SHARED_MEMORY_SEGMENT_H
+#define NAV_GRID_PUB_SUB_SHARED_MEMORY_SEGMENT_H
+
+#include <string>
+
+namespace nav_grid_pub_sub
+{
+/**
+ * @class SharedMemorySegment
+ * @brief Thin wrapper around a POSIX shared memory segment (shm_open + mmap)
+ *
+ * The segment is either created by a writer (mapped read/write, removed when the writer is destroyed)
+ * or opened by a reader (mapped read-only). Segments only ever grow, so a reader's existing mapping remains
+ * valid when the writer makes the segment bigger; the reader just needs to call remap to see the new portion.
+ *
+ * All failures are reported with std::runtime_error.
+ */
+class SharedMemorySegment
+{
+public:
+  SharedMemorySegment() = default;
+  ~SharedMemorySegment();
+  SharedMemorySegment(const SharedMemorySegment&) = delete;
+  SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+  /**
+   * @brief Create (or take over) the named segment with read/write access
+   *
+   * If the segment already exists and is larger than size, it keeps its size, since readers may still have it mapped.
+   *
+   * @param name Name of the segment. A leading slash is added if not present.
+   * @param size Initial size in bytes
+   */
+  void create(const std::string& name, size_t size);
+
+  /**
+   * @brief Open an existing segment with read-only access
+   * @param name Name of the segment. A leading slash is added if not present.
+   */
+  void open(const std::string& name);
+
+  /**
+   * @brief Close the segment (and remove it, if this is the writer)
+   */
+  void close();
+
+  /**
+   * @brief Grow the segment to at least the given size (writer only). Never shrinks.
+   */
+  void grow(size_t size);
+
+  /**
+   * @brief Update the mapping if the writer has grown the segment (reader only)
+   * @return True if the mapping changed
+   */
+  bool remap();
+
+  bool isOpen() const { return data_ != nullptr; }
+  bool isWriter() const { return writer_; }
+  const std::string& getName() const { return name_; }
+  size_t size() const { return size_; }
+  void* getData() { return data_; }
+  const void* getData() const { return data_; }
+
+protected:
+  void map(size_t size);
+  void unmap();
+
+  std::string name_;
+  int fd_ { -1 };
+  void* data_ { nullptr };
+  size_t size_ { 0 };
+  bool writer_ { false };
+};
+}  // namespace nav_grid_pub_sub
+
+#endif  // NAV_GRID_PUB_SUB_SHARED_MEMORY_SEGMENT_H
@@ -0,0 +1,315 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAV_GRID_PUB_SUB_SHARED_NAV_GRID_H
+#define NAV_GRID_PUB_SUB_SHARED_NAV_GRID_H
+
+#include <nav_grid/nav_grid.h>
+#include <nav_grid_pub_sub/shared_memory_segment.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nav_grid_pub_sub
+{
+/**
+ * @brief Layout of the beginning of the shared memory segment used by SharedNavGrid. The grid data follows.
+ */
+struct SharedNavGridHeader
+{
+  std::atomic<uint32_t> sequence;  ///< Incremented before and after each modification, i.e. odd while modifying
+  uint32_t width;
+  uint32_t height;
+  double resolution;
+  double origin_x;
+  double origin_y;
+  char frame_id[256];
+};
+
+/**
+ * @class SharedNavGrid
+ * @brief A NavGrid whose data lives in a POSIX shared memory segment, so that other processes can read it directly
+ *
+ * One process creates the segment (the writer) and may change the grid, and any number of processes can open
+ * the segment (readers) and read the grid without any copying or serialization. Readers cannot change the grid.
+ *
+ * Consistency is maintained with a sequence lock. The writer's setValue calls should be wrapped in
+ * beginWrite/endWrite (setInfo and reset do this automatically). Readers can either read the values directly,
+ * in which case they may see a partially completed update, or do their reading inside readConsistent, which
+ * retries until it runs without the writer changing anything (or gives up, if the writer died mid-write).
+ *
+ * Readers need to call sync to pick up changes to the NavGridInfo.
+ */
+template <typename T> class SharedNavGrid : public nav_grid::NavGrid<T>
+{
+public:
+  using nav_grid::NavGrid<T>::NavGrid;
+
+  /**
+   * @brief Create the shared memory segment as the writer
+   */
+  void create(const std::string& segment_name)
+  {
+    segment_.create(segment_name, getDataOffset());
+    getHeader()->sequence.store(0);
+    write_depth_ = 0;
+    writeHeader();
+  }
+
+  /**
+   * @brief Open an existing shared memory segment as a reader
+   */
+  void open(const std::string& segment_name)
+  {
+    segment_.open(segment_name);
+    sync();
+  }
+
+  bool isOpen() const { return segment_.isOpen(); }
+  const std::string& getSegmentName() const { return segment_.getName(); }
+
+  /**
+   * @brief Get the current value of the sequence lock. Changes every time the grid is modified.
+   */
+  uint32_t getSequence() const
+  {
+    return getHeader()->sequence.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Writer: Mark the start of a modification to the grid. Calls can be nested.
+   */
+  void beginWrite()
+  {
+    requireWriter();
+    if (write_depth_++ > 0) return;
+    std::atomic<uint32_t>& sequence = getHeader()->sequence;
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /**
+   * @brief Writer: Mark the end of a modification to the grid
+   */
+  void endWrite()
+  {
+    requireWriter();
+    if (write_depth_ == 0 || --write_depth_ > 0) return;
+    std::atomic<uint32_t>& sequence = getHeader()->sequence;
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Reader: Run the given function until it completes without the writer modifying the grid
+   *
+   * If the writer is still modifying the grid after the timeout (e.g. because it died in the middle of a
+   * modification), this gives up, and the function may not have run on consistent data.
+   *
+   * @param timeout Maximum number of seconds to keep trying
+   * @return True if the function completed without the writer modifying the grid
+   */
+  template<typename Function>
+  bool readConsistent(Function function, double timeout = 1.0) const
+  {
+    const std::atomic<uint32_t>& sequence = getHeader()->sequence;
+    const std::chrono::steady_clock::time_point deadline = getDeadline(timeout);
+    do
+    {
+      uint32_t before = sequence.load(std::memory_order_acquire);
+      if (before % 2 == 1)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      function();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) == before) return true;
+    }
+    while (std::chrono::steady_clock::now() < deadline);
+    return false;
+  }
+
+  /**
+   * @brief Reader: Update the NavGridInfo (and memory mapping) to match the writer's
+   * @param timeout Maximum number of seconds to wait for the writer to finish modifying the grid
+   * @return True if the info changed
+   */
+  bool sync(double timeout = 1.0)
+  {
+    const std::chrono::steady_clock::time_point deadline = getDeadline(timeout);
+    nav_grid::NavGridInfo info;
+    while (true)
+    {
+      segment_.remap();
+      if (segment_.size() < getDataOffset())
+      {
+        throw std::runtime_error("SharedNavGrid \"" + segment_.getName() + "\" has not been initialized.");
+      }
+      bool consistent = readConsistent([this, &info]() { info = readHeader(); }, timeout);
+      // The writer always grows the segment before changing the header
+      if (consistent && getDataOffset() + sizeof(T) * info.width * info.height <= segment_.size()) break;
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+        throw std::runtime_error("Timed out waiting for the writer of SharedNavGrid \"" + segment_.getName() + "\".");
+      }
+      std::this_thread::yield();
+    }
+    bool changed = info != this->info_;
+    this->info_ = info;
+    return changed;
+  }
+
+  void reset() override
+  {
+    beginWrite();
+    std::fill(getData(), getData() + this->info_.width * this->info_.height, this->default_value_);
+    endWrite();
+  }
+
+  T getValue(const unsigned int x, const unsigned int y) const override
+  {
+    return getData()[y * this->info_.width + x];
+  }
+
+  void setValue(const unsigned int x, const unsigned int y, const T& value) override
+  {
+    requireWriter();
+    getData()[y * this->info_.width + x] = value;
+  }
+
+  using nav_grid::NavGrid<T>::operator();
+  using nav_grid::NavGrid<T>::getValue;
+  using nav_grid::NavGrid<T>::setValue;
+
+  /**
+   * @brief Change the info while keeping the values associated with the grid coordinates (writer only)
+   */
+  void setInfo(const nav_grid::NavGridInfo& new_info) override
+  {
+    requireWriter();
+    beginWrite();
+    std::vector<T> old_data(getData(), getData() + this->info_.width * this->info_.height);
+    segment_.grow(getDataOffset() + sizeof(T) * new_info.width * new_info.height);
+
+    std::fill(getData(), getData() + new_info.width * new_info.height, this->default_value_);
+    unsigned int cols_to_move = std::min(this->info_.width, new_info.width);
+    unsigned int rows_to_move = std::min(this->info_.height, new_info.height);
+    for (unsigned int row = 0; row < rows_to_move; row++)
+    {
+      std::copy(old_data.begin() + row * this->info_.width, old_data.begin() + row * this->info_.width + cols_to_move,
+                getData() + row * new_info.width);
+    }
+    this->info_ = new_info;
+    writeHeader();
+    endWrite();
+  }
+
+protected:
+  static std::chrono::steady_clock::time_point getDeadline(double timeout)
+  {
+    return std::chrono::steady_clock::now() +
+           std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeout));
+  }
+
+  static size_t getDataOffset()
+  {
+    // Keep the grid data cache line aligned
+    return (sizeof(SharedNavGridHeader) + 63) / 64 * 64;
+  }
+
+  SharedNavGridHeader* getHeader()
+  {
+    return static_cast<SharedNavGridHeader*>(segment_.getData());
+  }
+
+  const SharedNavGridHeader* getHeader() const
+  {
+    return static_cast<const SharedNavGridHeader*>(segment_.getData());
+  }
+
+  T* getData()
+  {
+    return reinterpret_cast<T*>(static_cast<char*>(segment_.getData()) + getDataOffset());
+  }
+
+  const T* getData() const
+  {
+    return reinterpret_cast<const T*>(static_cast<const char*>(segment_.getData()) + getDataOffset());
+  }
+
+  void requireWriter() const
+  {
+    if (!segment_.isWriter())
+    {
+      throw std::runtime_error("SharedNavGrid \"" + segment_.getName() + "\" can only be modified by its creator.");
+    }
+  }
+
+  void writeHeader()
+  {
+    SharedNavGridHeader* header = getHeader();
+    header->width = this->info_.width;
+    header->height = this->info_.height;
+    header->resolution = this->info_.resolution;
+    header->origin_x = this->info_.origin_x;
+    header->origin_y = this->info_.origin_y;
+    std::strncpy(header->frame_id, this->info_.frame_id.c_str(), sizeof(header->frame_id) - 1);
+    header->frame_id[sizeof(header->frame_id) - 1] = '\0';
+  }
+
+  nav_grid::NavGridInfo readHeader() const
+  {
+    const SharedNavGridHeader* header = getHeader();
+    nav_grid::NavGridInfo info;
+    info.width = header->width;
+    info.height = header->height;
+    info.resolution = header->resolution;
+    info.origin_x = header->origin_x;
+    info.origin_y = header->origin_y;
+    info.frame_id = std::string(header->frame_id, strnlen(header->frame_id, sizeof(header->frame_id)));
+    return info;
+  }
+
+  SharedMemorySegment segment_;
+  unsigned int write_depth_ { 0 };
+};
+}  // namespace nav_grid_pub_sub
+
+#endif  // NAV_GRID_PUB_SUB_SHARED_NAV_GRID_H
@@ -0,0 +1,83 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAV_GRID_PUB_SUB_SHARED_NAV_GRID_SUBSCRIBER_H
+#define NAV_GRID_PUB_SUB_SHARED_NAV_GRID_SUBSCRIBER_H
+
+#include <ros/ros.h>
+#include <nav_core2/bounds.h>
+#include <nav_2d_msgs/NavGridSharedUpdate.h>
+#include <nav_grid_pub_sub/shared_nav_grid.h>
+#include <functional>
+#include <string>
+
+namespace nav_grid_pub_sub
+{
+/**
+ * @class SharedNavGridSubscriber
+ * @brief Counterpart of NavGridSubscriber for grids published with GenericGridPublisher::initSharedMemory
+ *
+ * Rather than copying the data into a grid owned by the caller, the grid is read in place from shared memory.
+ * The callback is called with the changed bounds whenever a NavGridSharedUpdate is received.
+ */
+class SharedNavGridSubscriber
+{
+public:
+  using NewDataCallback = std::function<void(const nav_core2::UIntBounds&)>;
+
+  void init(ros::NodeHandle& nh, NewDataCallback callback, const std::string& topic = "shared_grid_update");
+  void activate();
+  void deactivate();
+  bool hasData() const { return map_received_; }
+
+  /**
+   * @brief The read-only grid backed by shared memory. Only valid once hasData() is true.
+   */
+  const SharedNavGrid<unsigned char>& getGrid() const { return grid_; }
+
+protected:
+  void incomingUpdate(const nav_2d_msgs::NavGridSharedUpdateConstPtr& update);
+
+  SharedNavGrid<unsigned char> grid_;
+  NewDataCallback callback_;
+
+  ros::Subscriber sub_;
+  bool map_received_ { false };
+
+  ros::NodeHandle nh_;
+  std::string topic_;
+};
+}  // namespace nav_grid_pub_sub
+
+#endif  // NAV_GRID_PUB_SUB_SHARED_NAV_GRID_SUBSCRIBER_H
@@ -0,0 +1,159 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <nav_grid_pub_sub/shared_memory_segment.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace nav_grid_pub_sub
+{
+namespace
+{
+std::string getSystemError(const std::string& message, const std::string& name)
+{
+  return message + " shared memory segment \"" + name + "\": " + std::strerror(errno);
+}
+}  // namespace
+
+SharedMemorySegment::~SharedMemorySegment()
+{
+  close();
+}
+
+void SharedMemorySegment::create(const std::string& name, size_t size)
+{
+  close();
+  name_ = (name.length() > 0 && name[0] == '/') ? name : "/" + name;
+  writer_ = true;
+  fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0)
+  {
+    throw std::runtime_error(getSystemError("Unable to create", name_));
+  }
+
+  // The segment may already exist (e.g. left over from a writer that crashed) and be mapped by readers.
+  // Shrinking it would make those readers crash with SIGBUS, so start from its current size and only grow.
+  struct stat status;
+  if (fstat(fd_, &status) != 0)
+  {
+    throw std::runtime_error(getSystemError("Unable to check size of", name_));
+  }
+  map(static_cast<size_t>(status.st_size));
+  grow(size);
+}
+
+void SharedMemorySegment::open(const std::string& name)
+{
+  close();
+  name_ = (name.length() > 0 && name[0] == '/') ? name : "/" + name;
+  writer_ = false;
+  fd_ = shm_open(name_.c_str(), O_RDONLY, 0);
+  if (fd_ < 0)
+  {
+    throw std::runtime_error(getSystemError("Unable to open", name_));
+  }
+  remap();
+}
+
+void SharedMemorySegment::close()
+{
+  unmap();
+  if (fd_ >= 0)
+  {
+    ::close(fd_);
+    fd_ = -1;
+    if (writer_)
+    {
+      shm_unlink(name_.c_str());
+    }
+  }
+}
+
+void SharedMemorySegment::grow(size_t size)
+{
+  if (!writer_)
+  {
+    throw std::runtime_error("Cannot resize shared memory segment \"" + name_ + "\" without write access.");
+  }
+  if (size <= size_) return;
+  if (ftruncate(fd_, size) != 0)
+  {
+    throw std::runtime_error(getSystemError("Unable to resize", name_));
+  }
+  map(size);
+}
+
+bool SharedMemorySegment::remap()
+{
+  struct stat status;
+  if (fstat(fd_, &status) != 0)
+  {
+    throw std::runtime_error(getSystemError("Unable to check size of", name_));
+  }
+  size_t size = static_cast<size_t>(status.st_size);
+  if (size == size_) return false;
+  map(size);
+  return true;
+}
+
+void SharedMemorySegment::map(size_t size)
+{
+  unmap();
+  if (size == 0) return;
+  int protection = writer_ ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  void* data = mmap(nullptr, size, protection, MAP_SHARED, fd_, 0);
+  if (data == MAP_FAILED)
+  {
+    throw std::runtime_error(getSystemError("Unable to map", name_));
+  }
+  data_ = data;
+  size_ = size;
+}
+
+void SharedMemorySegment::unmap()
+{
+  if (data_)
+  {
+    munmap(data_, size_);
+    data_ = nullptr;
+  }
+  size_ = 0;
+}
+}  // namespace nav_grid_pub_sub
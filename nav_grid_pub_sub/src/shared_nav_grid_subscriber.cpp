@@ -0,0 +1,94 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <nav_grid_pub_sub/shared_nav_grid_subscriber.h>
+#include <nav_2d_utils/conversions.h>
+#include <stdexcept>
+#include <string>
+
+namespace nav_grid_pub_sub
+{
+void SharedNavGridSubscriber::init(ros::NodeHandle& nh, NewDataCallback callback, const std::string& topic)
+{
+  nh_ = nh;
+  callback_ = callback;
+  topic_ = topic;
+  activate();
+}
+
+void SharedNavGridSubscriber::activate()
+{
+  map_received_ = false;
+  sub_ = nh_.subscribe(nh_.resolveName(topic_), 10, &SharedNavGridSubscriber::incomingUpdate, this);
+}
+
+void SharedNavGridSubscriber::deactivate()
+{
+  sub_.shutdown();
+}
+
+void SharedNavGridSubscriber::incomingUpdate(const nav_2d_msgs::NavGridSharedUpdateConstPtr& update)
+{
+  bool full = !map_received_;
+  try
+  {
+    if (!grid_.isOpen() || grid_.getSegmentName() != update->segment)
+    {
+      grid_.open(update->segment);
+      full = true;
+    }
+    else if (grid_.sync())
+    {
+      full = true;
+    }
+  }
+  catch (std::runtime_error& e)
+  {
+    ROS_ERROR_NAMED("SharedNavGridSubscriber", "%s", e.what());
+    return;
+  }
+
+  nav_grid::NavGridInfo info = grid_.getInfo();
+  if (info.width == 0 || info.height == 0) return;
+  map_received_ = true;
+  if (full)
+  {
+    callback_(nav_core2::UIntBounds(0, 0, info.width - 1, info.height - 1));
+  }
+  else
+  {
+    callback_(nav_2d_utils::fromMsg(update->bounds));
+  }
+}
+}  // namespace nav_grid_pub_sub
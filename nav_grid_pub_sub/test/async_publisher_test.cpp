@@ -0,0 +1,153 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <nav_grid/vector_nav_grid.h>
+#include <nav_grid_iterators/whole_grid.h>
+#include <nav_grid_pub_sub/nav_grid_publisher.h>
+#include <nav_grid_pub_sub/nav_grid_subscriber.h>
+#include <functional>
+#include <string>
+
+using nav_grid_pub_sub::NavGridPublisher;
+using nav_grid_pub_sub::NavGridSubscriber;
+
+nav_grid::NavGridInfo makeInfo(unsigned int width, unsigned int height)
+{
+  nav_grid::NavGridInfo info;
+  info.width = width;
+  info.height = height;
+  info.resolution = 0.1;
+  info.frame_id = "map";
+  return info;
+}
+
+bool gridsMatch(const nav_grid::VectorNavGrid<unsigned char>& a, const nav_grid::VectorNavGrid<unsigned char>& b)
+{
+  if (a.getInfo() != b.getInfo()) return false;
+  for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(a.getInfo()))
+  {
+    if (a(index) != b(index)) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Call publish_function and process callbacks until the condition is true or the timeout is reached
+ *
+ * The publish_function is called repeatedly, since the first messages may be sent before the subscriber connects.
+ */
+bool publishUntil(std::function<void()> publish_function, std::function<bool()> condition, double timeout = 5.0)
+{
+  ros::WallTime end = ros::WallTime::now() + ros::WallDuration(timeout);
+  while (ros::ok() && ros::WallTime::now() < end)
+  {
+    publish_function();
+    ros::WallDuration(0.05).sleep();
+    ros::spinOnce();
+    if (condition()) return true;
+  }
+  return false;
+}
+
+TEST(AsyncPublisher, updates)
+{
+  ros::NodeHandle nh("~");
+  nav_grid::VectorNavGrid<unsigned char> source, received;
+  source.setInfo(makeInfo(20, 10));
+
+  NavGridPublisher pub(source);
+  pub.init(nh, "grid", "", "");
+  pub.setAsynchronous(true);
+
+  NavGridSubscriber sub(received);
+  sub.init(nh, [](const nav_core2::UIntBounds&) {}, "grid");
+  ASSERT_TRUE(publishUntil([&]() { pub.publish(); }, [&]() { return gridsMatch(source, received); }));
+
+  // Updates copied on this thread are applied to the background thread's grid and published from it
+  for (unsigned int i = 0; i < 5; i++)
+  {
+    nav_core2::UIntBounds bounds(i * 3, i, i * 3 + 2, i + 4);
+    for (unsigned int y = bounds.getMinY(); y <= bounds.getMaxY(); y++)
+    {
+      for (unsigned int x = bounds.getMinX(); x <= bounds.getMaxX(); x++)
+      {
+        source.setValue(x, y, 10 * i + x + y);
+      }
+    }
+    EXPECT_TRUE(publishUntil([&]() { pub.publish(bounds); }, [&]() { return gridsMatch(source, received); }));
+  }
+
+  // Changing the size of the grid results in the whole grid being sent
+  source.setInfo(makeInfo(15, 15));
+  source.setValue(14, 14, 200);
+  nav_core2::UIntBounds corner(14, 14, 14, 14);
+  EXPECT_TRUE(publishUntil([&]() { pub.publish(corner); }, [&]() { return gridsMatch(source, received); }));
+}
+
+TEST(AsyncPublisher, full_grid_without_subscribers)
+{
+  ros::NodeHandle nh("~");
+  nav_grid::VectorNavGrid<unsigned char> source, received;
+  source.setInfo(makeInfo(10, 10));
+
+  NavGridPublisher pub(source);
+  pub.init(nh, "unwatched_grid", "", "");
+  pub.setAsynchronous(true);
+  pub.publish(nav_core2::UIntBounds());
+
+  // Change the whole grid while no one is subscribed, so the full grid is not copied to the background thread
+  for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(source.getInfo()))
+  {
+    source.setValue(index, 50);
+  }
+  pub.publish();
+
+  NavGridSubscriber sub(received);
+  sub.init(nh, [](const nav_core2::UIntBounds&) {}, "unwatched_grid");
+  ASSERT_TRUE(publishUntil([]() {}, [&]() { return sub.hasData(); }));
+
+  // A full grid that was skipped because no one was listening is resent with the next update
+  received.setValue(0, 0, 0);
+  source.setValue(9, 9, 99);
+  nav_core2::UIntBounds corner(9, 9, 9, 9);
+  EXPECT_TRUE(publishUntil([&]() { pub.publish(corner); }, [&]() { return gridsMatch(source, received); }));
+}
+
+int main(int argc, char **argv)
+{
+  ros::init(argc, argv, "async_publisher_test");
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <nav_grid_pub_sub/disjoint_bounds.h>
+
+using nav_core2::UIntBounds;
+using nav_grid_pub_sub::DisjointBounds;
+
+TEST(DisjointBounds, single_region)
+{
+  DisjointBounds db;
+  EXPECT_TRUE(db.isEmpty());
+  db.add(UIntBounds());
+  EXPECT_TRUE(db.isEmpty());
+
+  db.add(UIntBounds(0, 0, 1, 1));
+  db.add(UIntBounds(98, 98, 99, 99));
+  ASSERT_EQ(1u, db.getRegions().size());
+  const UIntBounds& region = db.getRegions()[0];
+  EXPECT_EQ(0u, region.getMinX());
+  EXPECT_EQ(0u, region.getMinY());
+  EXPECT_EQ(99u, region.getMaxX());
+  EXPECT_EQ(99u, region.getMaxY());
+
+  db.reset();
+  EXPECT_TRUE(db.isEmpty());
+}
+
+TEST(DisjointBounds, opposite_corners)
+{
+  DisjointBounds db(4);
+  db.add(UIntBounds(0, 0, 1, 1));
+  db.add(UIntBounds(98, 98, 99, 99));
+  ASSERT_EQ(2u, db.getRegions().size());
+  EXPECT_EQ(8u, db.getArea());
+
+  UIntBounds total = db.getTotalBounds();
+  EXPECT_EQ(0u, total.getMinX());
+  EXPECT_EQ(99u, total.getMaxY());
+}
+
+TEST(DisjointBounds, overlapping_regions_merge)
+{
+  DisjointBounds db(4, 0);
+  db.add(UIntBounds(0, 10, 20, 12));
+  db.add(UIntBounds(50, 50, 60, 60));
+  ASSERT_EQ(2u, db.getRegions().size());
+
+  // A cross shape overlapping the first region must be merged, even though it grows the area
+  db.add(UIntBounds(10, 0, 12, 20));
+  ASSERT_EQ(2u, db.getRegions().size());
+  for (unsigned int i = 0; i < db.getRegions().size(); i++)
+  {
+    for (unsigned int j = i + 1; j < db.getRegions().size(); j++)
+    {
+      EXPECT_FALSE(db.getRegions()[i].overlaps(db.getRegions()[j]));
+    }
+  }
+}
+
+TEST(DisjointBounds, nearby_regions_merge)
+{
+  DisjointBounds db(4, 10);
+  db.add(UIntBounds(0, 0, 4, 4));
+  db.add(UIntBounds(5, 0, 9, 4));  // adjacent, merged without any extra cells
+  ASSERT_EQ(1u, db.getRegions().size());
+  EXPECT_EQ(50u, db.getArea());
+
+  db.add(UIntBounds(0, 6, 9, 9));  // one row gap costs 10 extra cells
+  ASSERT_EQ(1u, db.getRegions().size());
+  EXPECT_EQ(100u, db.getArea());
+}
+
+TEST(DisjointBounds, max_regions)
+{
+  DisjointBounds db(2, 0);
+  db.add(UIntBounds(0, 0, 0, 0));
+  db.add(UIntBounds(2, 0, 2, 0));
+  db.add(UIntBounds(50, 50, 50, 50));
+  ASSERT_EQ(2u, db.getRegions().size());
+  // The two closest regions get merged
+  EXPECT_EQ(4u, db.getArea());
+
+  db.setMaxRegions(1);
+  ASSERT_EQ(1u, db.getRegions().size());
+  EXPECT_EQ(51u * 51u, db.getArea());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
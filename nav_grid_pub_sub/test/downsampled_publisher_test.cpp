@@ -0,0 +1,163 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <nav_grid/vector_nav_grid.h>
+#include <nav_grid_pub_sub/nav_grid_publisher.h>
+#include <memory>
+
+using nav_core2::Costmap;
+using nav_grid_pub_sub::NavGridPublisher;
+using nav_grid_pub_sub::ScaleGridPublisher;
+
+const unsigned char FREE = Costmap::FREE_SPACE;
+const unsigned char LETHAL = Costmap::LETHAL_OBSTACLE;
+const unsigned char UNKNOWN = Costmap::NO_INFORMATION;
+
+/**
+ * @brief Test class that adds and calculates downsampled outputs without creating any ROS publishers
+ */
+template<typename NumericType, typename PublisherType>
+class DownsamplingPublisher : public PublisherType
+{
+public:
+  using PublisherType::PublisherType;
+
+  void addOutput(unsigned int factor)
+  {
+    typename PublisherType::DownsampledOutput output;
+    output.factor = factor;
+    output.grid = std::make_shared<nav_grid::VectorNavGrid<NumericType>>();
+    output.publisher = this->createDownsampledPublisher(*output.grid);
+    this->downsampled_outputs_.push_back(output);
+  }
+
+  const nav_grid::NavGrid<NumericType>& downsampleAll(unsigned int output_index = 0)
+  {
+    typename PublisherType::DownsampledOutput& output = this->downsampled_outputs_[output_index];
+    nav_grid::NavGridInfo coarse_info = this->data_.getInfo();
+    coarse_info.width = (coarse_info.width + output.factor - 1) / output.factor;
+    coarse_info.height = (coarse_info.height + output.factor - 1) / output.factor;
+    coarse_info.resolution *= output.factor;
+    output.grid->setInfo(coarse_info);
+    this->downsample(output, nav_core2::UIntBounds(0, 0, coarse_info.width - 1, coarse_info.height - 1));
+    return *output.grid;
+  }
+
+  std::shared_ptr<PublisherType> getOutputPublisher(unsigned int output_index = 0)
+  {
+    return std::dynamic_pointer_cast<PublisherType>(this->downsampled_outputs_[output_index].publisher);
+  }
+};
+
+nav_grid::NavGridInfo makeInfo(unsigned int width, unsigned int height)
+{
+  nav_grid::NavGridInfo info;
+  info.width = width;
+  info.height = height;
+  info.resolution = 0.1;
+  return info;
+}
+
+TEST(Downsampling, max_pooling)
+{
+  nav_grid::VectorNavGrid<unsigned char> grid(FREE);
+  grid.setInfo(makeInfo(5, 3));
+  grid.setValue(1, 1, 10);
+  grid.setValue(0, 1, 20);
+  grid.setValue(4, 2, 30);
+
+  DownsamplingPublisher<unsigned char, NavGridPublisher> pub(grid);
+  pub.addOutput(2);
+  const nav_grid::NavGrid<unsigned char>& coarse = pub.downsampleAll();
+  ASSERT_EQ(3u, coarse.getWidth());
+  ASSERT_EQ(2u, coarse.getHeight());
+  EXPECT_DOUBLE_EQ(0.2, coarse.getResolution());
+  EXPECT_EQ(20, coarse(0, 0));
+  EXPECT_EQ(0, coarse(1, 0));
+  EXPECT_EQ(0, coarse(2, 0));
+  EXPECT_EQ(0, coarse(0, 1));
+  EXPECT_EQ(30, coarse(2, 1));
+}
+
+TEST(Downsampling, lethal_beats_unknown)
+{
+  nav_grid::VectorNavGrid<unsigned char> grid(FREE);
+  grid.setInfo(makeInfo(4, 4));
+  // Lethal and unknown in the same coarse cell
+  grid.setValue(0, 0, UNKNOWN);
+  grid.setValue(1, 1, LETHAL);
+  // Free and unknown
+  grid.setValue(2, 0, UNKNOWN);
+  // Entirely unknown
+  grid.setValue(2, 2, UNKNOWN);
+  grid.setValue(3, 2, UNKNOWN);
+  grid.setValue(2, 3, UNKNOWN);
+  grid.setValue(3, 3, UNKNOWN);
+
+  DownsamplingPublisher<unsigned char, NavGridPublisher> pub(grid);
+  pub.addOutput(2);
+  const nav_grid::NavGrid<unsigned char>& coarse = pub.downsampleAll();
+  EXPECT_EQ(LETHAL, coarse(0, 0));
+  EXPECT_EQ(FREE, coarse(1, 0));
+  EXPECT_EQ(FREE, coarse(0, 1));
+  EXPECT_EQ(UNKNOWN, coarse(1, 1));
+}
+
+TEST(Downsampling, ignore_value)
+{
+  nav_grid::VectorNavGrid<float> grid(1.0);
+  grid.setInfo(makeInfo(4, 2));
+  grid.setValue(0, 0, -1.0);
+  grid.setValue(1, 0, -1.0);
+  grid.setValue(0, 1, -1.0);
+  grid.setValue(1, 1, -1.0);
+  grid.setValue(2, 0, -1.0);
+
+  DownsamplingPublisher<float, ScaleGridPublisher<float>> pub(grid);
+  pub.addOutput(2);
+
+  // Changing the ignore value after the output is added applies to the downsampled publisher too
+  pub.setIgnoreValue(-1.0);
+  EXPECT_FLOAT_EQ(-1.0, pub.getOutputPublisher()->getIgnoreValue());
+
+  const nav_grid::NavGrid<float>& coarse = pub.downsampleAll();
+  EXPECT_FLOAT_EQ(-1.0, coarse(0, 0));
+  EXPECT_FLOAT_EQ(1.0, coarse(1, 0));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,193 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <nav_grid/vector_nav_grid.h>
+#include <nav_grid_iterators/whole_grid.h>
+#include <nav_grid_pub_sub/occ_grid_message_utils.h>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+using nav_grid_pub_sub::toOccupancyGrid;
+using nav_grid_pub_sub::toOccupancyGridUpdate;
+
+/**
+ * @brief A NavGrid that is not a VectorNavGrid, to exercise the generic code path
+ */
+template<typename NumericType>
+class WrappedGrid : public nav_grid::NavGrid<NumericType>
+{
+public:
+  explicit WrappedGrid(const nav_grid::VectorNavGrid<NumericType>& grid) : grid_(grid)
+  {
+    this->info_ = grid.getInfo();
+  }
+  void reset() override {}
+  NumericType getValue(const unsigned int x, const unsigned int y) const override { return grid_(x, y); }
+  void setValue(const unsigned int x, const unsigned int y, const NumericType& value) override {}
+  void setInfo(const nav_grid::NavGridInfo& new_info) override {}
+protected:
+  const nav_grid::VectorNavGrid<NumericType>& grid_;
+};
+
+/**
+ * @brief The original conversion, which finds the extremes and then divides for every cell
+ */
+template<typename NumericType>
+std::vector<int8_t> originalConversion(const nav_grid::NavGrid<NumericType>& grid, const NumericType unknown_value)
+{
+  NumericType min_val = std::numeric_limits<NumericType>::max();
+  NumericType max_val = std::numeric_limits<NumericType>::lowest();
+  for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(grid.getInfo()))
+  {
+    if (grid(index) == unknown_value) continue;
+    min_val = std::min(min_val, grid(index));
+    max_val = std::max(max_val, grid(index));
+  }
+  NumericType denominator = max_val - min_val;
+  if (denominator == 0) denominator = 1;
+
+  std::vector<int8_t> data;
+  for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(grid.getInfo()))
+  {
+    data.push_back(nav_grid_pub_sub::interpretValue(grid(index), min_val, denominator, unknown_value));
+  }
+  return data;
+}
+
+template<typename NumericType>
+nav_grid::VectorNavGrid<NumericType> makeRandomGrid(const NumericType unknown_value, const double offset)
+{
+  nav_grid::VectorNavGrid<NumericType> grid;
+  nav_grid::NavGridInfo info;
+  info.width = 173;
+  info.height = 91;
+  grid.setInfo(info);
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+  for (const nav_grid::Index& index : nav_grid_iterators::WholeGrid(info))
+  {
+    double r = distribution(generator);
+    if (r < 0.05)
+      grid.setValue(index, unknown_value);
+    else if (r < 0.5)
+      grid.setValue(index, offset + (index.x % 20) * 0.05);  // Lots of values exactly on percent boundaries
+    else
+      grid.setValue(index, offset + r * 7.3);
+  }
+  return grid;
+}
+
+template<typename NumericType>
+void compareToOriginal(const nav_grid::NavGrid<NumericType>& grid, const NumericType unknown_value)
+{
+  std::vector<int8_t> expected = originalConversion(grid, unknown_value);
+  nav_msgs::OccupancyGrid ogrid = toOccupancyGrid(grid, unknown_value);
+  ASSERT_EQ(expected.size(), ogrid.data.size());
+
+  int8_t min_seen = 100, max_seen = 0;
+  for (unsigned int i = 0; i < expected.size(); i++)
+  {
+    if (expected[i] == -1)
+    {
+      EXPECT_EQ(-1, ogrid.data[i]);
+      continue;
+    }
+    // Multiplying by the scale factor instead of dividing can only differ by rounding across a percent boundary
+    EXPECT_LE(std::abs(expected[i] - ogrid.data[i]), 1) << i;
+    min_seen = std::min(min_seen, ogrid.data[i]);
+    max_seen = std::max(max_seen, ogrid.data[i]);
+  }
+  EXPECT_EQ(0, min_seen);
+  EXPECT_EQ(100, max_seen);
+}
+
+TEST(OccGridMessageUtils, float_matches_original)
+{
+  nav_grid::VectorNavGrid<float> grid = makeRandomGrid<float>(-1.0, 2.5);
+  compareToOriginal<float>(grid, -1.0);
+  compareToOriginal<float>(WrappedGrid<float>(grid), -1.0);
+}
+
+TEST(OccGridMessageUtils, double_matches_original)
+{
+  nav_grid::VectorNavGrid<double> grid = makeRandomGrid<double>(std::numeric_limits<double>::max(), -3.0);
+  compareToOriginal<double>(grid, std::numeric_limits<double>::max());
+  compareToOriginal<double>(WrappedGrid<double>(grid), std::numeric_limits<double>::max());
+}
+
+TEST(OccGridMessageUtils, extremes)
+{
+  nav_grid::VectorNavGrid<float> grid = makeRandomGrid<float>(-1.0, 2.5);
+  float min_val, max_val;
+  nav_msgs::OccupancyGrid ogrid = nav_grid_pub_sub::toOccupancyGridWithExtremes(grid, -1.0f, min_val, max_val);
+  float expected_min, expected_max;
+  nav_grid_pub_sub::getExtremeValues(grid, -1.0f, expected_min, expected_max);
+  EXPECT_FLOAT_EQ(expected_min, min_val);
+  EXPECT_FLOAT_EQ(expected_max, max_val);
+
+  // Updates with the same extremes match the full grid
+  nav_core2::UIntBounds bounds(10, 20, 30, 25);
+  map_msgs::OccupancyGridUpdate update = toOccupancyGridUpdate(grid, bounds, min_val, max_val, -1.0f);
+  unsigned int data_index = 0;
+  for (unsigned int y = bounds.getMinY(); y <= bounds.getMaxY(); y++)
+  {
+    for (unsigned int x = bounds.getMinX(); x <= bounds.getMaxX(); x++)
+    {
+      EXPECT_EQ(ogrid.data[grid.getIndex(x, y)], update.data[data_index++]);
+    }
+  }
+}
+
+TEST(OccGridMessageUtils, uniform_grid)
+{
+  nav_grid::VectorNavGrid<float> grid(3.0);
+  nav_grid::NavGridInfo info;
+  info.width = 4;
+  info.height = 4;
+  grid.setInfo(info);
+  nav_msgs::OccupancyGrid ogrid = toOccupancyGrid(grid, -1.0f);
+  for (int8_t value : ogrid.data)
+  {
+    EXPECT_EQ(0, value);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
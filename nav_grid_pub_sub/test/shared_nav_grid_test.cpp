@@ -0,0 +1,161 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2018, Locus Robotics
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <nav_grid_pub_sub/shared_nav_grid.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <string>
+
+using nav_grid_pub_sub::SharedNavGrid;
+
+std::string getSegmentName()
+{
+  return "shared_nav_grid_test_" + std::to_string(getpid());
+}
+
+nav_grid::NavGridInfo makeInfo(unsigned int width, unsigned int height)
+{
+  nav_grid::NavGridInfo info;
+  info.width = width;
+  info.height = height;
+  info.resolution = 0.05;
+  info.origin_x = -1.0;
+  info.origin_y = 2.0;
+  info.frame_id = "map";
+  return info;
+}
+
+TEST(SharedNavGrid, read_write)
+{
+  SharedNavGrid<unsigned char> writer(7);
+  writer.create(getSegmentName());
+  writer.setInfo(makeInfo(10, 5));
+  EXPECT_EQ(7, writer(9, 4));
+  writer.beginWrite();
+  writer.setValue(3, 2, 100);
+  writer.endWrite();
+
+  SharedNavGrid<unsigned char> reader;
+  reader.open(getSegmentName());
+  EXPECT_EQ(makeInfo(10, 5), reader.getInfo());
+  EXPECT_EQ(100, reader(3, 2));
+  EXPECT_EQ(7, reader(0, 0));
+  EXPECT_THROW(reader.setValue(0, 0, 1), std::runtime_error);
+
+  // Changes to the values are visible immediately
+  writer.setValue(0, 0, 42);
+  EXPECT_EQ(42, reader(0, 0));
+  EXPECT_FALSE(reader.sync());
+}
+
+TEST(SharedNavGrid, resize)
+{
+  SharedNavGrid<float> writer;
+  writer.create(getSegmentName());
+  writer.setInfo(makeInfo(4, 4));
+  writer.setValue(3, 3, 1.5);
+
+  SharedNavGrid<float> reader;
+  reader.open(getSegmentName());
+  uint32_t sequence = reader.getSequence();
+
+  // Grow enough that the segment has to be resized
+  writer.setInfo(makeInfo(1000, 500));
+  writer.setValue(999, 499, 2.5);
+  EXPECT_NE(sequence, reader.getSequence());
+  EXPECT_EQ(0u, reader.getSequence() % 2);
+
+  EXPECT_TRUE(reader.sync());
+  EXPECT_EQ(makeInfo(1000, 500), reader.getInfo());
+  float a, b;
+  reader.readConsistent([&]() { a = reader(3, 3); b = reader(999, 499); });
+  EXPECT_FLOAT_EQ(1.5, a);
+  EXPECT_FLOAT_EQ(2.5, b);
+}
+
+TEST(SharedNavGrid, writer_dies_mid_write)
+{
+  SharedNavGrid<unsigned char> writer;
+  writer.create(getSegmentName());
+  writer.setInfo(makeInfo(10, 10));
+
+  SharedNavGrid<unsigned char> reader;
+  reader.open(getSegmentName());
+
+  // Never finished
+  writer.beginWrite();
+  writer.setValue(1, 1, 5);
+
+  bool called = false;
+  EXPECT_FALSE(reader.readConsistent([&]() { called = true; }, 0.01));
+  EXPECT_FALSE(called);
+  EXPECT_THROW(reader.sync(0.01), std::runtime_error);
+
+  writer.endWrite();
+  EXPECT_TRUE(reader.readConsistent([&]() { called = true; }, 0.01));
+  EXPECT_TRUE(called);
+}
+
+TEST(SharedNavGrid, take_over_segment)
+{
+  SharedNavGrid<unsigned char> old_writer(3);
+  old_writer.create(getSegmentName());
+  old_writer.setInfo(makeInfo(1000, 500));
+
+  SharedNavGrid<unsigned char> reader;
+  reader.open(getSegmentName());
+  EXPECT_EQ(3, reader(999, 499));
+
+  // A new writer that needs less space must not shrink the segment out from under the reader
+  SharedNavGrid<unsigned char> new_writer;
+  new_writer.create(getSegmentName());
+  new_writer.setInfo(makeInfo(4, 4));
+  EXPECT_EQ(3, reader(999, 499));
+
+  EXPECT_TRUE(reader.sync());
+  EXPECT_EQ(makeInfo(4, 4), reader.getInfo());
+}
+
+TEST(SharedNavGrid, missing_segment)
+{
+  SharedNavGrid<unsigned char> reader;
+  EXPECT_THROW(reader.open(getSegmentName() + "_missing"), std::runtime_error);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}